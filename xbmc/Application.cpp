@@ -44,6 +44,8 @@
 #include "video/Bookmark.h"
 #include "video/VideoLibraryQueue.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/GUIFrameProfiler.h"
+#include "guilib/GUIRenderBatch.h"
 #include "utils/LangCodeExpander.h"
 #include "GUIInfoManager.h"
 #include "playlists/PlayListFactory.h"
@@ -66,6 +68,7 @@
 #include "messaging/ThreadMessage.h"
 #include "messaging/ApplicationMessenger.h"
 #include "messaging/helpers/DialogHelper.h"
+#include "ScanJournal.h"
 #include "SectionLoader.h"
 #include "cores/DllLoader/DllLoaderContainer.h"
 #include "GUIUserMessages.h"
@@ -1660,6 +1663,9 @@ bool CApplication::LoadSkin(const std::string& skinID)
 
   CLog::Log(LOGINFO, "  skin loaded...");
 
+  // persist the windows resolved while loading the skin
+  g_SkinInfo->SaveWindowCache();
+
   // leave the graphics lock
   lock.Leave();
 
@@ -1699,6 +1705,9 @@ void CApplication::UnloadSkin(bool forReload /* = false */)
   else if (!m_saveSkinOnUnloading)
     m_saveSkinOnUnloading = true;
 
+  if (g_SkinInfo != nullptr)
+    g_SkinInfo->SaveWindowCache();
+
   g_audioManager.Enable(false);
 
   g_windowManager.DeInitialize();
@@ -1835,6 +1844,8 @@ void CApplication::Render()
   if (m_bStop)
     return;
 
+  GUIPROFILER_ZONE("CApplication::Render");
+
   bool hasRendered = false;
 
   // Whether externalplayer is playing and we're unfocused
@@ -1878,10 +1889,10 @@ void CApplication::Render()
 
   g_Windowing.EndRender();
 
-  // reset our info cache - we do this at the end of Render so that it is
+  // update our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
-  g_infoManager.ResetCache();
+  g_infoManager.UpdateCache(hasRendered);
 
   if (hasRendered)
   {
@@ -1889,6 +1900,8 @@ void CApplication::Render()
   }
 
   g_graphicsContext.Flip(hasRendered, m_pPlayer->IsRenderingVideoLayer());
+  CGUIFrameProfiler::GetInstance().EndFrame();
+  CGUIRenderBatch::GetInstance().EndFrame();
 
   CTimeUtils::UpdateFrameTime(hasRendered);
 }
@@ -2631,6 +2644,8 @@ void CApplication::UnlockFrameMoveGuard()
 
 void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
+  GUIPROFILER_ZONE("CApplication::FrameMove");
+
   MEASURE_FUNCTION;
 
   if (processEvents)
@@ -2702,6 +2717,8 @@ void CApplication::FrameMove(bool processEvents, bool processGUI)
 
     if (!m_bStop)
     {
+      // hand textures decoded in the background over to the GPU before the controls ask for them
+      g_TextureManager.UploadDecodedTextures();
       if (!m_skipGuiRender)
         g_windowManager.Process(CTimeUtils::GetFrameTime());
     }
@@ -2854,6 +2871,8 @@ void CApplication::Stop(int exitCode)
     if (CVideoLibraryQueue::GetInstance().IsRunning())
       CVideoLibraryQueue::GetInstance().CancelAllJobs();
 
+    CScanJournal::GetInstance().Deinitialize();
+
     CApplicationMessenger::GetInstance().Cleanup();
 
     CLog::Log(LOGNOTICE, "stop player");
@@ -66,6 +66,9 @@ void CBackgroundInfoLoader::Run()
         }
       }
 
+      if (!m_bStop)
+        OnCachedItemsLoaded();
+
       // Stage 2: All "slow" stuff that we need to lookup
       for (std::vector<CFileItemPtr>::const_iterator iter = m_vecItems.begin(); iter != m_vecItems.end(); ++iter)
       {
@@ -57,6 +57,7 @@ public:
 
 protected:
   virtual void OnLoaderStart() {};
+  virtual void OnCachedItemsLoaded() {}; ///< called once the "fast" stage has been run over all items
   virtual void OnLoaderFinish() {};
 
   CFileItemList *m_pVecItems;
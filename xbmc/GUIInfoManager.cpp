@@ -41,6 +41,7 @@
 #include "utils/SystemInfo.h"
 #include "guilib/GUITextBox.h"
 #include "guilib/GUIControlGroupList.h"
+#include "guilib/GUIFrameProfiler.h"
 #include "pictures/GUIWindowSlideShow.h"
 #include "pictures/PictureInfoTag.h"
 #include "music/tags/MusicInfoTag.h"
@@ -85,6 +86,7 @@
 #include "storage/MediaManager.h"
 #include "utils/TimeUtils.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 #include "pvr/PVRGUIActions.h"
@@ -106,6 +108,7 @@
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/VideoPlayer/VideoRenderers/BaseRenderer.h"
 #include "interfaces/info/InfoExpression.h"
+#include "interfaces/info/InfoMap.h"
 
 #if defined(TARGET_DARWIN_OSX)
 #include "platform/darwin/osx/smc.h"
@@ -163,7 +166,11 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerShowTime = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
-  m_refreshCounter = 0;
+  for (auto &version : m_domainVersions)
+    version = 0;
+  m_playerActive = false;
+  m_containersMoving = false;
+  m_lastPollTime = 0;
   ResetLibraryBools();
 }
 
@@ -175,6 +182,9 @@ CGUIInfoManager::~CGUIInfoManager(void)
 
 bool CGUIInfoManager::OnMessage(CGUIMessage &message)
 {
+  // messages report changes to any kind of state, e.g. window or focus changes
+  SetDomainsChanged(INFO_DOMAIN_MASK_ALL);
+
   if (message.GetMessage() == GUI_MSG_NOTIFY_ALL)
   {
     if (message.GetParam1() == GUI_MSG_UPDATE_ITEM && message.GetItem())
@@ -201,12 +211,6 @@ int CGUIInfoManager::TranslateString(const std::string &condition)
   return TranslateSingleString(strCondition);
 }
 
-typedef struct
-{
-  const char *str;
-  int  val;
-} infomap;
-
 /// \page modules__General__List_of_gui_access List of GUI access messages
 /// \tableofcontents
 ///
@@ -5198,10 +5202,91 @@ const int picture_slide_map[]  = {/* LISTITEM_PICTURE_RESOLUTION => */ SLIDE_RES
                                   /* LISTITEM_PICTURE_GPS_LON    => */ SLIDE_EXIF_GPS_LONGITUDE,
                                   /* LISTITEM_PICTURE_GPS_ALT    => */ SLIDE_EXIF_GPS_ALTITUDE };
 
-CGUIInfoManager::Property::Property(const std::string &property, const std::string &parameters)
-: name(property)
+// perfect hash indices for the tables above, built once at startup
+static const CInfoMapIndex string_bools_index(string_bools);
+static const CInfoMapIndex integer_bools_index(integer_bools);
+static const CInfoMapIndex player_labels_index(player_labels);
+static const CInfoMapIndex player_param_index(player_param);
+static const CInfoMapIndex player_times_index(player_times);
+static const CInfoMapIndex player_process_index(player_process);
+static const CInfoMapIndex weather_index(weather);
+static const CInfoMapIndex system_labels_index(system_labels);
+static const CInfoMapIndex system_param_index(system_param);
+static const CInfoMapIndex network_labels_index(network_labels);
+static const CInfoMapIndex musicpartymode_index(musicpartymode);
+static const CInfoMapIndex musicplayer_index(musicplayer);
+static const CInfoMapIndex videoplayer_index(videoplayer);
+static const CInfoMapIndex mediacontainer_index(mediacontainer);
+static const CInfoMapIndex container_bools_index(container_bools);
+static const CInfoMapIndex container_ints_index(container_ints);
+static const CInfoMapIndex container_str_index(container_str);
+static const CInfoMapIndex listitem_labels_index(listitem_labels);
+static const CInfoMapIndex visualisation_index(visualisation);
+static const CInfoMapIndex fanart_labels_index(fanart_labels);
+static const CInfoMapIndex skin_labels_index(skin_labels);
+static const CInfoMapIndex window_bools_index(window_bools);
+static const CInfoMapIndex control_labels_index(control_labels);
+static const CInfoMapIndex playlist_index(playlist);
+static const CInfoMapIndex pvr_index(pvr);
+static const CInfoMapIndex adsp_index(adsp);
+static const CInfoMapIndex rds_index(rds);
+static const CInfoMapIndex slideshow_index(slideshow);
+
+// the state domains of the conditions translated from each table. Conditions from
+// tables not listed here depend on the system domain only
+struct InfoMapDomains
+{
+  template<size_t N>
+  InfoMapDomains(const infomap (&table)[N], unsigned int domains) : table(table), size(N), domains(domains) {}
+
+  const infomap *table;
+  size_t size;
+  unsigned int domains;
+};
+
+static const InfoMapDomains infomap_domains[] = {
+  { player_labels,  INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER) },
+  { player_process, INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER) },
+  { musicpartymode, INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER) },
+  { musicplayer,    INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER) },
+  { videoplayer,    INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER) },
+  { visualisation,  INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER) },
+  { playlist,       INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER) },
+  { rds,            INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER) },
+  { mediacontainer, INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_CONTAINER) },
+  { container_bools, INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_CONTAINER) },
+  { container_ints, INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_CONTAINER) },
+  { container_str,  INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_CONTAINER) }
+};
+
+static unsigned int GetInfoDomains(int info)
 {
-  CUtil::SplitParams(parameters, params);
+  static const std::map<int, unsigned int> domains = []()
+  {
+    std::map<int, unsigned int> domains;
+    for (const auto &tableDomains : infomap_domains)
+    {
+      for (size_t i = 0; i < tableDomains.size; i++)
+        domains[tableDomains.table[i].val] |= tableDomains.domains;
+    }
+    return domains;
+  }();
+
+  info = abs(info);
+  // listitem infos are translated to offsets into the listitem range, including properties
+  if (info >= LISTITEM_START && info <= LISTITEM_END)
+    return INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_LISTITEM) | INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_CONTAINER);
+  auto it = domains.find(info);
+  if (it != domains.end())
+    return it->second;
+  return INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_SYSTEM);
+}
+
+CGUIInfoManager::Property::Property(std::string property, const std::string &parameters)
+: name(std::move(property))
+{
+  if (!parameters.empty())
+    CUtil::SplitParams(parameters, params);
 }
 
 const std::string &CGUIInfoManager::Property::param(unsigned int n /* = 0 */) const
@@ -5243,7 +5328,7 @@ void CGUIInfoManager::SplitInfoString(const std::string &infoString, std::vector
       if (!property.empty()) // add our property and parameters
       {
         StringUtils::ToLower(property);
-        info.push_back(Property(property, param));
+        info.push_back(Property(std::move(property), param));
       }
       property.clear();
       param.clear();
@@ -5259,7 +5344,7 @@ void CGUIInfoManager::SplitInfoString(const std::string &infoString, std::vector
   if (!property.empty())
   {
     StringUtils::ToLower(property);
-    info.push_back(Property(property, param));
+    info.push_back(Property(std::move(property), param));
   }
 }
 
@@ -5283,6 +5368,7 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
   StringUtils::Trim(strTest);
 
   std::vector< Property> info;
+  info.reserve(4);
   SplitInfoString(strTest, info);
 
   if (info.empty())
@@ -5307,98 +5393,70 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
       }
       else if (prop.num_params() == 2)
       {
-        for (size_t i = 0; i < sizeof(string_bools) / sizeof(infomap); i++)
+        if (const infomap *entry = string_bools_index.Find(prop.name))
         {
-          if (prop.name == string_bools[i].str)
+          int data1 = TranslateSingleString(prop.param(0), listItemDependent);
+          // pipe our original string through the localize parsing then make it lowercase (picks up $LBRACKET etc.)
+          std::string label = CGUIInfoLabel::GetLabel(prop.param(1));
+          StringUtils::ToLower(label);
+          // 'true', 'false', 'yes', 'no' are valid strings, do not resolve them to SYSTEM_ALWAYS_TRUE or SYSTEM_ALWAYS_FALSE
+          if (label != "true" && label != "false" && label != "yes" && label != "no")
           {
-            int data1 = TranslateSingleString(prop.param(0), listItemDependent);
-            // pipe our original string through the localize parsing then make it lowercase (picks up $LBRACKET etc.)
-            std::string label = CGUIInfoLabel::GetLabel(prop.param(1));
-            StringUtils::ToLower(label);
-            // 'true', 'false', 'yes', 'no' are valid strings, do not resolve them to SYSTEM_ALWAYS_TRUE or SYSTEM_ALWAYS_FALSE
-            if (label != "true" && label != "false" && label != "yes" && label != "no")
-            {
-              int data2 = TranslateSingleString(prop.param(1), listItemDependent);
-              if (data2 > 0)
-                return AddMultiInfo(GUIInfo(string_bools[i].val, data1, -data2));
-            }
-            return AddMultiInfo(GUIInfo(string_bools[i].val, data1, ConditionalStringParameter(label)));
+            int data2 = TranslateSingleString(prop.param(1), listItemDependent);
+            if (data2 > 0)
+              return AddMultiInfo(GUIInfo(entry->val, data1, -data2));
           }
+          return AddMultiInfo(GUIInfo(entry->val, data1, ConditionalStringParameter(label)));
         }
       }
     }
     if (cat.name == "integer")
     {
-      for (size_t i = 0; i < sizeof(integer_bools) / sizeof(infomap); i++)
+      if (const infomap *entry = integer_bools_index.Find(prop.name))
       {
-        if (prop.name == integer_bools[i].str)
-        {
-          int data1 = TranslateSingleString(prop.param(0), listItemDependent);
-          int data2 = atoi(prop.param(1).c_str());
-          return AddMultiInfo(GUIInfo(integer_bools[i].val, data1, data2));
-        }
+        int data1 = TranslateSingleString(prop.param(0), listItemDependent);
+        int data2 = atoi(prop.param(1).c_str());
+        return AddMultiInfo(GUIInfo(entry->val, data1, data2));
       }
     }
     else if (cat.name == "player")
     {
-      for (size_t i = 0; i < sizeof(player_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == player_labels[i].str)
-          return player_labels[i].val;
-      }
-      for (size_t i = 0; i < sizeof(player_times) / sizeof(infomap); i++)
-      {
-        if (prop.name == player_times[i].str)
-          return AddMultiInfo(GUIInfo(player_times[i].val, TranslateTimeFormat(prop.param())));
-      }
+      if (const infomap *entry = player_labels_index.Find(prop.name))
+        return entry->val;
+      if (const infomap *entry = player_times_index.Find(prop.name))
+        return AddMultiInfo(GUIInfo(entry->val, TranslateTimeFormat(prop.param())));
       if (prop.name == "process" && prop.num_params())
       {
-        for (size_t i = 0; i < sizeof(player_process) / sizeof(infomap); i++)
-        {
-          if (StringUtils::EqualsNoCase(prop.param(), player_process[i].str))
-            return player_process[i].val;
-        }
+        std::string process = prop.param();
+        StringUtils::ToLower(process);
+        if (const infomap *entry = player_process_index.Find(process))
+          return entry->val;
       }
       if (prop.num_params() == 1)
       {
-        for (size_t i = 0; i < sizeof(player_param) / sizeof(infomap); i++)
-        {
-          if (prop.name == player_param[i].str)
-            return AddMultiInfo(GUIInfo(player_param[i].val, ConditionalStringParameter(prop.param())));
-        }
+        if (const infomap *entry = player_param_index.Find(prop.name))
+          return AddMultiInfo(GUIInfo(entry->val, ConditionalStringParameter(prop.param())));
       }
     }
     else if (cat.name == "weather")
     {
-      for (size_t i = 0; i < sizeof(weather) / sizeof(infomap); i++)
-      {
-        if (prop.name == weather[i].str)
-          return weather[i].val;
-      }
+      if (const infomap *entry = weather_index.Find(prop.name))
+        return entry->val;
     }
     else if (cat.name == "network")
     {
-      for (size_t i = 0; i < sizeof(network_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == network_labels[i].str)
-          return network_labels[i].val;
-      }
+      if (const infomap *entry = network_labels_index.Find(prop.name))
+        return entry->val;
     }
     else if (cat.name == "musicpartymode")
     {
-      for (size_t i = 0; i < sizeof(musicpartymode) / sizeof(infomap); i++)
-      {
-        if (prop.name == musicpartymode[i].str)
-          return musicpartymode[i].val;
-      }
+      if (const infomap *entry = musicpartymode_index.Find(prop.name))
+        return entry->val;
     }
     else if (cat.name == "system")
     {
-      for (size_t i = 0; i < sizeof(system_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == system_labels[i].str)
-          return system_labels[i].val;
-      }
+      if (const infomap *entry = system_labels_index.Find(prop.name))
+        return entry->val;
       if (prop.num_params() == 1)
       {
         const std::string &param = prop.param();
@@ -5408,11 +5466,8 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
           StringUtils::ToLower(paramCopy);
           return AddMultiInfo(GUIInfo(SYSTEM_GET_BOOL, ConditionalStringParameter(paramCopy, true)));
         }
-        for (size_t i = 0; i < sizeof(system_param) / sizeof(infomap); i++)
-        {
-          if (prop.name == system_param[i].str)
-            return AddMultiInfo(GUIInfo(system_param[i].val, ConditionalStringParameter(param)));
-        }
+        if (const infomap *entry = system_param_index.Find(prop.name))
+          return AddMultiInfo(GUIInfo(entry->val, ConditionalStringParameter(param)));
         if (prop.name == "memory")
         {
           if (param == "free") return SYSTEM_FREE_MEMORY;
@@ -5505,11 +5560,8 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
     }
     else if (cat.name == "musicplayer")
     {
-      for (size_t i = 0; i < sizeof(player_times) / sizeof(infomap); i++) //! @todo remove these, they're repeats
-      {
-        if (prop.name == player_times[i].str)
-          return AddMultiInfo(GUIInfo(player_times[i].val, TranslateTimeFormat(prop.param())));
-      }
+      if (const infomap *entry = player_times_index.Find(prop.name)) //! @todo remove these, they're repeats
+        return AddMultiInfo(GUIInfo(entry->val, TranslateTimeFormat(prop.param())));
       if (prop.name == "content" && prop.num_params())
         return AddMultiInfo(GUIInfo(MUSICPLAYER_CONTENT, ConditionalStringParameter(prop.param()), 0));
       else if (prop.name == "property")
@@ -5523,53 +5575,32 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
     }
     else if (cat.name == "videoplayer")
     {
-      for (size_t i = 0; i < sizeof(player_times) / sizeof(infomap); i++) //! @todo remove these, they're repeats
-      {
-        if (prop.name == player_times[i].str)
-          return AddMultiInfo(GUIInfo(player_times[i].val, TranslateTimeFormat(prop.param())));
-      }
+      if (const infomap *entry = player_times_index.Find(prop.name)) //! @todo remove these, they're repeats
+        return AddMultiInfo(GUIInfo(entry->val, TranslateTimeFormat(prop.param())));
       if (prop.name == "content" && prop.num_params())
       {
         return AddMultiInfo(GUIInfo(VIDEOPLAYER_CONTENT, ConditionalStringParameter(prop.param()), 0));
       }
-      for (size_t i = 0; i < sizeof(videoplayer) / sizeof(infomap); i++)
-      {
-        if (prop.name == videoplayer[i].str)
-          return videoplayer[i].val;
-      }
+      if (const infomap *entry = videoplayer_index.Find(prop.name))
+        return entry->val;
     }
     else if (cat.name == "slideshow")
     {
-      for (size_t i = 0; i < sizeof(slideshow) / sizeof(infomap); i++)
-      {
-        if (prop.name == slideshow[i].str)
-          return slideshow[i].val;
-      }
+      if (const infomap *entry = slideshow_index.Find(prop.name))
+        return entry->val;
       return CPictureInfoTag::TranslateString(prop.name);
     }
     else if (cat.name == "container")
     {
-      for (size_t i = 0; i < sizeof(mediacontainer) / sizeof(infomap); i++) // these ones don't have or need an id
-      {
-        if (prop.name == mediacontainer[i].str)
-          return mediacontainer[i].val;
-      }
+      if (const infomap *entry = mediacontainer_index.Find(prop.name)) // these ones don't have or need an id
+        return entry->val;
       int id = atoi(cat.param().c_str());
-      for (size_t i = 0; i < sizeof(container_bools) / sizeof(infomap); i++) // these ones can have an id (but don't need to?)
-      {
-        if (prop.name == container_bools[i].str)
-          return id ? AddMultiInfo(GUIInfo(container_bools[i].val, id)) : container_bools[i].val;
-      }
-      for (size_t i = 0; i < sizeof(container_ints) / sizeof(infomap); i++) // these ones can have an int param on the property
-      {
-        if (prop.name == container_ints[i].str)
-          return AddMultiInfo(GUIInfo(container_ints[i].val, id, atoi(prop.param().c_str())));
-      }
-      for (size_t i = 0; i < sizeof(container_str) / sizeof(infomap); i++) // these ones have a string param on the property
-      {
-        if (prop.name == container_str[i].str)
-          return AddMultiInfo(GUIInfo(container_str[i].val, id, ConditionalStringParameter(prop.param())));
-      }
+      if (const infomap *entry = container_bools_index.Find(prop.name)) // these ones can have an id (but don't need to?)
+        return id ? AddMultiInfo(GUIInfo(entry->val, id)) : entry->val;
+      if (const infomap *entry = container_ints_index.Find(prop.name)) // these ones can have an int param on the property
+        return AddMultiInfo(GUIInfo(entry->val, id, atoi(prop.param().c_str())));
+      if (const infomap *entry = container_str_index.Find(prop.name)) // these ones have a string param on the property
+        return AddMultiInfo(GUIInfo(entry->val, id, ConditionalStringParameter(prop.param())));
       if (prop.name == "sortdirection")
       {
         SortOrder order = SortOrderNone;
@@ -5602,27 +5633,18 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
     }
     else if (cat.name == "visualisation")
     {
-      for (size_t i = 0; i < sizeof(visualisation) / sizeof(infomap); i++)
-      {
-        if (prop.name == visualisation[i].str)
-          return visualisation[i].val;
-      }
+      if (const infomap *entry = visualisation_index.Find(prop.name))
+        return entry->val;
     }
     else if (cat.name == "fanart")
     {
-      for (size_t i = 0; i < sizeof(fanart_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == fanart_labels[i].str)
-          return fanart_labels[i].val;
-      }
+      if (const infomap *entry = fanart_labels_index.Find(prop.name))
+        return entry->val;
     }
     else if (cat.name == "skin")
     {
-      for (size_t i = 0; i < sizeof(skin_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == skin_labels[i].str)
-          return skin_labels[i].val;
-      }
+      if (const infomap *entry = skin_labels_index.Find(prop.name))
+        return entry->val;
       if (prop.num_params())
       {
         if (prop.name == "string")
@@ -5646,28 +5668,22 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
         if (winID != WINDOW_INVALID)
           return AddMultiInfo(GUIInfo(WINDOW_PROPERTY, winID, ConditionalStringParameter(prop.param())));
       }
-      for (size_t i = 0; i < sizeof(window_bools) / sizeof(infomap); i++)
-      {
-        if (prop.name == window_bools[i].str)
-        { //! @todo The parameter for these should really be on the first not the second property
-          if (prop.param().find("xml") != std::string::npos)
-            return AddMultiInfo(GUIInfo(window_bools[i].val, 0, ConditionalStringParameter(prop.param())));
-          int winID = prop.param().empty() ? WINDOW_INVALID : CWindowTranslator::TranslateWindow(prop.param());
-          return winID != WINDOW_INVALID ? AddMultiInfo(GUIInfo(window_bools[i].val, winID, 0)) : window_bools[i].val;
-        }
+      if (const infomap *entry = window_bools_index.Find(prop.name))
+      { //! @todo The parameter for these should really be on the first not the second property
+        if (prop.param().find("xml") != std::string::npos)
+          return AddMultiInfo(GUIInfo(entry->val, 0, ConditionalStringParameter(prop.param())));
+        int winID = prop.param().empty() ? WINDOW_INVALID : CWindowTranslator::TranslateWindow(prop.param());
+        return winID != WINDOW_INVALID ? AddMultiInfo(GUIInfo(entry->val, winID, 0)) : entry->val;
       }
     }
     else if (cat.name == "control")
     {
-      for (size_t i = 0; i < sizeof(control_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == control_labels[i].str)
-        { //! @todo The parameter for these should really be on the first not the second property
-          int controlID = atoi(prop.param().c_str());
-          if (controlID)
-            return AddMultiInfo(GUIInfo(control_labels[i].val, controlID, 0));
-          return 0;
-        }
+      if (const infomap *entry = control_labels_index.Find(prop.name))
+      { //! @todo The parameter for these should really be on the first not the second property
+        int controlID = atoi(prop.param().c_str());
+        if (controlID)
+          return AddMultiInfo(GUIInfo(entry->val, controlID, 0));
+        return 0;
       }
     }
     else if (cat.name == "controlgroup" && prop.name == "hasfocus")
@@ -5678,15 +5694,8 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
     }
     else if (cat.name == "playlist")
     {
-      int ret = -1;
-      for (size_t i = 0; i < sizeof(playlist) / sizeof(infomap); i++)
-      {
-        if (prop.name == playlist[i].str)
-        {
-          ret = playlist[i].val;
-          break;
-        }
-      }
+      const infomap *entry = playlist_index.Find(prop.name);
+      int ret = entry ? entry->val : -1;
       if (ret >= 0)
       {
         if (prop.num_params() <= 0)
@@ -5706,30 +5715,21 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
     }
     else if (cat.name == "pvr")
     {
-      for (size_t i = 0; i < sizeof(pvr) / sizeof(infomap); i++)
-      {
-        if (prop.name == pvr[i].str)
-          return pvr[i].val;
-      }
+      if (const infomap *entry = pvr_index.Find(prop.name))
+        return entry->val;
     }
     else if (cat.name == "adsp")
     {
-      for (size_t i = 0; i < sizeof(adsp) / sizeof(infomap); i++)
-      {
-        if (prop.name == adsp[i].str)
-          return adsp[i].val;
-      }
+      if (const infomap *entry = adsp_index.Find(prop.name))
+        return entry->val;
     }
     else if (cat.name == "rds")
     {
       if (prop.name == "getline")
         return AddMultiInfo(GUIInfo(RDS_GET_RADIOTEXT_LINE, atoi(prop.param(0).c_str())));
 
-      for (size_t i = 0; i < sizeof(rds) / sizeof(infomap); i++)
-      {
-        if (prop.name == rds[i].str)
-          return rds[i].val;
-      }
+      if (const infomap *entry = rds_index.Find(prop.name))
+        return entry->val;
     }
   }
   else if (info.size() == 3 || info.size() == 4)
@@ -5795,15 +5795,12 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
     else if (info[0].name == "control")
     {
       const Property &prop = info[1];
-      for (size_t i = 0; i < sizeof(control_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == control_labels[i].str)
-        { //! @todo The parameter for these should really be on the first not the second property
-          int controlID = atoi(prop.param().c_str());
-          if (controlID)
-            return AddMultiInfo(GUIInfo(control_labels[i].val, controlID, atoi(info[2].param(0).c_str())));
-          return 0;
-        }
+      if (const infomap *entry = control_labels_index.Find(prop.name))
+      { //! @todo The parameter for these should really be on the first not the second property
+        int controlID = atoi(prop.param().c_str());
+        if (controlID)
+          return AddMultiInfo(GUIInfo(entry->val, controlID, atoi(info[2].param(0).c_str())));
+        return 0;
       }
     }
   }
@@ -5832,21 +5829,15 @@ int CGUIInfoManager::TranslateListItem(const Property &info)
       return AddListItemProp(info.param(), LISTITEM_RATING_AND_VOTES_OFFSET);
   }
 
-  for (size_t i = 0; i < sizeof(listitem_labels) / sizeof(infomap); i++) // these ones don't have or need an id
-  {
-    if (info.name == listitem_labels[i].str)
-      return listitem_labels[i].val;
-  }
+  if (const infomap *entry = listitem_labels_index.Find(info.name)) // these ones don't have or need an id
+    return entry->val;
   return 0;
 }
 
 int CGUIInfoManager::TranslateMusicPlayerString(const std::string &info) const
 {
-  for (size_t i = 0; i < sizeof(musicplayer) / sizeof(infomap); i++)
-  {
-    if (info == musicplayer[i].str)
-      return musicplayer[i].val;
-  }
+  if (const infomap *entry = musicplayer_index.Find(info))
+    return entry->val;
   return 0;
 }
 
@@ -6869,9 +6860,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_domainVersions));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_domainVersions));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -7414,9 +7405,30 @@ bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListI
   return bReturn;
 }
 
+unsigned int CGUIInfoManager::GetConditionDomains(int condition) const
+{
+  condition = abs(condition);
+
+  if (condition == SYSTEM_ALWAYS_TRUE || condition == SYSTEM_ALWAYS_FALSE)
+    return 0;
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    // the info may refer to another container, window or control, or compare against another info.
+    // Parameters that are plain ids may add a domain too many, which only costs an evaluation
+    const GUIInfo &info = m_multiInfo[condition - MULTI_INFO_START];
+    unsigned int domains = INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_SYSTEM) | GetInfoDomains(info.m_info) |
+                           GetInfoDomains(static_cast<int>(info.GetData1()));
+    if (info.GetData2() < 0)
+      domains |= GetInfoDomains(-info.GetData2());
+    return domains;
+  }
+  return GetInfoDomains(condition);
+}
+
 /// \brief Examines the multi information sent and returns true or false accordingly.
 bool CGUIInfoManager::GetMultiInfoBool(const GUIInfo &info, int contextWindow, const CGUIListItem *item)
 {
+  GUIPROFILER_ZONE("CGUIInfoManager::GetMultiInfoBool");
   bool bReturn = false;
   int condition = abs(info.m_info);
 
@@ -9437,6 +9449,7 @@ void CGUIInfoManager::UpdateFPS()
 
 void CGUIInfoManager::UpdateAVInfo()
 {
+  GUIPROFILER_ZONE("CGUIInfoManager::UpdateAVInfo");
   if (g_application.m_pPlayer->IsPlaying())
   {
     if (CServiceBroker::GetDataCacheCore().HasAVInfoChanges())
@@ -10792,9 +10805,50 @@ void CGUIInfoManager::ResetCache()
 {
   // reset any animation triggers as well
   m_containerMoves.clear();
-  // mark our infobools as dirty
+  SetDomainsChanged(INFO_DOMAIN_MASK_ALL);
+}
+
+void CGUIInfoManager::UpdateCache(bool guiChanged)
+{
+  GUIPROFILER_ZONE("CGUIInfoManager::UpdateCache");
+  unsigned int domains = 0;
+
+  // player state can only change while something is playing, or on the frame
+  // playback starts or stops
   CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  bool playerActive = g_application.m_pPlayer->IsPlaying();
+  if (playerActive || m_playerActive)
+    domains |= INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_PLAYER);
+  m_playerActive = playerActive;
+
+  // the animation triggers are set during the frame and reset after it
+  bool containersMoving = !m_containerMoves.empty();
+  if (containersMoving || m_containersMoving)
+    domains |= INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_CONTAINER) | INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_LISTITEM);
+  m_containersMoving = containersMoving;
+  m_containerMoves.clear();
+
+  if (guiChanged)
+    domains |= INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_SYSTEM) | INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_CONTAINER) |
+               INFO_DOMAIN_MASK(INFO::INFO_DOMAIN_LISTITEM);
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (now - m_lastPollTime >= 500)
+  {
+    domains = INFO_DOMAIN_MASK_ALL;
+    m_lastPollTime = now;
+  }
+
+  SetDomainsChanged(domains);
+}
+
+void CGUIInfoManager::SetDomainsChanged(unsigned int domains)
+{
+  for (unsigned int domain = 0; domain < INFO::INFO_DOMAIN_MAX; domain++)
+  {
+    if (domains & INFO_DOMAIN_MASK(domain))
+      m_domainVersions[domain].fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 std::string CGUIInfoManager::GetPictureLabel(int info)
@@ -203,7 +203,22 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Invalidate all cached conditions, e.g. after the skin or profile changed
+   */
   void ResetCache();
+
+  /*! \brief Invalidate the cached conditions depending on state that changed since the last frame
+   Called once per frame after rendering. The player domain is invalidated while something plays,
+   containers and list items while a container moves, and everything but the player when the gui
+   rendered anything. All domains are polled at a low rate for state without change notification.
+   \param guiChanged true if the gui rendered any dirty region this frame
+   */
+  void UpdateCache(bool guiChanged);
+
+  /*! \brief Invalidate the cached conditions depending on the given domains. Thread safe.
+   \param domains mask of INFO_DOMAIN_MASK() bits
+   */
+  void SetDomainsChanged(unsigned int domains);
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -238,6 +253,12 @@ protected:
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item=NULL);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Get the mask of INFO::InfoDomains a translated condition depends on
+   \param condition the condition as returned by TranslateSingleString
+   \return mask of INFO_DOMAIN_MASK() bits, 0 for constant conditions
+   */
+  unsigned int GetConditionDomains(int condition) const;
+
   // routines for window retrieval
   bool CheckWindowCondition(CGUIWindow *window, int condition) const;
   CGUIWindow *GetWindowWithCondition(int contextWindow, int condition) const;
@@ -247,7 +268,7 @@ protected:
   class Property
   {
   public:
-    Property(const std::string &property, const std::string &parameters);
+    Property(std::string property, const std::string &parameters);
 
     const std::string &param(unsigned int n = 0) const;
     unsigned int num_params() const;
@@ -329,7 +350,10 @@ protected:
 
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
-  unsigned int m_refreshCounter;
+  std::atomic<unsigned int> m_domainVersions[INFO::INFO_DOMAIN_MAX];
+  bool m_playerActive;
+  bool m_containersMoving;
+  unsigned int m_lastPollTime;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   int m_libraryHasMusic;
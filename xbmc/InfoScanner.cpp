@@ -27,7 +27,7 @@
 
 CInfoScanner::~CInfoScanner() = default;
 
-bool CInfoScanner::HasNoMedia(const std::string &strDirectory) const
+bool CInfoScanner::HasNoMedia(const std::string &strDirectory)
 {
   std::string noMediaFile = URIUtils::AddFileToFolder(strDirectory, ".nomedia");
   return XFILE::CFile::Exists(noMediaFile);
@@ -0,0 +1,234 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ScanJournal.h"
+
+#ifdef HAVE_INOTIFY
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#endif
+
+#include "filesystem/SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+#ifdef HAVE_INOTIFY
+// anything that can change the listing or hash of a directory
+#define JOURNAL_EVENTS (IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF)
+
+namespace
+{
+// inotify only reports changes made through the local kernel, so changes made by other
+// hosts to network or fuse mounts would go unnoticed
+bool IsLocalFilesystem(const std::string &path)
+{
+  struct statfs buffer;
+  if (statfs(path.c_str(), &buffer) != 0)
+    return false;
+
+  switch (static_cast<uint32_t>(buffer.f_type))
+  {
+  case 0x6969:     // NFS_SUPER_MAGIC
+  case 0x517B:     // SMB_SUPER_MAGIC
+  case 0xFF534D42: // CIFS_MAGIC_NUMBER
+  case 0xFE534D42: // SMB2_MAGIC_NUMBER
+  case 0x65735546: // FUSE_SUPER_MAGIC
+  case 0x564C:     // NCP_SUPER_MAGIC
+  case 0x73757245: // CODA_SUPER_MAGIC
+  case 0x5346414F: // AFS_SUPER_MAGIC
+  case 0x6B414653: // AFS_FS_MAGIC
+  case 0x01021997: // V9FS_MAGIC
+  case 0x00C36400: // CEPH_SUPER_MAGIC
+    return false;
+  default:
+    return true;
+  }
+}
+}
+#endif
+
+CScanJournal::CScanJournal()
+  : CThread("ScanJournal")
+  , m_fd(-1)
+  , m_sequence(0)
+  , m_watchesExhausted(false)
+{
+}
+
+CScanJournal::~CScanJournal()
+{
+  Deinitialize();
+}
+
+CScanJournal& CScanJournal::GetInstance()
+{
+  static CScanJournal sScanJournal;
+  return sScanJournal;
+}
+
+unsigned int CScanJournal::BeginScan(const std::string &directory)
+{
+#ifdef HAVE_INOTIFY
+  if (!URIUtils::IsHD(directory) || URIUtils::IsStack(directory))
+    return 0;
+
+  CSingleLock lock(m_section);
+  if (m_fd < 0)
+  {
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+    {
+      CLog::Log(LOGERROR, "CScanJournal::BeginScan - unable to initialize inotify (%d)", errno);
+      return 0;
+    }
+    Create();
+  }
+
+  Entry &entry = m_entries[directory];
+  if (entry.watch < 0)
+  {
+    std::string path = CSpecialProtocol::TranslatePath(directory);
+    if (!IsLocalFilesystem(path))
+    {
+      m_entries.erase(directory);
+      return 0;
+    }
+    entry.watch = inotify_add_watch(m_fd, path.c_str(), JOURNAL_EVENTS | IN_ONLYDIR);
+    if (entry.watch < 0)
+    {
+      if (errno == ENOSPC && !m_watchesExhausted)
+      {
+        CLog::Log(LOGWARNING, "CScanJournal::BeginScan - out of inotify watches, increase fs.inotify.max_user_watches to track all library folders");
+        m_watchesExhausted = true;
+      }
+      m_entries.erase(directory);
+      return 0;
+    }
+    m_watches.insert(std::make_pair(entry.watch, directory));
+  }
+  return ++m_sequence;
+#else
+  return 0;
+#endif
+}
+
+void CScanJournal::SetScanned(const std::string &directory, unsigned int token, const std::string &hash, const std::vector<std::string> &subfolders)
+{
+  if (!token || hash.empty())
+    return;
+
+  CSingleLock lock(m_section);
+  auto it = m_entries.find(directory);
+  if (it == m_entries.end())
+    return;
+
+  Entry &entry = it->second;
+  if (entry.changed > token)
+  { // changed while we were scanning it, so the stored hash may be stale already
+    entry.scanned = 0;
+    return;
+  }
+  entry.scanned = token;
+  entry.hash = hash;
+  entry.subfolders = subfolders;
+}
+
+bool CScanJournal::IsUnchanged(const std::string &directory, const std::string &hash, std::vector<std::string> *subfolders)
+{
+  CSingleLock lock(m_section);
+  auto it = m_entries.find(directory);
+  if (it == m_entries.end())
+    return false;
+
+  const Entry &entry = it->second;
+  if (!entry.scanned || entry.changed > entry.scanned || entry.hash != hash)
+    return false;
+
+  if (subfolders)
+    *subfolders = entry.subfolders;
+  return true;
+}
+
+void CScanJournal::Deinitialize()
+{
+  StopThread();
+
+  CSingleLock lock(m_section);
+#ifdef HAVE_INOTIFY
+  if (m_fd >= 0)
+    close(m_fd); // drops all watches
+#endif
+  m_fd = -1;
+  m_entries.clear();
+  m_watches.clear();
+}
+
+void CScanJournal::Process()
+{
+#ifdef HAVE_INOTIFY
+  char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  while (!m_bStop)
+  {
+    struct pollfd pfd = { m_fd, POLLIN, 0 };
+    if (poll(&pfd, 1, 500) <= 0)
+      continue;
+
+    ssize_t length = read(m_fd, buffer, sizeof(buffer));
+    if (length <= 0)
+      continue;
+
+    CSingleLock lock(m_section);
+    for (char *ptr = buffer; ptr < buffer + length; )
+    {
+      const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(ptr);
+      if (event->mask & IN_Q_OVERFLOW)
+      { // events were lost, so we can't vouch for anything
+        CLog::Log(LOGWARNING, "CScanJournal::Process - event queue overflowed, all folders will be rescanned");
+        ++m_sequence;
+        for (auto &entry : m_entries)
+          entry.second.changed = m_sequence;
+      }
+      else
+        OnChanged(event->wd, (event->mask & IN_IGNORED) != 0);
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+#endif
+}
+
+void CScanJournal::OnChanged(int watch, bool removed)
+{
+  ++m_sequence;
+  auto range = m_watches.equal_range(watch);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    // once the watch is gone (folder removed, filesystem unmounted) we know nothing about it
+    if (removed)
+      m_entries.erase(it->second);
+    else
+      m_entries[it->second].changed = m_sequence;
+  }
+  if (removed)
+    m_watches.erase(range.first, range.second);
+}
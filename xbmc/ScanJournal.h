@@ -0,0 +1,108 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+/*!
+ \brief Journal of changes to local directories seen since they were last scanned.
+
+ The library scanners normally have to stat or list every directory of a source on each
+ update to find out whether anything changed. For directories on a local filesystem
+ the journal watches each scanned directory with inotify and records whether anything
+ happened in it since, so that directories that are known to be unchanged can be skipped
+ without touching the disk. Network and FUSE mounts are not tracked, as inotify doesn't
+ see changes made to them by other hosts.
+
+ The journal only lives for the lifetime of the application: changes made while we
+ aren't running can't be observed, so the first scan after startup checks everything
+ and arms the watches for the ones that follow.
+
+ Usage from a scanner:
+ \code
+ unsigned int token = CScanJournal::GetInstance().BeginScan(directory);
+ if (!CScanJournal::GetInstance().IsUnchanged(directory, dbHash, &subfolders))
+   ... list and hash the directory, update the database ...
+ CScanJournal::GetInstance().SetScanned(directory, token, hash, subfolders);
+ \endcode
+ */
+class CScanJournal : protected CThread
+{
+public:
+  static CScanJournal& GetInstance();
+
+  /*! \brief Start tracking a directory that is about to be scanned.
+   Any change made to the directory after this call is recorded in the journal.
+   \param directory the directory to be scanned.
+   \return a token to pass to SetScanned(), or 0 if the directory can't be tracked.
+   */
+  unsigned int BeginScan(const std::string &directory);
+
+  /*! \brief Record that a directory was scanned and its hash stored in the library.
+   \param directory the directory that was scanned.
+   \param token the token returned by BeginScan() before the directory was read.
+   \param hash the hash of the directory stored in the library.
+   \param subfolders the subfolders of the directory that the scanner recursed into.
+   */
+  void SetScanned(const std::string &directory, unsigned int token, const std::string &hash, const std::vector<std::string> &subfolders);
+
+  /*! \brief Check whether a directory is known not to have changed since it was scanned.
+   \param directory the directory to check.
+   \param hash the hash of the directory stored in the library.
+   \param subfolders [out] optional, the subfolders of the directory when it was scanned.
+   \return true if the directory was scanned with this hash and hasn't changed since.
+   */
+  bool IsUnchanged(const std::string &directory, const std::string &hash, std::vector<std::string> *subfolders = nullptr);
+
+  /*! \brief Drop all watches and stop the journal.
+   */
+  void Deinitialize();
+
+protected:
+  CScanJournal();
+  ~CScanJournal() override;
+
+  void Process() override;
+
+private:
+  void OnChanged(int watch, bool removed);
+
+  struct Entry
+  {
+    int watch = -1;
+    unsigned int changed = 0;   ///< sequence of the last change seen
+    unsigned int scanned = 0;   ///< token of the scan the hash was stored for, 0 if not known to be current
+    std::string hash;
+    std::vector<std::string> subfolders;
+  };
+
+  int m_fd;
+  unsigned int m_sequence;
+  bool m_watchesExhausted;
+  std::map<std::string, Entry> m_entries;
+  std::multimap<int, std::string> m_watches;
+  CCriticalSection m_section;
+};
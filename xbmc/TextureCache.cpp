@@ -19,10 +19,14 @@
  */
 
 #include "TextureCache.h"
+
+#include <algorithm>
+
 #include "TextureCacheJob.h"
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/Crc32.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
@@ -38,7 +42,11 @@ CTextureCache &CTextureCache::GetInstance()
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE),
+  m_lookupsGeneration(0),
+  m_lookupsTime(0),
+  m_prefetchSequence(0),
+  m_useCountsTime(0)
 {
 }
 
@@ -54,7 +62,24 @@ void CTextureCache::Initialize()
 void CTextureCache::Deinitialize()
 {
   CancelJobs();
+  {
+    CSingleLock lock(m_prefetchSection);
+    for (std::map<const void*, PrefetchRequest>::const_iterator i = m_prefetches.begin(); i != m_prefetches.end(); ++i)
+    {
+      for (std::vector<unsigned int>::const_iterator job = i->second.jobs.begin(); job != i->second.jobs.end(); ++job)
+        CJobManager::GetInstance().CancelJob(*job);
+    }
+    m_prefetches.clear();
+    m_cancelledPrefetches.clear();
+  }
+  { // store the use counts that haven't been written yet
+    CSingleLock lock(m_useCountSection);
+    if (!m_useCounts.empty())
+      CTextureUseCountJob(m_useCounts).DoWork();
+    m_useCounts.clear();
+  }
   CSingleLock lock(m_databaseSection);
+  InvalidateLookups();
   m_database.Close();
 }
 
@@ -113,6 +138,102 @@ std::string CTextureCache::CheckCachedImage(const std::string &url, bool &needsR
   return "";
 }
 
+void CTextureCache::PrefetchImages(const void *requester, const std::vector<std::string> &images)
+{
+  unsigned int sequence;
+  {
+    CSingleLock lock(m_prefetchSection);
+    PrefetchRequest &request = m_prefetches[requester];
+    m_cancelledPrefetches.insert(request.jobs.begin(), request.jobs.end());
+    request.jobs.clear();
+    request.sequence = ++m_prefetchSequence;
+    sequence = request.sequence;
+  }
+
+  // looking the images up may wait on the database, so keep it off the caller's (usually the render) thread
+  CJobManager::GetInstance().Submit([this, requester, images, sequence]() {
+    QueuePrefetchJobs(requester, images, sequence);
+  }, CJob::PRIORITY_LOW_PAUSABLE);
+}
+
+void CTextureCache::QueuePrefetchJobs(const void *requester, const std::vector<std::string> &images, unsigned int sequence)
+{
+  // outstanding prefetch jobs over all requesters, roughly a couple of pages of a poster wall
+  static const size_t max_prefetch_jobs = 100;
+
+  {
+    CSingleLock lock(m_prefetchSection);
+    std::map<const void*, PrefetchRequest>::const_iterator request = m_prefetches.find(requester);
+    if (request == m_prefetches.end() || request->second.sequence != sequence)
+      return; // superseded already
+  }
+
+  PrefetchCachedImages(images);
+  std::vector<std::pair<std::string, std::string> > uncached; // url and hash of the images to (re)cache
+  for (std::vector<std::string>::const_iterator i = images.begin(); i != images.end() && uncached.size() < max_prefetch_jobs; ++i)
+  {
+    CTextureDetails details;
+    std::string path(GetCachedImage(*i, details));
+    if (!path.empty() && details.hash.empty())
+      continue; // already cached
+
+    std::string url = CTextureUtils::UnwrapImageURL(*i);
+    if (url.empty())
+      continue;
+    {
+      CSingleLock lock(m_processingSection);
+      if (m_processinglist.find(url) != m_processinglist.end())
+        continue;
+    }
+    uncached.push_back(std::make_pair(url, details.hash));
+  }
+
+  CSingleLock lock(m_prefetchSection);
+  std::map<const void*, PrefetchRequest>::iterator request = m_prefetches.find(requester);
+  if (request == m_prefetches.end() || request->second.sequence != sequence)
+    return;
+
+  size_t outstanding = 0;
+  for (std::map<const void*, PrefetchRequest>::const_iterator i = m_prefetches.begin(); i != m_prefetches.end(); ++i)
+    outstanding += i->second.jobs.size();
+
+  for (std::vector<std::pair<std::string, std::string> >::const_iterator i = uncached.begin(); i != uncached.end() && outstanding < max_prefetch_jobs; ++i)
+  {
+    unsigned int jobID = CJobManager::GetInstance().AddJob(new CTextureCacheJob(i->first, i->second), this, CJob::PRIORITY_LOW_PAUSABLE);
+    if (jobID)
+    {
+      request->second.jobs.push_back(jobID);
+      outstanding++;
+    }
+  }
+}
+
+void CTextureCache::CancelPrefetch(const void *requester)
+{
+  CSingleLock lock(m_prefetchSection);
+  std::map<const void*, PrefetchRequest>::iterator i = m_prefetches.find(requester);
+  if (i == m_prefetches.end())
+    return;
+  // jobs are dropped as they start (see OnJobProgress) so that those already caching run to completion
+  m_cancelledPrefetches.insert(i->second.jobs.begin(), i->second.jobs.end());
+  m_prefetches.erase(i);
+}
+
+bool CTextureCache::ForgetPrefetch(unsigned int jobID)
+{
+  CSingleLock lock(m_prefetchSection);
+  for (std::map<const void*, PrefetchRequest>::iterator i = m_prefetches.begin(); i != m_prefetches.end(); ++i)
+  {
+    std::vector<unsigned int>::iterator job = std::find(i->second.jobs.begin(), i->second.jobs.end(), jobID);
+    if (job != i->second.jobs.end())
+    {
+      i->second.jobs.erase(job);
+      return true;
+    }
+  }
+  return m_cancelledPrefetches.erase(jobID) > 0;
+}
+
 void CTextureCache::BackgroundCacheImage(const std::string &url)
 {
   if (url.empty())
@@ -182,8 +303,12 @@ void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /
   //! @todo This can be removed when the texture cache covers everything.
   std::string path = deleteSource ? url : "";
   std::string cachedFile;
+  // hold the lock until the file is gone, so a texture being added can't start sharing it
+  CSingleLock lock(m_databaseSection);
   if (ClearCachedTexture(url, cachedFile))
-    path = GetCachedPath(cachedFile);
+    path = !cachedFile.empty() ? GetCachedPath(cachedFile) : "";
+  if (path.empty())
+    return;
   if (CFile::Exists(path))
     CFile::Delete(path);
   path = URIUtils::ReplaceExtension(path, ".dds");
@@ -194,8 +319,11 @@ void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /
 bool CTextureCache::ClearCachedImage(int id)
 {
   std::string cachedFile;
+  CSingleLock lock(m_databaseSection);
   if (ClearCachedTexture(id, cachedFile))
   {
+    if (cachedFile.empty()) // still shared with another texture
+      return true;
     cachedFile = GetCachedPath(cachedFile);
     if (CFile::Exists(cachedFile))
       CFile::Delete(cachedFile);
@@ -207,8 +335,84 @@ bool CTextureCache::ClearCachedImage(int id)
   return false;
 }
 
+void CTextureCache::PrefetchCachedImages(const std::vector<std::string> &images)
+{
+  static const size_t max_lookups = 5000;
+  static const size_t urls_per_query = 500;
+
+  std::vector<std::string> urls;
+  unsigned int generation;
+  {
+    CSingleLock lock(m_lookupSection);
+    ExpireLookups();
+    // more than we keep would only push out the first ones looked up
+    for (std::vector<std::string>::const_iterator i = images.begin(); i != images.end() && urls.size() < max_lookups; ++i)
+    {
+      std::string url = CTextureUtils::UnwrapImageURL(*i);
+      if (!url.empty() && !IsCachedImage(url) && m_lookups.find(url) == m_lookups.end())
+        urls.push_back(url);
+    }
+    generation = m_lookupsGeneration;
+  }
+  if (urls.empty())
+    return;
+
+  // lock the database for one query at a time, so that caching images needn't wait for all of them
+  std::map<std::string, CTextureDetails> textures;
+  for (size_t start = 0; start < urls.size(); start += urls_per_query)
+  {
+    std::vector<std::string> chunk(urls.begin() + start, urls.begin() + std::min(start + urls_per_query, urls.size()));
+    CSingleLock lock(m_databaseSection);
+    if (!m_database.GetCachedTextures(chunk, textures))
+      return;
+  }
+
+  CSingleLock lock(m_lookupSection);
+  if (generation != m_lookupsGeneration)
+    return; // the database changed while we were looking, so the results may be stale
+  if (m_lookups.size() + urls.size() > max_lookups)
+    m_lookups.clear();
+  if (m_lookups.empty())
+    m_lookupsTime = XbmcThreads::SystemClockMillis();
+  for (std::vector<std::string>::const_iterator i = urls.begin(); i != urls.end(); ++i)
+  {
+    std::map<std::string, CTextureDetails>::const_iterator texture = textures.find(*i);
+    m_lookups[*i] = texture != textures.end() ? texture->second : CTextureDetails();
+  }
+}
+
+void CTextureCache::ExpireLookups()
+{
+  // changes made directly through CTextureDatabase aren't seen here, so don't hold on to lookups for long
+  static const unsigned int lookup_lifetime = 60000;
+  if (!m_lookups.empty() && XbmcThreads::SystemClockMillis() - m_lookupsTime >= lookup_lifetime)
+    m_lookups.clear();
+}
+
+void CTextureCache::InvalidateLookups(const std::string &url /* = "" */)
+{
+  CSingleLock lock(m_lookupSection);
+  if (url.empty())
+    m_lookups.clear();
+  else
+    m_lookups.erase(url);
+  m_lookupsGeneration++;
+}
+
 bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
+  {
+    CSingleLock lock(m_lookupSection);
+    ExpireLookups();
+    std::map<std::string, CTextureDetails>::const_iterator i = m_lookups.find(url);
+    if (i != m_lookups.end())
+    {
+      if (i->second.file.empty())
+        return false;
+      details = i->second;
+      return true;
+    }
+  }
   CSingleLock lock(m_databaseSection);
   return m_database.GetCachedTexture(url, details);
 }
@@ -216,16 +420,33 @@ bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &de
 bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.AddCachedTexture(url, details);
+  InvalidateLookups(url);
+  CTextureDetails oldDetails;
+  bool replacing = m_database.GetCachedTexture(url, oldDetails) && oldDetails.file != details.file;
+  if (!m_database.AddCachedTexture(url, details))
+    return false;
+
+  // the previous file may have been shared with other textures, so only remove it once unused
+  if (replacing && !m_database.IsCachedFileInUse(oldDetails.file))
+  {
+    std::string path = GetCachedPath(oldDetails.file);
+    if (CFile::Exists(path))
+      CFile::Delete(path);
+  }
+  return true;
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
   static const size_t count_before_update = 100;
+  static const unsigned int time_before_update = 30000;
   CSingleLock lock(m_useCountSection);
+  if (m_useCounts.empty())
+    m_useCountsTime = XbmcThreads::SystemClockMillis();
   m_useCounts.reserve(count_before_update);
   m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
+  if (m_useCounts.size() >= count_before_update ||
+      XbmcThreads::SystemClockMillis() - m_useCountsTime >= time_before_update)
   {
     AddJob(new CTextureUseCountJob(m_useCounts));
     m_useCounts.clear();
@@ -235,19 +456,30 @@ void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
+  InvalidateLookups(url);
   return m_database.SetCachedTextureValid(url, updateable);
 }
 
 bool CTextureCache::ClearCachedTexture(const std::string &url, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.ClearCachedTexture(url, cachedURL);
+  InvalidateLookups(url);
+  if (!m_database.ClearCachedTexture(url, cachedURL))
+    return false;
+  if (m_database.IsCachedFileInUse(cachedURL))
+    cachedURL.clear();
+  return true;
 }
 
 bool CTextureCache::ClearCachedTexture(int id, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.ClearCachedTexture(id, cachedURL);
+  InvalidateLookups();
+  if (!m_database.ClearCachedTexture(id, cachedURL))
+    return false;
+  if (m_database.IsCachedFileInUse(cachedURL))
+    cachedURL.clear();
+  return true;
 }
 
 std::string CTextureCache::GetCacheFile(const std::string &url)
@@ -270,7 +502,12 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
     if (job->m_oldHash == job->m_details.hash)
       SetCachedTextureValid(job->m_url, job->m_details.updateable);
     else
+    {
+      CSingleLock lock(m_databaseSection);
+      if (!job->m_contentFile.empty())
+        StoreByContent(job->m_details, job->m_contentFile);
       AddCachedTexture(job->m_url, job->m_details);
+    }
   }
 
   { // remove from our processing list
@@ -283,17 +520,45 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
   m_completeEvent.Set();
 }
 
+void CTextureCache::StoreByContent(CTextureDetails &details, const std::string &contentFile)
+{
+  std::string cachedPath = GetCachedPath(details.file);
+  std::string contentPath = GetCachedPath(contentFile);
+  if (CFile::Exists(contentPath, false))
+  { // the same image is already cached for another url, so share its file
+    CLog::Log(LOGDEBUG, "%s sharing cached '%s' for '%s'", __FUNCTION__, contentFile.c_str(), details.file.c_str());
+    CFile::Delete(cachedPath);
+  }
+  else if (!CFile::Rename(cachedPath, contentPath))
+    return;
+  details.file = contentFile;
+}
+
 void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
+  {
+    ForgetPrefetch(jobID);
     OnCachingComplete(success, static_cast<CTextureCacheJob*>(job));
+  }
   return CJobQueue::OnJobComplete(jobID, success, job);
 }
 
 void CTextureCache::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0 && !progress)
-  { // check our processing list
+  {
+    bool cancelledPrefetch;
+    {
+      CSingleLock lock(m_prefetchSection);
+      cancelledPrefetch = m_cancelledPrefetches.erase(jobID) > 0;
+    }
+    if (cancelledPrefetch)
+    { // its requester no longer wants it, and it hasn't done anything yet
+      CJobManager::GetInstance().CancelJob(jobID);
+      return;
+    }
+    // check our processing list
     {
       CSingleLock lock(m_processingSection);
       const CTextureCacheJob *cacheJob = static_cast<const CTextureCacheJob*>(job);
@@ -304,7 +569,10 @@ void CTextureCache::OnJobProgress(unsigned int jobID, unsigned int progress, uns
         return;
       }
     }
-    CancelJob(job);
+    if (ForgetPrefetch(jobID))
+      CJobManager::GetInstance().CancelJob(jobID);
+    else
+      CancelJob(job);
   }
   else
     CJobQueue::OnJobProgress(jobID, progress, total, job);
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -80,6 +81,24 @@ public:
    */
   void BackgroundCacheImage(const std::string &image);
 
+  /*! \brief Cache images that are likely to be displayed soon, using low priority background jobs
+
+   Returns immediately, the images are looked up in the background. Replaces whatever the requester
+   asked to prefetch before. The number of outstanding prefetch jobs is limited, so images should be
+   given in the order they are wanted.
+
+   \param requester identifies the caller, eg the container scrolling towards the images
+   \param images urls of the images to cache
+   \sa CancelPrefetch, BackgroundCacheImage
+   */
+  void PrefetchImages(const void *requester, const std::vector<std::string> &images);
+
+  /*! \brief Drop the images a requester asked to prefetch that haven't started caching yet
+   \param requester the caller given to PrefetchImages
+   \sa PrefetchImages
+   */
+  void CancelPrefetch(const void *requester);
+
   /*! \brief Cache an image to image cache, optionally return the texture
 
    Caches the given image, returning the texture if the caller wants it.
@@ -100,6 +119,16 @@ public:
    */
   bool CacheImage(const std::string &image, CTextureDetails &details);
 
+  /*! \brief Look up the cached versions of many images with a single database query
+
+   The results are kept for a short while, so that the texture lookups made as the images
+   are displayed don't each need to hit the database.
+
+   \param images urls of the images
+   \sa GetCachedImage
+   */
+  void PrefetchCachedImages(const std::vector<std::string> &images);
+
   /*! \brief Check whether an image is in the cache
    Note: If the image url won't normally be cached (eg a skin image) this function will return false.
    \param image url of the image
@@ -140,7 +169,8 @@ public:
   static bool CanCacheImageURL(const CURL &url);
 
   /*! \brief Add this image to the database
-   Thread-safe wrapper of CTextureDatabase::AddCachedTexture
+   Thread-safe wrapper of CTextureDatabase::AddCachedTexture. Any file previously cached for
+   the image is removed once no other texture shares it.
    \param image url of the original image
    \param details the texture details to add
    \return true if we successfully added to the database, false otherwise.
@@ -177,7 +207,7 @@ private:
    */
   std::string GetCachedImage(const std::string &image, CTextureDetails &details, bool trackUsage = false);
 
-  /*! \brief Get an image from the database
+  /*! \brief Get an image from the prefetched lookups or the database
    Thread-safe wrapper of CTextureDatabase::GetCachedTexture
    \param image url of the original image
    \param details [out] texture details from the database (if available)
@@ -188,7 +218,7 @@ private:
   /*! \brief Clear an image from the database
    Thread-safe wrapper of CTextureDatabase::ClearCachedTexture
    \param image url of the original image
-   \param cacheFile [out] url of the cached original (if available)
+   \param cacheFile [out] url of the cached original (if available), empty if other textures still share it
    \return true if we had a cached version of this image, false otherwise.
    */
   bool ClearCachedTexture(const std::string &url, std::string &cacheFile);
@@ -208,6 +238,30 @@ private:
    */
   bool SetCachedTextureValid(const std::string &url, bool updateable);
 
+  /*! \brief Forget prefetched lookups
+   Must be called with m_databaseSection held, after the database has been changed.
+   \param url url of the image to forget, or empty to forget them all
+   \sa PrefetchCachedImages
+   */
+  void InvalidateLookups(const std::string &url = "");
+
+  /*! \brief Forget all prefetched lookups once they are too old (m_lookupSection must be held)
+   */
+  void ExpireLookups();
+
+  /*! \brief Look up the images of a prefetch request and queue jobs for those not cached yet
+   \param requester the caller given to PrefetchImages
+   \param images urls of the images
+   \param sequence the request, skipped if the requester has asked for something else since
+   */
+  void QueuePrefetchJobs(const void *requester, const std::vector<std::string> &images, unsigned int sequence);
+
+  /*! \brief Stop tracking a prefetch job
+   \param jobID id of the job
+   \return true if the job was a prefetch job, false otherwise
+   */
+  bool ForgetPrefetch(unsigned int jobID);
+
   void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
   void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job) override;
 
@@ -219,12 +273,35 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Move a freshly cached file to the name derived from its content.
+   If a file with the same content is already cached, it is shared and the new copy discarded.
+   Must be called with m_databaseSection held, up to adding the texture to the database, so the
+   shared file can't be removed along with the last texture using it in between.
+   \param details the details of the cached texture, file is updated on success.
+   \param contentFile the name derived from the content of the file.
+   */
+  void StoreByContent(CTextureDetails &details, const std::string &contentFile);
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
+  std::map<std::string, CTextureDetails> m_lookups; ///< prefetched lookups, an empty file meaning not cached
+  unsigned int                 m_lookupsGeneration; ///< bumped whenever m_lookups is invalidated
+  unsigned int                 m_lookupsTime; ///< when m_lookups was first filled
+  CCriticalSection             m_lookupSection;
+  struct PrefetchRequest
+  {
+    unsigned int sequence = 0;       ///< identifies the latest request, so that superseded ones are skipped
+    std::vector<unsigned int> jobs;  ///< outstanding prefetch jobs
+  };
+  std::map<const void*, PrefetchRequest> m_prefetches; ///< prefetch requests by requester
+  unsigned int                 m_prefetchSequence;
+  std::set<unsigned int>       m_cancelledPrefetches; ///< prefetch jobs to drop once they start
+  CCriticalSection             m_prefetchSection;
   std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
+  unsigned int                 m_useCountsTime; ///< when the oldest unwritten use count was tracked
   CCriticalSection             m_useCountSection;
 };
 
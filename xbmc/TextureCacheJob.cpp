@@ -19,11 +19,17 @@
  */
 
 #include "TextureCacheJob.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
 #include "TextureCache.h"
 #include "guilib/Texture.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
+#include "utils/md5.h"
 #include "filesystem/File.h"
 #include "pictures/Picture.h"
 #include "utils/URIUtils.h"
@@ -94,13 +100,19 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     m_details.width = width;
     m_details.height = height;
     m_details.file = m_cachePath + ".jpg";
+    HashContent();
     if (out_texture)
       *out_texture = LoadImage(CTextureCache::GetCachedPath(m_details.file), width, height, "" /* already flipped */);
     CLog::Log(LOGDEBUG, "Fast %s image '%s' to '%s': %p", m_oldHash.empty() ? "Caching" : "Recaching", CURL::GetRedacted(image).c_str(), m_details.file.c_str(), out_texture);
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
+  // CPicture::CacheTexture() scales down to at most the image or fanart resolution, so there's
+  // no need to decode the image any larger than that. allow for the 1% it accepts as 16x9 fanart
+  unsigned int maxHeight = std::max(g_advancedSettings.m_imageRes, g_advancedSettings.m_fanartRes);
+  unsigned int maxWidth = maxHeight * 16 * 101 / (9 * 100);
+  CBaseTexture *texture = LoadImage(image, width ? std::min(width, maxWidth) : maxWidth,
+                                    height ? std::min(height, maxHeight) : maxHeight, additional_info, true);
   if (texture)
   {
     if (texture->HasAlpha())
@@ -114,6 +126,7 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     {
       m_details.width = width;
       m_details.height = height;
+      HashContent();
       if (out_texture) // caller wants the texture
         *out_texture = texture;
       else
@@ -125,6 +138,21 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
   return false;
 }
 
+void CTextureCacheJob::HashContent()
+{
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (file.LoadFile(CTextureCache::GetCachedPath(m_details.file), buffer) <= 0)
+    return;
+  file.Close();
+
+  XBMC::XBMC_MD5 md5;
+  md5.append(buffer.get(), buffer.size());
+  std::string hash = md5.getDigest();
+  StringUtils::ToLower(hash);
+  m_contentFile = StringUtils::Format("%c/%s%s", hash[0], hash.c_str(), URIUtils::GetExtension(m_details.file).c_str());
+}
+
 bool CTextureCacheJob::ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size)
 {
   result = NULL;
@@ -267,12 +295,23 @@ bool CTextureUseCountJob::operator==(const CJob* job) const
 
 bool CTextureUseCountJob::DoWork()
 {
+  // a texture is typically used several times in a row, so write one update per texture and size
+  std::map<std::tuple<int, unsigned int, unsigned int>, unsigned int> counts;
+  for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
+    counts[std::make_tuple(i->id, i->width, i->height)]++;
+
   CTextureDatabase db;
   if (db.Open())
   {
     db.BeginTransaction();
-    for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
-      db.IncrementUseCount(*i);
+    for (const auto &count : counts)
+    {
+      CTextureDetails details;
+      details.id = std::get<0>(count.first);
+      details.width = std::get<1>(count.first);
+      details.height = std::get<2>(count.first);
+      db.IncrementUseCount(details, count.second);
+    }
     db.CommitTransaction();
   }
   return true;
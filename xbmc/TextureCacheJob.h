@@ -84,6 +84,7 @@ public:
   std::string m_url;
   std::string m_oldHash;
   CTextureDetails m_details;
+  std::string m_contentFile; ///< name derived from the content of the cached file, see CTextureCache::OnCachingComplete
 private:
   /*! \brief retrieve a hash for the given image
    Combines the size, ctime and mtime of the image file into a "unique" hash
@@ -124,6 +125,13 @@ private:
    */
   static CBaseTexture *LoadImage(const std::string &image, unsigned int width, unsigned int height, const std::string &additional_info, bool requirePixels = false);
 
+  /*! \brief Derive a file name for the freshly cached file from its content
+   Identical images reached through different URLs then share a single cached file. The file is
+   only moved (or discarded in favour of an existing copy) once the texture is added to the database.
+   Sets m_contentFile on success, leaving it empty otherwise.
+   */
+  void HashContent();
+
   std::string    m_cachePath;
 };
 
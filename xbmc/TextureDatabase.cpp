@@ -177,6 +177,7 @@ void CTextureDatabase::CreateAnalytics()
 {
   CLog::Log(LOGINFO, "%s creating indices", __FUNCTION__);
   m_pDS->exec("CREATE INDEX idxTexture ON texture(url)");
+  m_pDS->exec("CREATE INDEX idxTexture2 ON texture(cachedurl)");
   m_pDS->exec("CREATE INDEX idxSize ON sizes(idtexture, size)");
   m_pDS->exec("CREATE INDEX idxSize2 ON sizes(idtexture, width, height)");
   //! @todo Should the path index be a covering index? (we need only retrieve texture)
@@ -241,12 +242,24 @@ void CTextureDatabase::UpdateTables(int version)
   }
 }
 
-bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
+bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details, unsigned int count /* = 1 */)
 {
-  std::string sql = PrepareSQL("UPDATE sizes SET usecount=usecount+1, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", details.id, details.width, details.height);
+  std::string sql = PrepareSQL("UPDATE sizes SET usecount=usecount+%u, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", count, details.id, details.width, details.height);
   return ExecuteQuery(sql);
 }
 
+void CTextureDatabase::GetTextureDetailsFromDataset(CTextureDetails &details, int offset)
+{
+  details.id = m_pDS->fv(offset).get_asInt();
+  details.file  = m_pDS->fv(offset + 1).get_asString();
+  CDateTime lastCheck;
+  lastCheck.SetFromDBDateTime(m_pDS->fv(offset + 2).get_asString());
+  if (lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime())
+    details.hash = m_pDS->fv(offset + 3).get_asString();
+  details.width = m_pDS->fv(offset + 4).get_asInt();
+  details.height = m_pDS->fv(offset + 5).get_asInt();
+}
+
 bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
   try
@@ -258,14 +271,7 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
     m_pDS->query(sql);
     if (!m_pDS->eof())
     { // have some information
-      details.id = m_pDS->fv(0).get_asInt();
-      details.file  = m_pDS->fv(1).get_asString();
-      CDateTime lastCheck;
-      lastCheck.SetFromDBDateTime(m_pDS->fv(2).get_asString());
-      if (lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime())
-        details.hash = m_pDS->fv(3).get_asString();
-      details.width = m_pDS->fv(4).get_asInt();
-      details.height = m_pDS->fv(5).get_asInt();
+      GetTextureDetailsFromDataset(details, 0);
       m_pDS->close();
       return true;
     }
@@ -278,6 +284,40 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
   return false;
 }
 
+bool CTextureDatabase::GetCachedTextures(const std::vector<std::string> &urls, std::map<std::string, CTextureDetails> &textures)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string urlList;
+    for (std::vector<std::string>::const_iterator i = urls.begin(); i != urls.end(); ++i)
+    {
+      if (!urlList.empty())
+        urlList += ",";
+      urlList += PrepareSQL("'%s'", i->c_str());
+    }
+
+    std::string sql = "SELECT url, id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url IN (" + urlList + ")";
+    m_pDS->query(sql);
+    while (!m_pDS->eof())
+    {
+      CTextureDetails details;
+      GetTextureDetailsFromDataset(details, 1);
+      textures[m_pDS->fv(0).get_asString()] = details;
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed on %u urls", __FUNCTION__, static_cast<unsigned int>(urls.size()));
+  }
+  return false;
+}
+
 bool CTextureDatabase::GetTextures(CVariant &items, const Filter &filter)
 {
   try
@@ -391,6 +431,11 @@ bool CTextureDatabase::ClearCachedTexture(int id, std::string &cacheFile)
   return false;
 }
 
+bool CTextureDatabase::IsCachedFileInUse(const std::string &cacheFile)
+{
+  return !GetSingleValue(PrepareSQL("SELECT id FROM texture WHERE cachedurl='%s' LIMIT 1", cacheFile.c_str())).empty();
+}
+
 bool CTextureDatabase::InvalidateCachedTexture(const std::string &url)
 {
   std::string date = (CDateTime::GetCurrentDateTime() - CDateTimeSpan(2, 0, 0, 0)).GetAsDBDateTime();
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -75,11 +76,27 @@ public:
   bool Open() override;
 
   bool GetCachedTexture(const std::string &originalURL, CTextureDetails &details);
+
+  /*! \brief Look up the cached textures of many images with a single query
+   \param originalURLs urls of the original images, a few hundred at most to keep the query reasonably sized
+   \param textures [out] details of those images that are cached, keyed by url
+   \return true if the lookup succeeded, false otherwise
+   \sa GetCachedTexture
+   */
+  bool GetCachedTextures(const std::vector<std::string> &originalURLs, std::map<std::string, CTextureDetails> &textures);
   bool AddCachedTexture(const std::string &originalURL, const CTextureDetails &details);
   bool SetCachedTextureValid(const std::string &originalURL, bool updateable);
   bool ClearCachedTexture(const std::string &originalURL, std::string &cacheFile);
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
-  bool IncrementUseCount(const CTextureDetails &details);
+  bool IncrementUseCount(const CTextureDetails &details, unsigned int count = 1);
+
+  /*! \brief Check whether a cached file is still referenced by any texture
+   Cached files are named after their content, so identical images reached through
+   different URLs share a single file.
+   \param cacheFile the cached file, relative to the thumbnails folder
+   \return true if at least one texture uses the file, false otherwise
+   */
+  bool IsCachedFileInUse(const std::string &cacheFile);
 
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
@@ -129,9 +146,14 @@ protected:
    */
   unsigned int GetURLHash(const std::string &url) const;
 
+  /*! \brief fill texture details from the current row of m_pDS
+   Expects id, cachedurl, lasthashcheck, imagehash, width and height starting at the given field.
+   */
+  void GetTextureDetailsFromDataset(CTextureDetails &details, int offset);
+
   void CreateTables() override;
   void CreateAnalytics() override;
   void UpdateTables(int version) override;
-  int GetSchemaVersion() const override { return 13; };
+  int GetSchemaVersion() const override { return 14; };
   const char *GetBaseDBName() const override { return "Textures"; };
 };
@@ -41,6 +41,19 @@ void CThumbLoader::OnLoaderStart()
   m_textureDatabase->Open();
 }
 
+void CThumbLoader::OnCachedItemsLoaded()
+{
+  // resolve the cached art of the whole list at once rather than per image as it is displayed
+  std::vector<std::string> images;
+  for (std::vector<CFileItemPtr>::const_iterator i = m_vecItems.begin(); i != m_vecItems.end(); ++i)
+  {
+    const CGUIListItem::ArtMap &art = (*i)->GetArt();
+    for (CGUIListItem::ArtMap::const_iterator j = art.begin(); j != art.end(); ++j)
+      images.push_back(j->second);
+  }
+  CTextureCache::GetInstance().PrefetchCachedImages(images);
+}
+
 void CThumbLoader::OnLoaderFinish()
 {
   m_textureDatabase->Close();
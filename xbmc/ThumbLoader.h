@@ -31,6 +31,7 @@ public:
   ~CThumbLoader() override;
 
   void OnLoaderStart() override;
+  void OnCachedItemsLoaded() override;
   void OnLoaderFinish() override;
 
   /*! \brief helper function to fill the art for a library item
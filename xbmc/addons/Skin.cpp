@@ -20,6 +20,7 @@
 
 #include "Skin.h"
 #include "AddonManager.h"
+#include "GUIInfoManager.h"
 #include "ServiceBroker.h"
 #include "Util.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -310,6 +311,20 @@ void CSkinInfo::LoadIncludes()
   CLog::Log(LOGINFO, "Loading skin includes from %s", includesPath.c_str());
   m_includes.Clear();
   m_includes.Load(includesPath);
+
+  // cached windows are only valid for the skin setup and include files they were resolved with
+  std::string key = ID() + "|" + Version().asString() + "|" + m_currentAspect;
+  const std::vector<std::string> &files = m_includes.GetFiles();
+  for (const auto &file : files)
+  {
+    struct __stat64 buffer;
+    if (CFile::Stat(file, &buffer) == 0)
+      key += "|" + file + ":" + std::to_string(buffer.st_size) + ":" + std::to_string(buffer.st_mtime);
+  }
+  m_skinIncludeCount = files.size();
+
+  m_windowCache.Save();
+  m_windowCache.Load("special://temp/" + ID() + ".skincache", key);
 }
 
 void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions /* = NULL */)
@@ -320,6 +335,54 @@ void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool
   m_includes.Resolve(node, xmlIncludeConditions);
 }
 
+std::unique_ptr<TiXmlElement> CSkinInfo::GetCachedWindow(const std::string &file, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions)
+{
+  std::vector<std::string> includeFiles;
+  CGUISkinCache::Conditions conditions;
+  std::unique_ptr<TiXmlElement> root = m_windowCache.Get(file, includeFiles, conditions);
+  if (!root)
+    return nullptr;
+
+  // the window has to be resolved again if any of its include conditions changed
+  std::map<INFO::InfoPtr, bool> values;
+  for (const auto &condition : conditions)
+  {
+    INFO::InfoPtr info = g_infoManager.Register(condition.first);
+    if (!info || info->Get() != condition.second)
+      return nullptr;
+    values.insert(std::make_pair(info, condition.second));
+  }
+
+  // windows loaded later may rely on include files pulled in by this one
+  for (const auto &includeFile : includeFiles)
+    m_includes.Load(includeFile);
+
+  if (xmlIncludeConditions)
+    *xmlIncludeConditions = std::move(values);
+
+  return root;
+}
+
+void CSkinInfo::CacheWindow(const std::string &file, const TiXmlElement *node, const std::map<INFO::InfoPtr, bool> &xmlIncludeConditions)
+{
+  const std::vector<std::string> &files = m_includes.GetFiles();
+  std::vector<std::string> includeFiles(files.begin() + std::min(m_skinIncludeCount, files.size()), files.end());
+
+  CGUISkinCache::Conditions conditions;
+  for (const auto &condition : xmlIncludeConditions)
+  {
+    if (condition.first)
+      conditions.push_back(std::make_pair(condition.first->GetExpression(), condition.second));
+  }
+
+  m_windowCache.Set(file, node, includeFiles, conditions);
+}
+
+void CSkinInfo::SaveWindowCache()
+{
+  m_windowCache.Save();
+}
+
 int CSkinInfo::GetStartWindow() const
 {
   int windowID = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_LOOKANDFEEL_STARTUPWINDOW);
@@ -21,6 +21,7 @@
  */
 
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 #include <utility>
@@ -28,6 +29,7 @@
 #include "addons/Addon.h"
 #include "guilib/GraphicContext.h" // needed for the RESOLUTION members
 #include "guilib/GUIIncludes.h"    // needed for the GUIInclude member
+#include "guilib/GUISkinCache.h"   // needed for the window cache member
 
 #define CREDIT_LINE_LENGTH 50
 
@@ -166,6 +168,22 @@ public:
 
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
 
+  /*! \brief Retrieve an already resolved window from the skin's window cache
+   \param file path of the window xml
+   \param xmlIncludeConditions [out] the conditions of the resolved includes
+   \return the resolved window element, or nullptr if the window has to be resolved from its xml
+   */
+  std::unique_ptr<TiXmlElement> GetCachedWindow(const std::string &file, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions);
+
+  /*! \brief Store a resolved window in the skin's window cache
+   \param file path of the window xml
+   \param node the resolved window element
+   \param xmlIncludeConditions the conditions of the resolved includes
+   */
+  void CacheWindow(const std::string &file, const TiXmlElement *node, const std::map<INFO::InfoPtr, bool> &xmlIncludeConditions);
+
+  void SaveWindowCache();
+
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
   const std::vector<CStartupWindow> &GetStartupWindows() const { return m_startupWindows; };
@@ -237,6 +255,8 @@ protected:
 
   float m_effectsSlowDown;
   CGUIIncludes m_includes;
+  CGUISkinCache m_windowCache;
+  size_t m_skinIncludeCount = 0; ///< number of include files loaded with the skin, these are part of the window cache key
   std::string m_currentAspect;
 
   std::vector<CStartupWindow> m_startupWindows;
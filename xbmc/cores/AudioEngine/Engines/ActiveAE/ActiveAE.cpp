@@ -23,11 +23,14 @@
 using namespace ActiveAE;
 #include "ActiveAESound.h"
 #include "ActiveAEStream.h"
+#include "ActiveAEResampleCache.h"
+#include "ActiveAESoundCache.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSP.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSPProcess.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
+#include "cores/AudioEngine/Utils/AETelemetry.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
 
@@ -1828,6 +1831,7 @@ void CActiveAE::UnconfigureSink()
 bool CActiveAE::RunStages()
 {
   bool busy = false;
+  int64_t start = CAETelemetry::Now();
 
   // serve input streams
   std::list<CActiveAEStream*>::iterator it;
@@ -2255,6 +2259,8 @@ bool CActiveAE::RunStages()
     busy = true;
   }
 
+  CAETelemetry::GetInstance().AddTime(CAETelemetry::HISTOGRAM_ENGINE_CYCLE, CAETelemetry::Now() - start);
+
   return busy;
 }
 
@@ -2480,6 +2486,20 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
   {
     if (!it->sound->IsConverted())
       ResampleSound(it->sound);
+
+    // still being converted, mix it in once it is ready
+    if (!it->sound->IsConverted())
+    {
+      ++it;
+      continue;
+    }
+
+    if (!it->sound->GetSound(false))
+    {
+      it = m_sounds_playing.erase(it);
+      continue;
+    }
+
     int available_samples = it->sound->GetSound(false)->nb_samples - it->samples_played;
     int mix_samples = std::min(max_samples, available_samples);
     int start = it->samples_played *
@@ -2972,6 +2992,16 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
   SampleConfig config;
 
   sound = new CActiveAESound(file, this);
+
+  // sounds are shared by skin actions, decode each file only once
+  std::shared_ptr<CSoundPacket> decoded = CActiveAESoundCache::GetInstance().GetDecoded(file);
+  if (decoded)
+  {
+    sound->SetSound(true, decoded);
+    m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
+    return sound;
+  }
+
   if (!sound->Prepare())
   {
     delete sound;
@@ -3093,6 +3123,8 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
 
   sound->Finish();
 
+  CActiveAESoundCache::GetInstance().StoreDecoded(file, sound->GetSharedSound(true));
+
   // register sound
   m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
 
@@ -3129,20 +3161,15 @@ void CActiveAE::ResampleSounds()
   std::vector<CActiveAESound*>::iterator it;
   for (it = m_sounds.begin(); it != m_sounds.end(); ++it)
   {
+    // conversion is done by a worker, this only requests it
     if (!(*it)->IsConverted())
-    {
       ResampleSound(*it);
-      // only do one sound, then yield to main loop
-      break;
-    }
   }
 }
 
 bool CActiveAE::ResampleSound(CActiveAESound *sound)
 {
-  SampleConfig orig_config, dst_config;
-  uint8_t **dst_buffer;
-  int dst_samples;
+  SampleConfig dst_config;
 
   if (m_mode == MODE_RAW || m_internalFormat.m_dataFormat == AE_FMT_INVALID)
     return false;
@@ -3150,8 +3177,6 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
   if (!sound->GetSound(true))
     return false;
 
-  orig_config = sound->GetSound(true)->config;
-
   dst_config.channel_layout = CAEUtil::GetAVChannelLayout(m_internalFormat.m_channelLayout);
   dst_config.channels = m_internalFormat.m_channelLayout.Count();
   dst_config.sample_rate = m_internalFormat.m_sampleRate;
@@ -3174,45 +3199,20 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
     }
   }
 
-  IAEResample *resampler = CAEResampleFactory::Create(AERESAMPLEFACTORY_QUICK_RESAMPLE);
-  resampler->Init(dst_config.channel_layout,
-                  dst_config.channels,
-                  dst_config.sample_rate,
-                  dst_config.fmt,
-                  dst_config.bits_per_sample,
-                  dst_config.dither_bits,
-                  orig_config.channel_layout,
-                  orig_config.channels,
-                  orig_config.sample_rate,
-                  orig_config.fmt,
-                  orig_config.bits_per_sample,
-                  orig_config.dither_bits,
-                  false,
-                  true,
-                  outChannels.Count() > 0 ? &outChannels : NULL,
-                  m_settings.resampleQuality,
-                  false);
-
-  dst_samples = resampler->CalcDstSampleCount(sound->GetSound(true)->nb_samples,
-                                              m_internalFormat.m_sampleRate,
-                                              orig_config.sample_rate);
-
-  dst_buffer = sound->InitSound(false, dst_config, dst_samples);
-  if (!dst_buffer)
-  {
-    delete resampler;
+  // never block the engine thread, if the converted sound is not
+  // ready yet we get called again
+  std::shared_ptr<CSoundPacket> converted;
+  if (!CActiveAESoundCache::GetInstance().GetConverted(sound->GetFileName(),
+                                                       sound->GetSharedSound(true),
+                                                       dst_config,
+                                                       outChannels,
+                                                       m_settings.resampleQuality,
+                                                       converted))
     return false;
-  }
-  int samples = resampler->Resample(dst_buffer, dst_samples,
-                                    sound->GetSound(true)->data,
-                                    sound->GetSound(true)->nb_samples,
-                                    1.0);
-
-  sound->GetSound(false)->nb_samples = samples;
 
-  delete resampler;
+  sound->SetSound(false, converted);
   sound->SetConverted(true);
-  return true;
+  return converted != nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -21,10 +21,11 @@
 #include "ActiveAE.h"
 #include "ActiveAEBuffer.h"
 #include "ActiveAEFilter.h"
+#include "ActiveAEResampleCache.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSPProcess.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Utils/AETelemetry.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
-#include "cores/AudioEngine/AEResampleFactory.h"
 
 using namespace ActiveAE;
 
@@ -174,9 +175,11 @@ CActiveAEBufferPoolResample::CActiveAEBufferPoolResample(const AEAudioFormat& in
 
 CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
 {
-  Flush();
+  // the cache resets the resampler when taking it back, Flush doesn't have to
+  CActiveAEResampleCache::GetInstance().Release(m_resampler);
+  m_resampler = nullptr;
 
-  delete m_resampler;
+  Flush();
 }
 
 bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, bool upmix, bool normalize)
@@ -195,60 +198,41 @@ bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, boo
       m_inputFormat.m_dataFormat != m_format.m_dataFormat ||
       m_changeResampler)
   {
-    if (!m_resampler)
-    {
-      m_resampler = CAEResampleFactory::Create();
-    }
-
-    m_resampler->Init(CAEUtil::GetAVChannelLayout(m_format.m_channelLayout),
-                                m_format.m_channelLayout.Count(),
-                                m_format.m_sampleRate,
-                                CAEUtil::GetAVSampleFormat(m_format.m_dataFormat),
-                                CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat),
-                                CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat),
-                                CAEUtil::GetAVChannelLayout(m_inputFormat.m_channelLayout),
-                                m_inputFormat.m_channelLayout.Count(),
-                                m_inputFormat.m_sampleRate,
-                                CAEUtil::GetAVSampleFormat(m_inputFormat.m_dataFormat),
-                                CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat),
-                                CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat),
-                                upmix,
-                                m_normalize,
-                                remap ? &m_format.m_channelLayout : NULL,
-                                m_resampleQuality,
-                                m_forceResampler);
-
-    m_changeResampler = false;
+    ChangeResampler();
   }
   return true;
 }
 
 void CActiveAEBufferPoolResample::ChangeResampler()
 {
-  if (m_resampler)
-  {
-    delete m_resampler;
-    m_resampler = NULL;
-  }
-
-  m_resampler = CAEResampleFactory::Create();
-  m_resampler->Init(CAEUtil::GetAVChannelLayout(m_format.m_channelLayout),
-                                m_format.m_channelLayout.Count(),
-                                m_format.m_sampleRate,
-                                CAEUtil::GetAVSampleFormat(m_format.m_dataFormat),
-                                CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat),
-                                CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat),
-                                CAEUtil::GetAVChannelLayout(m_inputFormat.m_channelLayout),
-                                m_inputFormat.m_channelLayout.Count(),
-                                m_inputFormat.m_sampleRate,
-                                CAEUtil::GetAVSampleFormat(m_inputFormat.m_dataFormat),
-                                CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat),
-                                CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat),
-                                m_stereoUpmix,
-                                m_normalize,
-                                m_remap ? &m_format.m_channelLayout : NULL,
-                                m_resampleQuality,
-                                m_forceResampler);
+  CActiveAEResampleCache &cache = CActiveAEResampleCache::GetInstance();
+
+  // the old instance is reset and kept by the cache, flushing or changing
+  // back to a previous configuration does not need to rebuild it
+  cache.Release(m_resampler);
+
+  ResampleConfig config;
+  config.dst_chan_layout = CAEUtil::GetAVChannelLayout(m_format.m_channelLayout);
+  config.dst_channels = m_format.m_channelLayout.Count();
+  config.dst_rate = m_format.m_sampleRate;
+  config.dst_fmt = CAEUtil::GetAVSampleFormat(m_format.m_dataFormat);
+  config.dst_bits = CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat);
+  config.dst_dither = CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat);
+  config.src_chan_layout = CAEUtil::GetAVChannelLayout(m_inputFormat.m_channelLayout);
+  config.src_channels = m_inputFormat.m_channelLayout.Count();
+  config.src_rate = m_inputFormat.m_sampleRate;
+  config.src_fmt = CAEUtil::GetAVSampleFormat(m_inputFormat.m_dataFormat);
+  config.src_bits = CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat);
+  config.src_dither = CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat);
+  config.upmix = m_stereoUpmix;
+  config.normalize = m_normalize;
+  config.remap = m_remap;
+  if (m_remap)
+    config.remapLayout = m_format.m_channelLayout;
+  config.quality = m_resampleQuality;
+  config.force_resample = m_forceResampler;
+
+  m_resampler = cache.Acquire(config);
 
   m_changeResampler = false;
 }
@@ -318,11 +302,13 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
         m_planes[i] = m_procSample->pkt->data[i] + start;
       }
 
+      int64_t resampleStart = CAETelemetry::Now();
       int out_samples = m_resampler->Resample(m_planes,
                                               m_procSample->pkt->max_nb_samples - m_procSample->pkt->nb_samples,
                                               in ? in->pkt->data : NULL,
                                               in ? in->pkt->nb_samples : 0,
                                               m_resampleRatio);
+      CAETelemetry::GetInstance().AddResampleTime(CAETelemetry::Now() - resampleStart);
       // in case of error, trigger re-create of resampler
       if (out_samples < 0)
       {
@@ -461,7 +447,7 @@ void CActiveAEBufferPoolResample::Flush()
     m_outputSamples.front()->Return();
     m_outputSamples.pop_front();
   }
-  if (m_resampler)
+  if (m_resampler && !m_resampler->Reset())
     ChangeResampler();
 }
 
@@ -0,0 +1,138 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAEResampleCache.h"
+#include "cores/AudioEngine/AEResampleFactory.h"
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <string>
+#include <tuple>
+
+namespace ActiveAE
+{
+
+bool ResampleConfig::operator<(const ResampleConfig &rhs) const
+{
+  auto lhsTuple = std::make_tuple(dst_chan_layout, dst_channels, dst_rate, dst_fmt, dst_bits, dst_dither,
+                                  src_chan_layout, src_channels, src_rate, src_fmt, src_bits, src_dither,
+                                  upmix, normalize, remap, quality, force_resample, factoryFlags);
+  auto rhsTuple = std::make_tuple(rhs.dst_chan_layout, rhs.dst_channels, rhs.dst_rate, rhs.dst_fmt, rhs.dst_bits, rhs.dst_dither,
+                                  rhs.src_chan_layout, rhs.src_channels, rhs.src_rate, rhs.src_fmt, rhs.src_bits, rhs.src_dither,
+                                  rhs.upmix, rhs.normalize, rhs.remap, rhs.quality, rhs.force_resample, rhs.factoryFlags);
+  if (lhsTuple != rhsTuple)
+    return lhsTuple < rhsTuple;
+
+  if (!remap)
+    return false;
+
+  return static_cast<std::string>(remapLayout) < static_cast<std::string>(rhs.remapLayout);
+}
+
+CActiveAEResampleCache& CActiveAEResampleCache::GetInstance()
+{
+  static CActiveAEResampleCache instance;
+  return instance;
+}
+
+CActiveAEResampleCache::~CActiveAEResampleCache()
+{
+  Clear();
+}
+
+IAEResample* CActiveAEResampleCache::Acquire(const ResampleConfig &config)
+{
+  {
+    CSingleLock lock(m_lock);
+    for (auto it = m_idle.begin(); it != m_idle.end(); ++it)
+    {
+      if (!(it->config < config) && !(config < it->config))
+      {
+        IAEResample *resampler = it->resampler;
+        m_idle.erase(it);
+        m_inUse[resampler] = config;
+        return resampler;
+      }
+    }
+  }
+
+  // initialise outside the lock, this is the expensive part
+  IAEResample *resampler = CAEResampleFactory::Create(config.factoryFlags);
+  CAEChannelInfo remapLayout = config.remapLayout;
+  if (!resampler->Init(config.dst_chan_layout, config.dst_channels, config.dst_rate,
+                       config.dst_fmt, config.dst_bits, config.dst_dither,
+                       config.src_chan_layout, config.src_channels, config.src_rate,
+                       config.src_fmt, config.src_bits, config.src_dither,
+                       config.upmix, config.normalize,
+                       config.remap ? &remapLayout : nullptr,
+                       config.quality, config.force_resample))
+  {
+    // same as an uncached instance, the caller notices on Resample.
+    // don't track it so that it won't be reused
+    CLog::Log(LOGERROR, "CActiveAEResampleCache::Acquire - failed to init %s", resampler->GetName());
+    return resampler;
+  }
+
+  CSingleLock lock(m_lock);
+  m_inUse[resampler] = config;
+  return resampler;
+}
+
+void CActiveAEResampleCache::Release(IAEResample *resampler)
+{
+  if (!resampler)
+    return;
+
+  CSingleLock lock(m_lock);
+  auto it = m_inUse.find(resampler);
+  if (it == m_inUse.end())
+  {
+    // not created by us
+    delete resampler;
+    return;
+  }
+
+  ResampleConfig config = it->second;
+  m_inUse.erase(it);
+
+  if (!resampler->Reset())
+  {
+    delete resampler;
+    return;
+  }
+
+  m_idle.push_front({config, resampler});
+  while (m_idle.size() > MAX_IDLE)
+  {
+    delete m_idle.back().resampler;
+    m_idle.pop_back();
+  }
+}
+
+void CActiveAEResampleCache::Clear()
+{
+  CSingleLock lock(m_lock);
+  for (auto &entry : m_idle)
+    delete entry.resampler;
+  m_idle.clear();
+}
+
+}
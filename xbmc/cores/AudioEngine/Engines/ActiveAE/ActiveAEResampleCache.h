@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AE.h"
+#include "cores/AudioEngine/Utils/AEChannelInfo.h"
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <map>
+
+extern "C" {
+#include "libavutil/samplefmt.h"
+}
+
+namespace ActiveAE
+{
+
+class IAEResample;
+
+/**
+ * all parameters that go into IAEResample::Init, they identify
+ * a resampler instance that can be shared between streams
+ */
+struct ResampleConfig
+{
+  uint64_t dst_chan_layout = 0;
+  int dst_channels = 0;
+  int dst_rate = 0;
+  AVSampleFormat dst_fmt = AV_SAMPLE_FMT_NONE;
+  int dst_bits = 0;
+  int dst_dither = 0;
+  uint64_t src_chan_layout = 0;
+  int src_channels = 0;
+  int src_rate = 0;
+  AVSampleFormat src_fmt = AV_SAMPLE_FMT_NONE;
+  int src_bits = 0;
+  int src_dither = 0;
+  bool upmix = false;
+  bool normalize = true;
+  bool remap = false;
+  CAEChannelInfo remapLayout;
+  AEQuality quality = AE_QUALITY_UNKNOWN;
+  bool force_resample = false;
+  uint32_t factoryFlags = 0;
+
+  bool operator<(const ResampleConfig &rhs) const;
+};
+
+/**
+ * keeps initialised resamplers that are not in use. Creating a resampler
+ * includes setting up filters and the downmix matrix, on track changes and
+ * gui sounds the same configurations are requested over and over again.
+ * The number of idle instances is bounded, least recently used ones are
+ * dropped first.
+ */
+class CActiveAEResampleCache
+{
+public:
+  static CActiveAEResampleCache& GetInstance();
+
+  /**
+   * returns an initialised resampler for the given configuration, either
+   * a reset idle instance or a newly created one
+   */
+  IAEResample* Acquire(const ResampleConfig &config);
+
+  /**
+   * hand back a resampler obtained by Acquire, the instance is reset
+   * and kept for reuse or deleted if it can't be reset
+   */
+  void Release(IAEResample *resampler);
+
+  /**
+   * delete all idle instances
+   */
+  void Clear();
+
+protected:
+  CActiveAEResampleCache() = default;
+  ~CActiveAEResampleCache();
+  CActiveAEResampleCache(const CActiveAEResampleCache&) = delete;
+  CActiveAEResampleCache& operator=(const CActiveAEResampleCache&) = delete;
+
+  struct IdleEntry
+  {
+    ResampleConfig config;
+    IAEResample *resampler;
+  };
+
+  CCriticalSection m_lock;
+  std::list<IdleEntry> m_idle; // most recently used in front
+  std::map<IAEResample*, ResampleConfig> m_inUse;
+  static const unsigned int MAX_IDLE = 8;
+};
+
+}
@@ -24,6 +24,7 @@
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
+#include "cores/AudioEngine/Utils/AETelemetry.h"
 #include "utils/EndianSwap.h"
 #include "ActiveAE.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
@@ -49,6 +50,10 @@ CActiveAESink::CActiveAESink(CEvent *inMsgEvent) :
   m_volume = 0.0;
   m_packer = nullptr;
   m_streamNoise = true;
+  m_telemetryWriteTime = 0;
+  m_telemetryDelay = 0.0;
+  m_telemetryAudio = false;
+  m_telemetryCacheTotal = 0.0;
 }
 
 void CActiveAESink::Start()
@@ -875,6 +880,13 @@ void CActiveAESink::OpenSink()
   CLog::Log(LOGDEBUG, "  Frames        : %d", m_sinkFormat.m_frames);
   CLog::Log(LOGDEBUG, "  Frame Size    : %d", m_sinkFormat.m_frameSize);
 
+  CAETelemetry &telemetry = CAETelemetry::GetInstance();
+  telemetry.Reset();
+  telemetry.SetSinkName(std::string(m_sink->GetName()) + ":" + m_deviceFriendlyName);
+  m_telemetryWriteTime = 0;
+  m_telemetryAudio = false;
+  m_telemetryCacheTotal = m_sink->GetCacheTotal();
+
   // init sample of silence
   SampleConfig config;
   config.fmt = CAEUtil::GetAVSampleFormat(m_sinkFormat.m_dataFormat);
@@ -1024,9 +1036,11 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
   while (frames > 0)
   {
     maxFrames = std::min(frames, m_sinkFormat.m_frames);
+    int64_t writeStart = CAETelemetry::Now();
     written = m_sink->AddPackets(buffer, maxFrames, totalFrames - frames);
     if (written == 0)
     {
+      CAETelemetry::GetInstance().AddOverrun();
       Sleep(500*m_sinkFormat.m_frames/m_sinkFormat.m_sampleRate);
       retry++;
       if (retry > 4)
@@ -1057,6 +1071,7 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
     frames -= written;
 
     m_sink->GetDelay(status);
+    UpdateTelemetry(samples, status, writeStart);
 
     if (m_requestedFormat.m_dataFormat != AE_FMT_RAW)
       m_stats->UpdateSinkDelay(status, samples->pool ? written : 0);
@@ -1068,6 +1083,29 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
   return status.delay * 1000;
 }
 
+void CActiveAESink::UpdateTelemetry(CSampleBuffer* samples, const AEDelayStatus &status, int64_t writeStart)
+{
+  CAETelemetry &telemetry = CAETelemetry::GetInstance();
+  int64_t now = CAETelemetry::Now();
+  telemetry.AddTime(CAETelemetry::HISTOGRAM_SINK_WRITE, now - writeStart);
+
+  // while playing audio the sink must not consume more than it had buffered
+  // at the last write. silence or a pause in between resets detection
+  bool audio = samples->pool != nullptr;
+  if (audio && m_telemetryAudio && m_telemetryWriteTime)
+  {
+    int64_t elapsed = writeStart - m_telemetryWriteTime;
+    if (elapsed > static_cast<int64_t>(m_telemetryDelay * 1000000))
+      telemetry.AddUnderrun();
+  }
+  m_telemetryAudio = audio;
+  m_telemetryWriteTime = now;
+  m_telemetryDelay = status.delay;
+
+  if (m_telemetryCacheTotal > 0.0)
+    telemetry.SetBufferLevel(static_cast<float>(m_telemetryDelay / m_telemetryCacheTotal));
+}
+
 void CActiveAESink::SwapInit(CSampleBuffer* samples)
 {
   if ((m_requestedFormat.m_dataFormat == AE_FMT_RAW) && CAEUtil::S16NeedsByteSwap(AE_FMT_S16NE, m_sinkFormat.m_dataFormat))
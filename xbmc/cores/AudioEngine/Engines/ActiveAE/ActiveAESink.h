@@ -119,6 +119,7 @@ protected:
   void SwapInit(CSampleBuffer* samples);
 
   void GenerateNoise();
+  void UpdateTelemetry(CSampleBuffer* samples, const AEDelayStatus &status, int64_t writeStart);
 
   CEvent m_outMsgEvent;
   CEvent *m_inMsgEvent;
@@ -152,6 +153,12 @@ protected:
   CAEBitstreamPacker *m_packer;
   bool m_needIecPack;
   bool m_streamNoise;
+
+  // state for detecting underruns, see UpdateTelemetry
+  int64_t m_telemetryWriteTime;
+  double m_telemetryDelay;
+  bool m_telemetryAudio;
+  double m_telemetryCacheTotal;
 };
 
 }
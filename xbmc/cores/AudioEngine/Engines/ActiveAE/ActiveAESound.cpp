@@ -36,8 +36,6 @@ CActiveAESound::CActiveAESound(const std::string &filename, CActiveAE *ae) :
   m_volume         (1.0f    ),
   m_channel        (AE_CH_NULL)
 {
-  m_orig_sound = NULL;
-  m_dst_sound = NULL;
   m_pFile = NULL;
   m_isSeekPossible = false;
   m_fileSize = 0;
@@ -47,8 +45,6 @@ CActiveAESound::CActiveAESound(const std::string &filename, CActiveAE *ae) :
 
 CActiveAESound::~CActiveAESound()
 {
-  delete m_orig_sound;
-  delete m_dst_sound;
   Finish();
 }
 
@@ -71,49 +67,48 @@ bool CActiveAESound::IsPlaying()
 
 uint8_t** CActiveAESound::InitSound(bool orig, SampleConfig config, int nb_samples)
 {
-  CSoundPacket **info;
-  if (orig)
-    info = &m_orig_sound;
-  else
-    info = &m_dst_sound;
+  std::shared_ptr<CSoundPacket> &info = orig ? m_orig_sound : m_dst_sound;
 
-  delete *info;
-  *info = new CSoundPacket(config, nb_samples);
+  info = std::make_shared<CSoundPacket>(config, nb_samples);
 
-  (*info)->nb_samples = 0;
+  info->nb_samples = 0;
   m_isConverted = false;
-  return (*info)->data;
+  return info->data;
 }
 
 bool CActiveAESound::StoreSound(bool orig, uint8_t **buffer, int samples, int linesize)
 {
-  CSoundPacket **info;
-  if (orig)
-    info = &m_orig_sound;
-  else
-    info = &m_dst_sound;
+  std::shared_ptr<CSoundPacket> &info = orig ? m_orig_sound : m_dst_sound;
 
-  if ((*info)->nb_samples + samples > (*info)->max_nb_samples)
+  if (info->nb_samples + samples > info->max_nb_samples)
   {
     CLog::Log(LOGERROR, "CActiveAESound::StoreSound - exceeded max samples");
     return false;
   }
 
-  int bytes_to_copy = samples * (*info)->bytes_per_sample * (*info)->config.channels;
-  bytes_to_copy /= (*info)->planes;
-  int start = (*info)->nb_samples * (*info)->bytes_per_sample * (*info)->config.channels;
-  start /= (*info)->planes;
+  int bytes_to_copy = samples * info->bytes_per_sample * info->config.channels;
+  bytes_to_copy /= info->planes;
+  int start = info->nb_samples * info->bytes_per_sample * info->config.channels;
+  start /= info->planes;
 
-  for (int i=0; i<(*info)->planes; i++)
+  for (int i=0; i<info->planes; i++)
   {
-    memcpy((*info)->data[i]+start, buffer[i], bytes_to_copy);
+    memcpy(info->data[i]+start, buffer[i], bytes_to_copy);
   }
-  (*info)->nb_samples += samples;
+  info->nb_samples += samples;
 
   return true;
 }
 
 CSoundPacket *CActiveAESound::GetSound(bool orig)
+{
+  if (orig)
+    return m_orig_sound.get();
+  else
+    return m_dst_sound.get();
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESound::GetSharedSound(bool orig)
 {
   if (orig)
     return m_orig_sound;
@@ -121,6 +116,17 @@ CSoundPacket *CActiveAESound::GetSound(bool orig)
     return m_dst_sound;
 }
 
+void CActiveAESound::SetSound(bool orig, std::shared_ptr<CSoundPacket> sound)
+{
+  if (orig)
+  {
+    m_orig_sound = std::move(sound);
+    m_isConverted = false;
+  }
+  else
+    m_dst_sound = std::move(sound);
+}
+
 bool CActiveAESound::Prepare()
 {
   unsigned int flags = READ_TRUNCATED | READ_CHUNKED;
@@ -0,0 +1,215 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAESoundCache.h"
+#include "ActiveAEResampleCache.h"
+#include "cores/AudioEngine/AEResampleFactory.h"
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+namespace ActiveAE
+{
+
+CActiveAESoundCache& CActiveAESoundCache::GetInstance()
+{
+  static CActiveAESoundCache instance;
+  return instance;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::GetDecoded(const std::string &filename)
+{
+  CSingleLock lock(m_lock);
+  auto it = m_decoded.find(filename);
+  if (it == m_decoded.end())
+    return nullptr;
+
+  it->second.lastUsed = ++m_useCounter;
+  return it->second.packet;
+}
+
+void CActiveAESoundCache::StoreDecoded(const std::string &filename, const std::shared_ptr<CSoundPacket> &sound)
+{
+  if (!sound)
+    return;
+
+  CSingleLock lock(m_lock);
+  CacheEntry &entry = m_decoded[filename];
+  m_size -= GetPacketSize(entry.packet);
+  entry.packet = sound;
+  entry.lastUsed = ++m_useCounter;
+  m_size += GetPacketSize(entry.packet);
+  Evict();
+}
+
+bool CActiveAESoundCache::GetConverted(const std::string &filename,
+                                       const std::shared_ptr<CSoundPacket> &orig,
+                                       const SampleConfig &dstConfig,
+                                       const CAEChannelInfo &remapLayout,
+                                       AEQuality quality,
+                                       std::shared_ptr<CSoundPacket> &converted)
+{
+  std::string key = filename + "|" +
+                    std::to_string(dstConfig.channel_layout) + "|" +
+                    std::to_string(dstConfig.channels) + "|" +
+                    std::to_string(dstConfig.sample_rate) + "|" +
+                    std::to_string(dstConfig.fmt) + "|" +
+                    std::to_string(dstConfig.bits_per_sample) + "|" +
+                    std::to_string(dstConfig.dither_bits) + "|" +
+                    static_cast<std::string>(remapLayout) + "|" +
+                    std::to_string(quality);
+
+  CSingleLock lock(m_lock);
+  auto it = m_converted.find(key);
+  if (it != m_converted.end())
+  {
+    if (it->second.pending)
+      return false;
+
+    it->second.lastUsed = ++m_useCounter;
+    converted = it->second.packet;
+    return true;
+  }
+
+  CacheEntry &entry = m_converted[key];
+  entry.pending = true;
+  entry.lastUsed = ++m_useCounter;
+
+  CJobManager::GetInstance().Submit([this, key, orig, dstConfig, remapLayout, quality]() {
+    OnConverted(key, Convert(orig, dstConfig, remapLayout, quality));
+  }, CJob::PRIORITY_HIGH);
+
+  return false;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::Convert(const std::shared_ptr<CSoundPacket> &orig,
+                                                           const SampleConfig &dstConfig,
+                                                           const CAEChannelInfo &remapLayout,
+                                                           AEQuality quality)
+{
+  if (!orig)
+    return nullptr;
+
+  const SampleConfig &origConfig = orig->config;
+
+  ResampleConfig config;
+  config.dst_chan_layout = dstConfig.channel_layout;
+  config.dst_channels = dstConfig.channels;
+  config.dst_rate = dstConfig.sample_rate;
+  config.dst_fmt = dstConfig.fmt;
+  config.dst_bits = dstConfig.bits_per_sample;
+  config.dst_dither = dstConfig.dither_bits;
+  config.src_chan_layout = origConfig.channel_layout;
+  config.src_channels = origConfig.channels;
+  config.src_rate = origConfig.sample_rate;
+  config.src_fmt = origConfig.fmt;
+  config.src_bits = origConfig.bits_per_sample;
+  config.src_dither = origConfig.dither_bits;
+  config.upmix = false;
+  config.normalize = true;
+  config.remap = remapLayout.Count() > 0;
+  config.remapLayout = remapLayout;
+  config.quality = quality;
+  config.force_resample = false;
+  config.factoryFlags = AERESAMPLEFACTORY_QUICK_RESAMPLE;
+
+  CActiveAEResampleCache &resampleCache = CActiveAEResampleCache::GetInstance();
+  IAEResample *resampler = resampleCache.Acquire(config);
+
+  int dst_samples = resampler->CalcDstSampleCount(orig->nb_samples,
+                                                  dstConfig.sample_rate,
+                                                  origConfig.sample_rate);
+
+  std::shared_ptr<CSoundPacket> converted = std::make_shared<CSoundPacket>(dstConfig, dst_samples);
+  if (!converted->data)
+  {
+    resampleCache.Release(resampler);
+    return nullptr;
+  }
+
+  int samples = resampler->Resample(converted->data, dst_samples,
+                                    orig->data, orig->nb_samples, 1.0);
+  resampleCache.Release(resampler);
+
+  if (samples < 0)
+  {
+    CLog::Log(LOGERROR, "CActiveAESoundCache::Convert - resampling failed");
+    return nullptr;
+  }
+
+  converted->nb_samples = samples;
+  return converted;
+}
+
+void CActiveAESoundCache::OnConverted(const std::string &key, std::shared_ptr<CSoundPacket> packet)
+{
+  CSingleLock lock(m_lock);
+  if (!packet)
+  {
+    // don't keep the failure, the next request tries again
+    m_converted.erase(key);
+    return;
+  }
+
+  CacheEntry &entry = m_converted[key];
+  entry.packet = std::move(packet);
+  entry.pending = false;
+  m_size += GetPacketSize(entry.packet);
+  Evict();
+}
+
+void CActiveAESoundCache::Evict()
+{
+  while (m_size > m_maxSize)
+  {
+    // only entries nobody else holds on to can go
+    std::map<std::string, CacheEntry> *oldestMap = nullptr;
+    std::map<std::string, CacheEntry>::iterator oldest;
+    for (auto map : { &m_decoded, &m_converted })
+    {
+      for (auto it = map->begin(); it != map->end(); ++it)
+      {
+        if (it->second.pending || it->second.packet.use_count() > 1)
+          continue;
+        if (!oldestMap || it->second.lastUsed < oldest->second.lastUsed)
+        {
+          oldestMap = map;
+          oldest = it;
+        }
+      }
+    }
+
+    if (!oldestMap)
+      break;
+
+    m_size -= GetPacketSize(oldest->second.packet);
+    oldestMap->erase(oldest);
+  }
+}
+
+size_t CActiveAESoundCache::GetPacketSize(const std::shared_ptr<CSoundPacket> &packet)
+{
+  if (!packet)
+    return 0;
+  return static_cast<size_t>(packet->linesize) * packet->planes;
+}
+
+}
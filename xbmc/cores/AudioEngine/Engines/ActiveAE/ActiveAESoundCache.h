@@ -0,0 +1,93 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include "ActiveAEBuffer.h"
+#include "cores/AudioEngine/Utils/AEChannelInfo.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace ActiveAE
+{
+
+/**
+ * decoded gui sounds shared between all sound objects, together with their
+ * versions converted to the formats the engine has asked for.
+ * Conversion runs on a worker so that the engine thread never waits for it.
+ * Entries that are not referenced by a sound anymore are dropped, least
+ * recently used first, once the cache exceeds its size limit.
+ */
+class CActiveAESoundCache
+{
+public:
+  static CActiveAESoundCache& GetInstance();
+
+  /**
+   * returns the decoded sound of a file or nullptr if it is not cached
+   */
+  std::shared_ptr<CSoundPacket> GetDecoded(const std::string &filename);
+  void StoreDecoded(const std::string &filename, const std::shared_ptr<CSoundPacket> &sound);
+
+  /**
+   * look up a sound converted to dstConfig. If it is not available the
+   * conversion is scheduled and false returned, the caller should ask again later.
+   * A failed conversion is not cached, asking again schedules it anew.
+   * returns true if the converted sound is available
+   */
+  bool GetConverted(const std::string &filename,
+                    const std::shared_ptr<CSoundPacket> &orig,
+                    const SampleConfig &dstConfig,
+                    const CAEChannelInfo &remapLayout,
+                    AEQuality quality,
+                    std::shared_ptr<CSoundPacket> &converted);
+
+protected:
+  explicit CActiveAESoundCache(size_t maxSize = MAX_SIZE) : m_maxSize(maxSize) {}
+  CActiveAESoundCache(const CActiveAESoundCache&) = delete;
+  CActiveAESoundCache& operator=(const CActiveAESoundCache&) = delete;
+
+  struct CacheEntry
+  {
+    std::shared_ptr<CSoundPacket> packet;
+    bool pending = false;
+    unsigned int lastUsed = 0;
+  };
+
+  static std::shared_ptr<CSoundPacket> Convert(const std::shared_ptr<CSoundPacket> &orig,
+                                               const SampleConfig &dstConfig,
+                                               const CAEChannelInfo &remapLayout,
+                                               AEQuality quality);
+  void OnConverted(const std::string &key, std::shared_ptr<CSoundPacket> packet);
+  void Evict();
+  static size_t GetPacketSize(const std::shared_ptr<CSoundPacket> &packet);
+
+  CCriticalSection m_lock;
+  std::map<std::string, CacheEntry> m_decoded;
+  std::map<std::string, CacheEntry> m_converted;
+  size_t m_size = 0;
+  unsigned int m_useCounter = 0;
+  const size_t m_maxSize;
+  static const size_t MAX_SIZE = 16 * 1024 * 1024;
+};
+
+}
@@ -0,0 +1,103 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleCache.h"
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+using namespace ActiveAE;
+
+namespace
+{
+ResampleConfig StereoConfig(int srcRate)
+{
+  ResampleConfig config;
+  config.dst_chan_layout = AV_CH_LAYOUT_STEREO;
+  config.dst_channels = 2;
+  config.dst_rate = 48000;
+  config.dst_fmt = AV_SAMPLE_FMT_FLT;
+  config.dst_bits = 32;
+  config.src_chan_layout = AV_CH_LAYOUT_STEREO;
+  config.src_channels = 2;
+  config.src_rate = srcRate;
+  config.src_fmt = AV_SAMPLE_FMT_S16;
+  config.src_bits = 16;
+  config.quality = AE_QUALITY_MID;
+  return config;
+}
+
+bool Equivalent(const ResampleConfig &lhs, const ResampleConfig &rhs)
+{
+  return !(lhs < rhs) && !(rhs < lhs);
+}
+}
+
+TEST(TestActiveAEResampleCache, ConfigOrdering)
+{
+  ResampleConfig a = StereoConfig(44100);
+  ResampleConfig b = StereoConfig(44100);
+  EXPECT_TRUE(Equivalent(a, b));
+
+  b.src_rate = 48000;
+  EXPECT_FALSE(Equivalent(a, b));
+
+  // the remap layout only matters when remapping
+  b = a;
+  b.remapLayout += AE_CH_FC;
+  EXPECT_TRUE(Equivalent(a, b));
+  a.remap = b.remap = true;
+  EXPECT_FALSE(Equivalent(a, b));
+}
+
+TEST(TestActiveAEResampleCache, ReuseByConfig)
+{
+  CActiveAEResampleCache &cache = CActiveAEResampleCache::GetInstance();
+  cache.Clear();
+
+  IAEResample *first = cache.Acquire(StereoConfig(44100));
+  ASSERT_NE(nullptr, first);
+  IAEResample *other = cache.Acquire(StereoConfig(44100));
+  ASSERT_NE(nullptr, other);
+  // an instance in use is never handed out twice
+  EXPECT_NE(first, other);
+  cache.Release(other);
+
+  // the most recently released instance is reused first
+  cache.Release(first);
+  IAEResample *reused = cache.Acquire(StereoConfig(44100));
+  EXPECT_EQ(first, reused);
+
+  // a different configuration doesn't pick up the idle instance
+  IAEResample *resampler = cache.Acquire(StereoConfig(22050));
+  ASSERT_NE(nullptr, resampler);
+  EXPECT_NE(reused, resampler);
+  cache.Release(resampler);
+  EXPECT_EQ(resampler, cache.Acquire(StereoConfig(22050)));
+
+  cache.Release(resampler);
+  cache.Release(reused);
+  cache.Clear();
+}
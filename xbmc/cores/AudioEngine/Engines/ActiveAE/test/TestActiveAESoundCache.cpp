@@ -0,0 +1,166 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESoundCache.h"
+#include "threads/SingleLock.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+using namespace ActiveAE;
+
+namespace
+{
+class CTestSoundCache : public CActiveAESoundCache
+{
+public:
+  explicit CTestSoundCache(size_t maxSize) : CActiveAESoundCache(maxSize) {}
+
+  size_t ConvertedCount()
+  {
+    CSingleLock lock(m_lock);
+    return m_converted.size();
+  }
+
+  // conversion runs on a worker, ask until it is done
+  bool WaitForConverted(const std::string &filename, const std::shared_ptr<CSoundPacket> &orig,
+                        const SampleConfig &dstConfig, std::shared_ptr<CSoundPacket> &converted)
+  {
+    for (int i = 0; i < 500; i++)
+    {
+      if (GetConverted(filename, orig, dstConfig, CAEChannelInfo(), AE_QUALITY_MID, converted))
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+  bool WaitForNoConverted()
+  {
+    for (int i = 0; i < 500 && ConvertedCount() > 0; i++)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return ConvertedCount() == 0;
+  }
+};
+
+SampleConfig StereoConfig(AVSampleFormat fmt, int bits, int sampleRate)
+{
+  SampleConfig config;
+  config.fmt = fmt;
+  config.channel_layout = AV_CH_LAYOUT_STEREO;
+  config.channels = 2;
+  config.sample_rate = sampleRate;
+  config.bits_per_sample = bits;
+  config.dither_bits = 0;
+  return config;
+}
+
+std::shared_ptr<CSoundPacket> MakeSound(int samples)
+{
+  std::shared_ptr<CSoundPacket> sound = std::make_shared<CSoundPacket>(StereoConfig(AV_SAMPLE_FMT_S16, 16, 44100), samples);
+  sound->nb_samples = samples;
+  memset(sound->data[0], 0, sound->linesize);
+  return sound;
+}
+}
+
+TEST(TestActiveAESoundCache, DecodedSoundsAreShared)
+{
+  CTestSoundCache cache(1024 * 1024);
+  EXPECT_EQ(nullptr, cache.GetDecoded("click.wav"));
+
+  std::shared_ptr<CSoundPacket> sound = MakeSound(100);
+  cache.StoreDecoded("click.wav", sound);
+  EXPECT_EQ(sound, cache.GetDecoded("click.wav"));
+  EXPECT_EQ(nullptr, cache.GetDecoded("back.wav"));
+}
+
+TEST(TestActiveAESoundCache, ConversionsAreKeyedByFormat)
+{
+  CTestSoundCache cache(1024 * 1024);
+  std::shared_ptr<CSoundPacket> sound = MakeSound(441);
+  const SampleConfig floatConfig = StereoConfig(AV_SAMPLE_FMT_FLT, 32, 48000);
+
+  std::shared_ptr<CSoundPacket> converted;
+  ASSERT_TRUE(cache.WaitForConverted("click.wav", sound, floatConfig, converted));
+  ASSERT_NE(nullptr, converted);
+  EXPECT_EQ(AV_SAMPLE_FMT_FLT, converted->config.fmt);
+  EXPECT_EQ(48000, converted->config.sample_rate);
+
+  // the same format is served from the cache
+  std::shared_ptr<CSoundPacket> again;
+  EXPECT_TRUE(cache.GetConverted("click.wav", sound, floatConfig, CAEChannelInfo(), AE_QUALITY_MID, again));
+  EXPECT_EQ(converted, again);
+
+  // another rate or another file is converted separately
+  std::shared_ptr<CSoundPacket> other;
+  ASSERT_TRUE(cache.WaitForConverted("click.wav", sound, StereoConfig(AV_SAMPLE_FMT_FLT, 32, 44100), other));
+  EXPECT_NE(converted, other);
+  EXPECT_EQ(44100, other->config.sample_rate);
+  ASSERT_TRUE(cache.WaitForConverted("back.wav", sound, floatConfig, other));
+  EXPECT_NE(converted, other);
+  EXPECT_EQ(3u, cache.ConvertedCount());
+}
+
+TEST(TestActiveAESoundCache, FailedConversionIsNotCached)
+{
+  CTestSoundCache cache(1024 * 1024);
+  std::shared_ptr<CSoundPacket> converted;
+  EXPECT_FALSE(cache.GetConverted("missing.wav", nullptr, StereoConfig(AV_SAMPLE_FMT_FLT, 32, 48000),
+                                  CAEChannelInfo(), AE_QUALITY_MID, converted));
+  EXPECT_TRUE(cache.WaitForNoConverted());
+}
+
+TEST(TestActiveAESoundCache, EvictsUnreferencedSounds)
+{
+  std::shared_ptr<CSoundPacket> first = MakeSound(1000);
+  std::shared_ptr<CSoundPacket> second = MakeSound(1000);
+  std::shared_ptr<CSoundPacket> third = MakeSound(1000);
+  const size_t size = static_cast<size_t>(first->linesize) * first->planes;
+
+  // room for two sounds
+  CTestSoundCache cache(size * 2);
+  cache.StoreDecoded("first.wav", first);
+  cache.StoreDecoded("second.wav", second);
+  cache.GetDecoded("first.wav");
+
+  // everything is referenced, nothing can go
+  cache.StoreDecoded("third.wav", third);
+  EXPECT_EQ(first, cache.GetDecoded("first.wav"));
+  EXPECT_EQ(second, cache.GetDecoded("second.wav"));
+  EXPECT_EQ(third, cache.GetDecoded("third.wav"));
+
+  // once the sounds are released the least recently used one goes on the next store
+  second.reset();
+  third.reset();
+  cache.GetDecoded("third.wav");
+  cache.StoreDecoded("first.wav", first);
+  EXPECT_EQ(nullptr, cache.GetDecoded("second.wav"));
+  EXPECT_NE(nullptr, cache.GetDecoded("third.wav"));
+  EXPECT_EQ(first, cache.GetDecoded("first.wav"));
+}
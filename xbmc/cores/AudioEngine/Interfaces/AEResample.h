@@ -43,6 +43,9 @@ public:
   virtual int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate) = 0;
   virtual int GetSrcBufferSize(int samples) = 0;
   virtual int GetDstBufferSize(int samples) = 0;
+  /* drop buffered samples and compensation state but keep the configuration
+   * passed to Init, returns false if the instance can't be reused */
+  virtual bool Reset() { return false; }
 };
 
 }
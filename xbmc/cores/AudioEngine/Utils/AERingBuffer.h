@@ -27,24 +27,39 @@
 //#define AE_RING_BUFFER_DEBUG
 
 #include "utils/log.h"  //CLog
+#include <atomic>
 #include <string.h>     //memset, memcpy
 #ifdef TARGET_POSIX
 #include "linux/XMemUtils.h"
 #endif
 
 /**
- * This buffer can be used by one read and one write thread at any one time
- * without the risk of data corruption.
+ * Wait-free ring buffer for exactly one write and one read thread.
+ * Each side owns its position, the other side only sees the total
+ * number of bytes written or read which is published with release /
+ * acquire semantics once all planes have been processed.
+ * The counters live on different cache lines so that the producer and
+ * the consumer (usually a sink callback thread) don't stall each other.
  * If you intend to call the Reset() method, please use Locks.
  * All other operations are thread-safe.
  */
 class AERingBuffer {
 
 public:
+  /**
+   * up to two contiguous memory areas of a plane, the second one
+   * is used when the area wraps around the end of the buffer
+   */
+  struct Segments
+  {
+    unsigned char *ptr[2];
+    unsigned int size[2];
+  };
+
   AERingBuffer() :
     m_iReadPos(0),
-    m_iWritePos(0),
     m_iRead(0),
+    m_iWritePos(0),
     m_iWritten(0),
     m_iSize(0),
     m_planes(0),
@@ -54,8 +69,8 @@ public:
 
   AERingBuffer(unsigned int size, unsigned int planes = 1) :
     m_iReadPos(0),
-    m_iWritePos(0),
     m_iRead(0),
+    m_iWritePos(0),
     m_iWritten(0),
     m_iSize(0),
     m_planes(0),
@@ -88,9 +103,9 @@ public:
       if (!m_Buffer[i])
         return false;
       memset(m_Buffer[i], 0, size);
+      m_planes = i + 1;
     }
     m_iSize = size;
-    m_planes = planes;
     return true;
   }
 
@@ -103,14 +118,15 @@ public:
 #ifdef AE_RING_BUFFER_DEBUG
     CLog::Log(LOGDEBUG, "AERingBuffer::Reset: Buffer reset.");
 #endif
-    m_iWritten = 0;
-    m_iRead = 0;
+    m_iWritten.store(0, std::memory_order_relaxed);
+    m_iRead.store(0, std::memory_order_relaxed);
     m_iReadPos = 0;
     m_iWritePos = 0;
   }
 
   /**
-   * Writes data to buffer.
+   * Writes data to one plane of the buffer.
+   * The data becomes visible to the reader once the last plane is written.
    * Attempt to write more bytes than available results in AE_RING_BUFFER_FULL.
    *
    * @return AE_RING_BUFFER_OK on success, otherwise an error code
@@ -123,30 +139,13 @@ public:
     if (size > space || plane >= m_planes)
     {
 #ifdef AE_RING_BUFFER_DEBUG
-    CLog::Log(LOGDEBUG, "AERingBuffer: Not enough space, ignoring data. Requested: %u Available: %u",size, space);
+      CLog::Log(LOGDEBUG, "AERingBuffer: Not enough space, ignoring data. Requested: %u Available: %u",size, space);
 #endif
       return AE_RING_BUFFER_FULL;
     }
 
-    //no wrapping?
-    if ( m_iSize > size + m_iWritePos )
-    {
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Written to: %u size: %u space before: %u\n", m_iWritePos, size, space);
-#endif
-      memcpy(m_Buffer[plane] + m_iWritePos, src, size);
-    }
-    //need to wrap
-    else
-    {
-      unsigned int first = m_iSize - m_iWritePos;
-      unsigned int second = size - first;
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Written to (split) first: %u second: %u size: %u space before: %u\n", first, second, size, space);
-#endif
-      memcpy(m_Buffer[plane] + m_iWritePos, src, first);
-      memcpy(m_Buffer[plane], src + first, second);
-    }
+    CopyIn(plane, src, size);
+
     if (plane + 1 == m_planes)
       WriteFinished(size);
 
@@ -154,7 +153,26 @@ public:
   }
 
   /**
-   * Reads data from buffer.
+   * Writes the same amount of data to all planes at once.
+   * src has to hold one pointer per plane.
+   *
+   * @return AE_RING_BUFFER_OK on success, otherwise an error code
+   */
+  int Write(unsigned char **src, unsigned int size)
+  {
+    if (size > GetWriteSize())
+      return AE_RING_BUFFER_FULL;
+
+    for (unsigned int i = 0; i < m_planes; i++)
+      CopyIn(i, src[i], size);
+
+    WriteFinished(size);
+    return AE_RING_BUFFER_OK;
+  }
+
+  /**
+   * Reads data from one plane of the buffer.
+   * The space is handed back to the writer once the last plane is read.
    * Attempt to read more bytes than available results in RING_BUFFER_NOTAVAILABLE.
    * Reading from empty buffer returns AE_RING_BUFFER_EMPTY
    *
@@ -182,35 +200,77 @@ public:
       return AE_RING_BUFFER_NOTAVAILABLE;
     }
 
-    //no wrapping?
-    if ( size + m_iReadPos < m_iSize )
-    {
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from: %u size: %u space before: %u\n", m_iWritePos, size, space);
-#endif
-      if (dest)
-        memcpy(dest, m_Buffer[plane] + m_iReadPos, size);
-    }
-    //need to wrap
-    else
-    {
-      unsigned int first = m_iSize - m_iReadPos;
-      unsigned int second = size - first;
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from (split) first: %u second: %u size: %u space before: %u\n", first, second, size, space);
-#endif
-      if (dest)
-      {
-        memcpy(dest, m_Buffer[plane] + m_iReadPos, first);
-        memcpy(dest + first, m_Buffer[plane], second);
-      }
-    }
+    if (dest)
+      CopyOut(plane, dest, size);
+
     if (plane + 1 == m_planes)
       ReadFinished(size);
 
     return AE_RING_BUFFER_OK;
   }
 
+  /**
+   * Reads the same amount of data from all planes at once.
+   * dest has to hold one pointer per plane, NULL entries are skipped.
+   *
+   * @return AE_RING_BUFFER_OK on success, otherwise an error code
+   */
+  int Read(unsigned char **dest, unsigned int size)
+  {
+    unsigned int space = GetReadSize();
+    if (space == 0)
+      return AE_RING_BUFFER_EMPTY;
+    if (size > space)
+      return AE_RING_BUFFER_NOTAVAILABLE;
+
+    for (unsigned int i = 0; i < m_planes; i++)
+    {
+      if (dest[i])
+        CopyOut(i, dest[i], size);
+    }
+
+    ReadFinished(size);
+    return AE_RING_BUFFER_OK;
+  }
+
+  /**
+   * Returns the free space of a plane without copying, e.g. for a sink
+   * that renders directly into the buffer. Call CommitWrite when done.
+   *
+   * @return total number of bytes in both segments
+   */
+  unsigned int GetWriteSegments(Segments &segments, unsigned int plane = 0)
+  {
+    return GetSegments(segments, plane, m_iWritePos, GetWriteSize());
+  }
+
+  /**
+   * Makes size bytes of all planes, filled via GetWriteSegments, visible to the reader.
+   */
+  void CommitWrite(unsigned int size)
+  {
+    WriteFinished(size);
+  }
+
+  /**
+   * Returns the readable data of a plane without copying.
+   * Call CommitRead when done.
+   *
+   * @return total number of bytes in both segments
+   */
+  unsigned int GetReadSegments(Segments &segments, unsigned int plane = 0)
+  {
+    return GetSegments(segments, plane, m_iReadPos, GetReadSize());
+  }
+
+  /**
+   * Hands size bytes of all planes back to the writer.
+   */
+  void CommitRead(unsigned int size)
+  {
+    ReadFinished(size);
+  }
+
   /**
    * Dumps the buffer.
    */
@@ -239,7 +299,8 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    return m_iSize - (m_iWritten.load(std::memory_order_relaxed) -
+                      m_iRead.load(std::memory_order_acquire));
   }
 
   /**
@@ -248,7 +309,8 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    return m_iWritten.load(std::memory_order_acquire) -
+           m_iRead.load(std::memory_order_relaxed);
   }
 
   /**
@@ -267,19 +329,77 @@ public:
     return m_planes;
   }
 private:
+  static const unsigned int CACHE_LINE = 64;
+
+  void CopyIn(unsigned int plane, const unsigned char *src, unsigned int size)
+  {
+    unsigned int first = m_iSize - m_iWritePos;
+    //no wrapping?
+    if (size < first)
+      memcpy(m_Buffer[plane] + m_iWritePos, src, size);
+    //need to wrap
+    else
+    {
+#ifdef AE_RING_BUFFER_DEBUG
+      CLog::Log(LOGDEBUG, "AERingBuffer: Written to (split) first: %u second: %u", first, size - first);
+#endif
+      memcpy(m_Buffer[plane] + m_iWritePos, src, first);
+      memcpy(m_Buffer[plane], src + first, size - first);
+    }
+  }
+
+  void CopyOut(unsigned int plane, unsigned char *dest, unsigned int size)
+  {
+    unsigned int first = m_iSize - m_iReadPos;
+    //no wrapping?
+    if (size < first)
+      memcpy(dest, m_Buffer[plane] + m_iReadPos, size);
+    //need to wrap
+    else
+    {
+#ifdef AE_RING_BUFFER_DEBUG
+      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from (split) first: %u second: %u", first, size - first);
+#endif
+      memcpy(dest, m_Buffer[plane] + m_iReadPos, first);
+      memcpy(dest + first, m_Buffer[plane], size - first);
+    }
+  }
+
+  unsigned int GetSegments(Segments &segments, unsigned int plane, unsigned int pos, unsigned int size)
+  {
+    if (plane >= m_planes)
+      size = 0;
+
+    unsigned int first = m_iSize - pos;
+    if (size <= first)
+    {
+      segments.ptr[0] = size ? m_Buffer[plane] + pos : NULL;
+      segments.size[0] = size;
+      segments.ptr[1] = NULL;
+      segments.size[1] = 0;
+    }
+    else
+    {
+      segments.ptr[0] = m_Buffer[plane] + pos;
+      segments.size[0] = first;
+      segments.ptr[1] = m_Buffer[plane];
+      segments.size[1] = size - first;
+    }
+    return size;
+  }
+
   /**
    * Increments the write pointer.
    * Called at the end of writing to all planes.
    */
   void WriteFinished(unsigned int size)
   {
-    if ( m_iSize > size + m_iWritePos )
-      m_iWritePos += size;
-    else // wrapping
-      m_iWritePos = size - (m_iSize - m_iWritePos);
+    m_iWritePos += size;
+    if (m_iWritePos >= m_iSize)
+      m_iWritePos -= m_iSize;
 
-    //we can increase the write count now
-    m_iWritten+=size;
+    //publish the data to the reader
+    m_iWritten.store(m_iWritten.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
   /**
@@ -288,19 +408,24 @@ private:
    */
   void ReadFinished(unsigned int size)
   {
-    if ( size + m_iReadPos < m_iSize )
-      m_iReadPos += size;
-    else
-      m_iReadPos = size - (m_iSize - m_iReadPos);
+    m_iReadPos += size;
+    if (m_iReadPos >= m_iSize)
+      m_iReadPos -= m_iSize;
 
-    //we can increase the read count now
-    m_iRead+=size;
+    //hand the space back to the writer
+    m_iRead.store(m_iRead.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
+  // reader and writer state are kept a full cache line apart
+  // reader side
   unsigned int m_iReadPos;
+  std::atomic<unsigned int> m_iRead;
+  char m_readPad[CACHE_LINE];
+  // writer side
   unsigned int m_iWritePos;
-  unsigned int m_iRead;
-  unsigned int m_iWritten;
+  std::atomic<unsigned int> m_iWritten;
+  char m_writePad[CACHE_LINE];
+  // shared, constant after Create
   unsigned int m_iSize;
   unsigned int m_planes;
   unsigned char **m_Buffer;
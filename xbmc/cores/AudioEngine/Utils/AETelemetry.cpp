@@ -0,0 +1,176 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AETelemetry.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+
+namespace
+{
+// upper bounds of the histogram buckets in microseconds, the last one is open
+const int64_t BucketLimits[CAETelemetry::BUCKETS - 1] = { 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000 };
+
+const char* HistogramNames[CAETelemetry::HISTOGRAM_MAX] = { "enginecycle", "sinkwrite" };
+}
+
+CAETelemetry& CAETelemetry::GetInstance()
+{
+  static CAETelemetry instance;
+  return instance;
+}
+
+CAETelemetry::CAETelemetry()
+{
+  Reset();
+}
+
+int64_t CAETelemetry::Now()
+{
+  return CounterToMicroseconds(CurrentHostCounter(), CurrentHostFrequency());
+}
+
+int64_t CAETelemetry::CounterToMicroseconds(int64_t counter, int64_t frequency)
+{
+  // whole seconds and the remainder separately, as counter * 1000000 overflows
+  // after a few hours of uptime with a nanosecond counter
+  return counter / frequency * 1000000 + counter % frequency * 1000000 / frequency;
+}
+
+void CAETelemetry::Reset()
+{
+  for (int h = 0; h < HISTOGRAM_MAX; h++)
+  {
+    for (int i = 0; i < BUCKETS; i++)
+      m_histograms[h][i] = 0;
+    m_maxTime[h] = 0;
+  }
+  m_underruns = 0;
+  m_overruns = 0;
+  m_bufferLevel = 0;
+  m_resampleTime = 0;
+  m_resetTime = Now();
+}
+
+void CAETelemetry::SetSinkName(const std::string &name)
+{
+  CSingleLock lock(m_nameLock);
+  m_sinkName = name;
+}
+
+void CAETelemetry::AddTime(Histogram histogram, int64_t us)
+{
+  m_histograms[histogram][GetBucket(us)].fetch_add(1, std::memory_order_relaxed);
+
+  int64_t max = m_maxTime[histogram].load(std::memory_order_relaxed);
+  while (us > max && !m_maxTime[histogram].compare_exchange_weak(max, us, std::memory_order_relaxed))
+    ;
+}
+
+void CAETelemetry::SetBufferLevel(float level)
+{
+  m_bufferLevel.store(static_cast<int32_t>(std::max(0.0f, std::min(1.0f, level)) * 1000), std::memory_order_relaxed);
+}
+
+int CAETelemetry::GetBucket(int64_t us)
+{
+  int bucket = 0;
+  while (bucket < BUCKETS - 1 && us > BucketLimits[bucket])
+    bucket++;
+  return bucket;
+}
+
+int64_t CAETelemetry::GetPercentile(Histogram histogram, unsigned int percent) const
+{
+  uint64_t total = 0;
+  for (int i = 0; i < BUCKETS; i++)
+    total += m_histograms[histogram][i].load(std::memory_order_relaxed);
+  if (total == 0)
+    return 0;
+
+  uint64_t wanted = (total * percent + 99) / 100;
+  uint64_t count = 0;
+  for (int i = 0; i < BUCKETS - 1; i++)
+  {
+    count += m_histograms[histogram][i].load(std::memory_order_relaxed);
+    if (count >= wanted)
+      return BucketLimits[i];
+  }
+  return m_maxTime[histogram].load(std::memory_order_relaxed);
+}
+
+void CAETelemetry::Serialize(CVariant &stats) const
+{
+  {
+    CSingleLock lock(m_nameLock);
+    stats["sink"] = m_sinkName;
+  }
+
+  for (int h = 0; h < HISTOGRAM_MAX; h++)
+  {
+    Histogram histogram = static_cast<Histogram>(h);
+    CVariant &value = stats[HistogramNames[h]];
+    value["p50"] = GetPercentile(histogram, 50);
+    value["p99"] = GetPercentile(histogram, 99);
+    value["max"] = m_maxTime[h].load(std::memory_order_relaxed);
+    value["buckets"] = CVariant(CVariant::VariantTypeArray);
+    for (int i = 0; i < BUCKETS; i++)
+    {
+      CVariant bucket;
+      bucket["upto"] = i < BUCKETS - 1 ? BucketLimits[i] : -1;
+      bucket["count"] = m_histograms[h][i].load(std::memory_order_relaxed);
+      value["buckets"].push_back(bucket);
+    }
+  }
+
+  stats["underruns"] = m_underruns.load(std::memory_order_relaxed);
+  stats["overruns"] = m_overruns.load(std::memory_order_relaxed);
+  stats["bufferlevel"] = m_bufferLevel.load(std::memory_order_relaxed) / 10.0;
+
+  int64_t elapsed = Now() - m_resetTime.load(std::memory_order_relaxed);
+  stats["resamplecpu"] = elapsed > 0 ? 100.0 * m_resampleTime.load(std::memory_order_relaxed) / elapsed : 0.0;
+}
+
+std::string CAETelemetry::GetDebugString() const
+{
+  int64_t elapsed = Now() - m_resetTime.load(std::memory_order_relaxed);
+  double resampleCpu = elapsed > 0 ? 100.0 * m_resampleTime.load(std::memory_order_relaxed) / elapsed : 0.0;
+
+  std::string sinkName;
+  {
+    CSingleLock lock(m_nameLock);
+    sinkName = m_sinkName;
+  }
+
+  return StringUtils::Format("AE: cycle p50/p99/max %d/%d/%d us, write p99 %d us\n"
+                             "AE: %s - underruns %u, overruns %u, buffer %2.1f%%, resample %2.2f%%",
+                             static_cast<int>(GetPercentile(HISTOGRAM_ENGINE_CYCLE, 50)),
+                             static_cast<int>(GetPercentile(HISTOGRAM_ENGINE_CYCLE, 99)),
+                             static_cast<int>(m_maxTime[HISTOGRAM_ENGINE_CYCLE].load(std::memory_order_relaxed)),
+                             static_cast<int>(GetPercentile(HISTOGRAM_SINK_WRITE, 99)),
+                             sinkName.c_str(),
+                             m_underruns.load(std::memory_order_relaxed),
+                             m_overruns.load(std::memory_order_relaxed),
+                             m_bufferLevel.load(std::memory_order_relaxed) / 10.0,
+                             resampleCpu);
+}
@@ -0,0 +1,89 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+class CVariant;
+
+/**
+ * Counters about the timing of the audio engine and its sink, cheap enough
+ * to be updated all the time. Writers only touch atomics, the sink name is
+ * the only value guarded by a lock and it changes when a sink is opened.
+ */
+class CAETelemetry
+{
+public:
+  enum Histogram
+  {
+    HISTOGRAM_ENGINE_CYCLE = 0, // time spent in one run of the engine stages
+    HISTOGRAM_SINK_WRITE,       // time a sink took to accept a packet
+    HISTOGRAM_MAX
+  };
+
+  static const int BUCKETS = 11;
+
+  static CAETelemetry& GetInstance();
+
+  /**
+   * current time in microseconds, use for durations passed to AddTime
+   */
+  static int64_t Now();
+
+  /**
+   * convert a host counter value with the given frequency to microseconds
+   */
+  static int64_t CounterToMicroseconds(int64_t counter, int64_t frequency);
+
+  void Reset();
+  void SetSinkName(const std::string &name);
+
+  void AddTime(Histogram histogram, int64_t us);
+  void AddUnderrun() { m_underruns++; }
+  void AddOverrun() { m_overruns++; }
+  void SetBufferLevel(float level);
+  void AddResampleTime(int64_t us) { m_resampleTime += us; }
+
+  void Serialize(CVariant &stats) const;
+  std::string GetDebugString() const;
+
+protected:
+  CAETelemetry();
+  CAETelemetry(const CAETelemetry&) = delete;
+  CAETelemetry& operator=(const CAETelemetry&) = delete;
+
+  static int GetBucket(int64_t us);
+  int64_t GetPercentile(Histogram histogram, unsigned int percent) const;
+
+  std::atomic<uint32_t> m_histograms[HISTOGRAM_MAX][BUCKETS];
+  std::atomic<int64_t> m_maxTime[HISTOGRAM_MAX];
+  std::atomic<uint32_t> m_underruns;
+  std::atomic<uint32_t> m_overruns;
+  std::atomic<int32_t> m_bufferLevel; // per mille
+  std::atomic<int64_t> m_resampleTime;
+  std::atomic<int64_t> m_resetTime;
+
+  mutable CCriticalSection m_nameLock;
+  std::string m_sinkName;
+};
@@ -0,0 +1,158 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestAERingBuffer, WrapAround)
+{
+  AERingBuffer buffer(10);
+  unsigned char in[7] = { 1, 2, 3, 4, 5, 6, 7 };
+  unsigned char out[7];
+
+  EXPECT_EQ(10u, buffer.GetWriteSize());
+  EXPECT_EQ(0, buffer.Write(in, 7));
+  EXPECT_EQ(7u, buffer.GetReadSize());
+  EXPECT_EQ(0, buffer.Read(out, 7));
+  EXPECT_EQ(0, memcmp(in, out, 7));
+
+  // second write wraps at the end of the buffer
+  EXPECT_EQ(0, buffer.Write(in, 7));
+  EXPECT_EQ(2, buffer.Write(in, 4));
+  memset(out, 0, sizeof(out));
+  EXPECT_EQ(0, buffer.Read(out, 7));
+  EXPECT_EQ(0, memcmp(in, out, 7));
+  EXPECT_EQ(1, buffer.Read(out, 1));
+}
+
+TEST(TestAERingBuffer, Planes)
+{
+  AERingBuffer buffer(8, 2);
+  unsigned char left[6] = { 1, 2, 3, 4, 5, 6 };
+  unsigned char right[6] = { 11, 12, 13, 14, 15, 16 };
+  unsigned char outLeft[6], outRight[6];
+
+  // data is visible once the last plane is written
+  EXPECT_EQ(0, buffer.Write(left, 6, 0));
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(0, buffer.Write(right, 6, 1));
+  EXPECT_EQ(6u, buffer.GetReadSize());
+
+  unsigned char *dest[2] = { outLeft, outRight };
+  EXPECT_EQ(0, buffer.Read(dest, 6));
+  EXPECT_EQ(0, memcmp(left, outLeft, 6));
+  EXPECT_EQ(0, memcmp(right, outRight, 6));
+
+  unsigned char *src[2] = { left, right };
+  EXPECT_EQ(0, buffer.Write(src, 6));
+  EXPECT_EQ(0, buffer.Read(outLeft, 6, 0));
+  EXPECT_EQ(6u, buffer.GetReadSize());
+  EXPECT_EQ(0, buffer.Read(outRight, 6, 1));
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(0, memcmp(left, outLeft, 6));
+  EXPECT_EQ(0, memcmp(right, outRight, 6));
+}
+
+TEST(TestAERingBuffer, Segments)
+{
+  AERingBuffer buffer(8);
+  unsigned char in[6] = { 1, 2, 3, 4, 5, 6 };
+  unsigned char out[6];
+  AERingBuffer::Segments segments;
+
+  EXPECT_EQ(0, buffer.Write(in, 6));
+  EXPECT_EQ(0, buffer.Read(out, 6));
+
+  EXPECT_EQ(8u, buffer.GetWriteSegments(segments));
+  EXPECT_EQ(2u, segments.size[0]);
+  EXPECT_EQ(6u, segments.size[1]);
+  memcpy(segments.ptr[0], in, 2);
+  memcpy(segments.ptr[1], in + 2, 4);
+  buffer.CommitWrite(6);
+
+  EXPECT_EQ(6u, buffer.GetReadSegments(segments));
+  EXPECT_EQ(2u, segments.size[0]);
+  EXPECT_EQ(4u, segments.size[1]);
+  EXPECT_EQ(0, memcmp(segments.ptr[0], in, 2));
+  EXPECT_EQ(0, memcmp(segments.ptr[1], in + 2, 4));
+  buffer.CommitRead(6);
+  EXPECT_EQ(0u, buffer.GetReadSize());
+}
+
+TEST(TestAERingBuffer, ConcurrentProducerConsumer)
+{
+  const unsigned int planes = 2;
+  const unsigned int total = 1 << 20;
+  AERingBuffer buffer(1000, planes);
+
+  std::thread producer([&buffer, total]() {
+    std::vector<unsigned char> left(97), right(97);
+    unsigned int written = 0;
+    while (written < total)
+    {
+      unsigned int size = std::min(static_cast<unsigned int>(left.size()), total - written);
+      size = std::min(size, buffer.GetWriteSize());
+      if (!size)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      for (unsigned int i = 0; i < size; i++)
+      {
+        left[i] = static_cast<unsigned char>(written + i);
+        right[i] = static_cast<unsigned char>(~(written + i));
+      }
+      unsigned char *src[planes] = { left.data(), right.data() };
+      buffer.Write(src, size);
+      written += size;
+    }
+  });
+
+  std::vector<unsigned char> left(61), right(61);
+  unsigned int read = 0;
+  unsigned int errors = 0;
+  while (read < total)
+  {
+    unsigned int size = std::min(static_cast<unsigned int>(left.size()), buffer.GetReadSize());
+    if (!size)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    unsigned char *dest[planes] = { left.data(), right.data() };
+    buffer.Read(dest, size);
+    for (unsigned int i = 0; i < size; i++)
+    {
+      if (left[i] != static_cast<unsigned char>(read + i) ||
+          right[i] != static_cast<unsigned char>(~(read + i)))
+        errors++;
+    }
+    read += size;
+  }
+  producer.join();
+
+  EXPECT_EQ(0u, errors);
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(1000u, buffer.GetWriteSize());
+}
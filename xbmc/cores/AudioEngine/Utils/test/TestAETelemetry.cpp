@@ -0,0 +1,34 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AETelemetry.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestAETelemetry, CounterToMicroseconds)
+{
+  // nanosecond counter as on linux
+  EXPECT_EQ(1500000, CAETelemetry::CounterToMicroseconds(1500000000LL, 1000000000LL));
+  // 30 days of uptime, where counter * 1000000 no longer fits in 64 bits
+  int64_t counter = 30LL * 86400 * 1000000000LL + 123456789;
+  EXPECT_EQ(30LL * 86400 * 1000000 + 123456, CAETelemetry::CounterToMicroseconds(counter, 1000000000LL));
+  // 100ns counter as on windows
+  EXPECT_EQ(30LL * 86400 * 1000000 + 7, CAETelemetry::CounterToMicroseconds(30LL * 86400 * 10000000 + 75, 10000000LL));
+}
@@ -23,6 +23,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
@@ -41,6 +42,9 @@
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
+// updates and time (ms) after which a batch transaction is committed
+#define BATCH_MAX_UPDATES 100
+#define BATCH_MAX_DURATION 2000
 
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
@@ -155,6 +159,10 @@ CDatabase::CDatabase(void)
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_batchTransaction = false;
+  m_batchSavepoints = 0;
+  m_batchUpdates = 0;
+  m_batchStart = 0;
 }
 
 CDatabase::~CDatabase(void)
@@ -527,6 +535,9 @@ void CDatabase::Close()
     return;
   }
 
+  if (m_batchTransaction)
+    CommitBatchTransaction();
+
   m_openCount = 0;
   m_multipleExecute = false;
 
@@ -584,7 +595,31 @@ void CDatabase::BeginTransaction()
   try
   {
     if (NULL != m_pDB.get())
-      m_pDB->start_transaction();
+    {
+      if (!m_batchTransaction)
+        m_pDB->start_transaction();
+      else
+      {
+        // the time between updates (e.g. spent on scraper lookups) counts towards the duration
+        // as well, so a batch transaction that has been open for long enough is committed here
+        // rather than only after the next update
+        if (m_pDB->in_transaction() && m_batchSavepoints == 0 &&
+            XbmcThreads::SystemClockMillis() - m_batchStart >= BATCH_MAX_DURATION)
+        {
+          m_pDB->commit_transaction();
+          OnTransactionCommitted();
+        }
+
+        // the batch transaction is only started once there's something to write
+        if (!m_pDB->in_transaction())
+        {
+          m_pDB->start_transaction();
+          m_batchUpdates = 0;
+          m_batchStart = XbmcThreads::SystemClockMillis();
+        }
+        m_pDB->start_savepoint(StringUtils::Format("batch%u", ++m_batchSavepoints));
+      }
+    }
   }
   catch (...)
   {
@@ -597,7 +632,26 @@ bool CDatabase::CommitTransaction()
   try
   {
     if (NULL != m_pDB.get())
-      m_pDB->commit_transaction();
+    {
+      if (!m_batchTransaction)
+      {
+        m_pDB->commit_transaction();
+        OnTransactionCommitted();
+      }
+      else if (m_batchSavepoints > 0)
+      {
+        m_pDB->release_savepoint(StringUtils::Format("batch%u", m_batchSavepoints--));
+
+        // commit every so often so that other connections don't wait on us for too long.
+        // sqlite locks the whole database for writing, so there each update is committed
+        if (m_batchSavepoints == 0 &&
+            (m_sqlite || ++m_batchUpdates >= BATCH_MAX_UPDATES || XbmcThreads::SystemClockMillis() - m_batchStart >= BATCH_MAX_DURATION))
+        {
+          m_pDB->commit_transaction();
+          OnTransactionCommitted();
+        }
+      }
+    }
   }
   catch (...)
   {
@@ -612,7 +666,21 @@ void CDatabase::RollbackTransaction()
   try
   {
     if (NULL != m_pDB.get())
-      m_pDB->rollback_transaction();
+    {
+      if (!m_batchTransaction)
+        m_pDB->rollback_transaction();
+      else if (m_batchSavepoints > 0)
+      {
+        std::string savepoint = StringUtils::Format("batch%u", m_batchSavepoints--);
+        m_pDB->rollback_savepoint(savepoint);
+        m_pDB->release_savepoint(savepoint);
+
+        // don't keep sqlite locked for the rest of the batch. Updates before this one
+        // were committed already, so this commits nothing
+        if (m_batchSavepoints == 0 && m_sqlite)
+          m_pDB->commit_transaction();
+      }
+    }
   }
   catch (...)
   {
@@ -620,6 +688,50 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+void CDatabase::BeginBatchTransaction()
+{
+  if (m_batchTransaction || NULL == m_pDB.get())
+    return;
+
+  m_batchTransaction = true;
+  m_batchSavepoints = 0;
+}
+
+bool CDatabase::FlushBatchTransaction()
+{
+  if (!m_batchTransaction || m_batchSavepoints > 0 || NULL == m_pDB.get())
+    return true;
+
+  try
+  {
+    if (m_pDB->in_transaction())
+    {
+      m_pDB->commit_transaction();
+      OnTransactionCommitted();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "database:flushbatchtransaction failed");
+    return false;
+  }
+  return true;
+}
+
+bool CDatabase::CommitBatchTransaction()
+{
+  if (!m_batchTransaction)
+    return true;
+
+  if (m_batchSavepoints > 0)
+    CLog::Log(LOGWARNING, "%s - %u transactions were left open within the batch", __FUNCTION__, m_batchSavepoints);
+
+  m_batchSavepoints = 0;
+  bool result = FlushBatchTransaction();
+  m_batchTransaction = false;
+  return result;
+}
+
 bool CDatabase::InTransaction()
 {
   if (NULL != m_pDB.get()) return false;
@@ -84,8 +84,33 @@ public:
 
   void BeginTransaction();
   virtual bool CommitTransaction();
-  void RollbackTransaction();
+  virtual void RollbackTransaction();
   bool InTransaction();
+
+  /*! \brief Group the transactions of many small updates into few larger ones.
+   While a batch is open, BeginTransaction(), CommitTransaction() and RollbackTransaction()
+   work on savepoints within the batch transaction, so a failing update still only
+   rolls back its own changes. The batch transaction is committed every so many updates
+   (or so often) to keep other connections from waiting on it for long, and when the
+   batch is ended. As sqlite locks the whole database while writing, there each update
+   is still committed on its own.
+   \sa CommitBatchTransaction
+   */
+  void BeginBatchTransaction();
+
+  /*! \brief Commit the updates made so far within the batch, keeping the batch open.
+   Call this before slow work that doesn't write to the database (e.g. scraper lookups), so
+   the batch transaction isn't held open while it runs. Does nothing while an update within
+   the batch is still in progress.
+   \return true on success, false otherwise.
+   */
+  bool FlushBatchTransaction();
+
+  /*! \brief Commit and end the batch started with BeginBatchTransaction().
+   \return true on success, false otherwise.
+   */
+  virtual bool CommitBatchTransaction();
+  bool InBatchTransaction() const { return m_batchTransaction; }
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -187,6 +212,11 @@ protected:
    */
   bool CreateDatabase();
 
+  /*! \brief Called after changes were committed to the database. Within a batch this is
+   whenever the batch transaction is committed, which may be before the batch ends.
+   */
+  virtual void OnTransactionCommitted() {};
+
   /* \brief Create tables for the current database schema.
    Will be called on database creation.
    */
@@ -231,4 +261,9 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  bool m_batchTransaction;
+  unsigned int m_batchSavepoints; ///< depth of open transactions within the batch
+  unsigned int m_batchUpdates;    ///< updates committed since the batch transaction was started
+  unsigned int m_batchStart;
 };
@@ -147,6 +147,12 @@ public:
   virtual void commit_transaction() {};
   virtual void rollback_transaction() {};
 
+/* virtual methods for savepoints within a transaction */
+
+  virtual void start_savepoint(const std::string &name) {};
+  virtual void release_savepoint(const std::string &name) {};
+  virtual void rollback_savepoint(const std::string &name) {};
+
 /* virtual methods for formatting */
 
   /*! \brief Prepare a SQL statement for execution or querying using C printf nomenclature.
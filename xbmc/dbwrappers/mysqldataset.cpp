@@ -528,6 +528,30 @@ void MysqlDatabase::rollback_transaction() {
   }
 }
 
+void MysqlDatabase::start_savepoint(const std::string &name) {
+  if (active)
+  {
+    std::string sql = "SAVEPOINT " + name;
+    mysql_real_query(conn, sql.c_str(), sql.size());
+  }
+}
+
+void MysqlDatabase::release_savepoint(const std::string &name) {
+  if (active)
+  {
+    std::string sql = "RELEASE SAVEPOINT " + name;
+    mysql_real_query(conn, sql.c_str(), sql.size());
+  }
+}
+
+void MysqlDatabase::rollback_savepoint(const std::string &name) {
+  if (active)
+  {
+    std::string sql = "ROLLBACK TO SAVEPOINT " + name;
+    mysql_real_query(conn, sql.c_str(), sql.size());
+  }
+}
+
 bool MysqlDatabase::exists(void) {
   bool ret = false;
 
@@ -79,6 +79,12 @@ public:
   void commit_transaction() override;
   void rollback_transaction() override;
 
+/* virtual methods for savepoints within a transaction */
+
+  void start_savepoint(const std::string &name) override;
+  void release_savepoint(const std::string &name) override;
+  void rollback_savepoint(const std::string &name) override;
+
 /* virtual methods for formatting */
   std::string vprepare(const char *format, va_list args) override;
 
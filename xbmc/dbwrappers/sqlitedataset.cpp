@@ -411,6 +411,27 @@ void SqliteDatabase::rollback_transaction() {
   }  
 }
 
+void SqliteDatabase::start_savepoint(const std::string &name) {
+  if (active) {
+    std::string sql = "SAVEPOINT " + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
+void SqliteDatabase::release_savepoint(const std::string &name) {
+  if (active) {
+    std::string sql = "RELEASE SAVEPOINT " + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
+void SqliteDatabase::rollback_savepoint(const std::string &name) {
+  if (active) {
+    std::string sql = "ROLLBACK TO SAVEPOINT " + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
 
 // methods for formatting
 // ---------------------------------------------
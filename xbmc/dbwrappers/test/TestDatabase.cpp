@@ -0,0 +1,146 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+class CTestDatabase : public CDatabase
+{
+public:
+  bool Create()
+  {
+    XFILE::CFile::Delete("special://temp/TestBatch1.db");
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    return Connect("TestBatch1", settings, true);
+  }
+
+  void Insert(const std::string &name)
+  {
+    BeginTransaction();
+    m_pDS->exec(PrepareSQL("INSERT INTO item (name) VALUES ('%s')", name.c_str()));
+  }
+
+  // names of all stored items, in order
+  std::string GetCommitted()
+  {
+    std::unique_ptr<dbiplus::Dataset> ds(m_pDB->CreateDataset());
+    ds->query("SELECT name FROM item ORDER BY name");
+    std::string names;
+    while (!ds->eof())
+    {
+      names += ds->fv(0).get_asString();
+      ds->next();
+    }
+    ds->close();
+    return names;
+  }
+
+  bool InDatabaseTransaction() const { return m_pDB->in_transaction(); }
+
+  unsigned int m_commits = 0;
+
+protected:
+  void OnTransactionCommitted() override { m_commits++; }
+
+  void CreateTables() override
+  {
+    m_pDS->exec("CREATE TABLE item (id integer primary key, name text)");
+  }
+  void CreateAnalytics() override {}
+  int GetSchemaVersion() const override { return 1; }
+  const char *GetBaseDBName() const override { return "TestBatch"; }
+};
+
+class TestDatabase : public testing::Test
+{
+protected:
+  TestDatabase()
+  {
+    m_created = m_db.Create();
+    m_db.m_commits = 0;
+  }
+
+  ~TestDatabase() override
+  {
+    m_db.Close();
+    XFILE::CFile::Delete("special://temp/TestBatch1.db");
+  }
+
+  CTestDatabase m_db;
+  bool m_created;
+};
+}
+
+TEST_F(TestDatabase, CommitOutsideBatch)
+{
+  ASSERT_TRUE(m_created);
+  m_db.Insert("a");
+  EXPECT_TRUE(m_db.CommitTransaction());
+  EXPECT_EQ(1u, m_db.m_commits);
+
+  m_db.Insert("b");
+  m_db.RollbackTransaction();
+  EXPECT_EQ(1u, m_db.m_commits);
+  EXPECT_EQ("a", m_db.GetCommitted());
+}
+
+TEST_F(TestDatabase, NestedRollbackWithinBatch)
+{
+  ASSERT_TRUE(m_created);
+  m_db.BeginBatchTransaction();
+
+  m_db.Insert("a");
+  m_db.Insert("b");
+  m_db.RollbackTransaction();
+  EXPECT_EQ(0u, m_db.m_commits);
+  EXPECT_TRUE(m_db.InDatabaseTransaction());
+  EXPECT_TRUE(m_db.CommitTransaction());
+
+  // sqlite commits each outermost update within the batch
+  EXPECT_EQ(1u, m_db.m_commits);
+  EXPECT_FALSE(m_db.InDatabaseTransaction());
+  EXPECT_EQ("a", m_db.GetCommitted());
+
+  // a failed outermost update commits nothing
+  m_db.Insert("c");
+  m_db.RollbackTransaction();
+  EXPECT_EQ(1u, m_db.m_commits);
+
+  m_db.Insert("d");
+  m_db.Insert("e");
+  EXPECT_TRUE(m_db.CommitTransaction());
+  m_db.RollbackTransaction();
+  EXPECT_EQ(1u, m_db.m_commits);
+
+  EXPECT_TRUE(m_db.CommitBatchTransaction());
+  EXPECT_EQ(1u, m_db.m_commits);
+  EXPECT_FALSE(m_db.InBatchTransaction());
+  EXPECT_EQ("a", m_db.GetCommitted());
+}
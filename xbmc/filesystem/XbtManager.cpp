@@ -24,6 +24,7 @@
 
 #include "guilib/XBTF.h"
 #include "guilib/XBTFReader.h"
+#include "threads/SingleLock.h"
 #include "URL.h"
 
 namespace XFILE
@@ -41,11 +42,13 @@ CXbtManager& CXbtManager::GetInstance()
 
 bool CXbtManager::HasFiles(const CURL& path) const
 {
+  CSingleLock lock(m_section);
   return ProcessFile(path) != m_readers.end();
 }
 
 bool CXbtManager::GetFiles(const CURL& path, std::vector<CXBTFFile>& files) const
 {
+  CSingleLock lock(m_section);
   const auto& reader = ProcessFile(path);
   if (reader == m_readers.end())
     return false;
@@ -56,6 +59,7 @@ bool CXbtManager::GetFiles(const CURL& path, std::vector<CXBTFFile>& files) cons
 
 bool CXbtManager::GetReader(const CURL& path, CXBTFReaderPtr& reader) const
 {
+  CSingleLock lock(m_section);
   const auto& it = ProcessFile(path);
   if (it == m_readers.end())
     return false;
@@ -66,6 +70,7 @@ bool CXbtManager::GetReader(const CURL& path, CXBTFReaderPtr& reader) const
 
 void CXbtManager::Release(const CURL& path)
 {
+  CSingleLock lock(m_section);
   const auto& it = GetReader(path);
   if (it == m_readers.end())
     return;
@@ -91,10 +96,7 @@ void CXbtManager::RemoveReader(XBTFReaders::iterator readerIterator) const
   if (readerIterator == m_readers.end())
     return;
 
-  // close the reader
-  readerIterator->second.reader->Close();
-
-  // and remove it from the map
+  // remove it from the map, the reader is closed once the last texture loader using it lets go
   m_readers.erase(readerIterator);
 }
 
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "guilib/XBTFReader.h"
+#include "threads/CriticalSection.h"
 
 class CURL;
 class CXBTFFile;
@@ -65,5 +66,6 @@ private:
   static std::string NormalizePath(const CURL& path);
 
   mutable XBTFReaders m_readers;
+  mutable CCriticalSection m_section; ///< texture bundles are opened from the render thread and the texture loaders
 };
 }
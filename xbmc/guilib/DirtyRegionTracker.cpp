@@ -21,13 +21,22 @@
 #include "DirtyRegionTracker.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
+#include <algorithm>
+#include <cmath>
 #include <stdio.h>
 #include "DirtyRegionSolvers.h"
 
+#define DIRTYREGION_CELL_SIZE 32
+#define DIRTYREGION_MAX_CELLS 256 // per axis, regions past this are clamped to the last cell
+#define DIRTYREGION_CELL_CLEAN 0xFF
+
 CDirtyRegionTracker::CDirtyRegionTracker(int buffering)
 {
   m_buffering = buffering;
   m_solver = NULL;
+  m_columns = 0;
+  m_rows = 0;
+  m_dirtyCells = 0;
 }
 
 CDirtyRegionTracker::~CDirtyRegionTracker()
@@ -61,10 +70,46 @@ void CDirtyRegionTracker::SelectAlgorithm()
   }
 }
 
+void CDirtyRegionTracker::GrowGrid(int columns, int rows)
+{
+  columns = std::max(columns, m_columns);
+  rows = std::max(rows, m_rows);
+  if (columns == m_columns && rows == m_rows)
+    return;
+
+  std::vector<unsigned char> cells(columns * rows, DIRTYREGION_CELL_CLEAN);
+  for (int y = 0; y < m_rows; y++)
+    std::copy(m_cells.begin() + y * m_columns, m_cells.begin() + (y + 1) * m_columns, cells.begin() + y * columns);
+
+  m_cells.swap(cells);
+  m_columns = columns;
+  m_rows = rows;
+}
+
 void CDirtyRegionTracker::MarkDirtyRegion(const CDirtyRegion &region)
 {
-  if (!region.IsEmpty())
+  if (region.IsEmpty())
+    return;
+
+  if (g_advancedSettings.m_guiVisualizeDirtyRegions)
     m_markedRegions.push_back(region);
+
+  int x1 = std::min(std::max((int)std::floor(region.x1 / DIRTYREGION_CELL_SIZE), 0), DIRTYREGION_MAX_CELLS - 1);
+  int y1 = std::min(std::max((int)std::floor(region.y1 / DIRTYREGION_CELL_SIZE), 0), DIRTYREGION_MAX_CELLS - 1);
+  int x2 = std::min(std::max((int)std::ceil(region.x2 / DIRTYREGION_CELL_SIZE), x1 + 1), DIRTYREGION_MAX_CELLS);
+  int y2 = std::min(std::max((int)std::ceil(region.y2 / DIRTYREGION_CELL_SIZE), y1 + 1), DIRTYREGION_MAX_CELLS);
+
+  GrowGrid(x2, y2);
+  for (int y = y1; y < y2; y++)
+  {
+    unsigned char *cell = &m_cells[y * m_columns + x1];
+    for (int x = x1; x < x2; x++, cell++)
+    {
+      if (*cell == DIRTYREGION_CELL_CLEAN)
+        m_dirtyCells++;
+      *cell = 0;
+    }
+  }
 }
 
 const CDirtyRegionList &CDirtyRegionTracker::GetMarkedRegions() const
@@ -76,8 +121,47 @@ CDirtyRegionList CDirtyRegionTracker::GetDirtyRegions()
 {
   CDirtyRegionList output;
 
-  if (m_solver)
-    m_solver->Solve(m_markedRegions, output);
+  if (!m_solver || !m_dirtyCells)
+    return output;
+
+  // merge the dirty cells of each row into runs, and runs spanning the same
+  // columns on consecutive rows into a single rectangle
+  CDirtyRegionList input;
+  std::vector<int> open(m_columns, -1); // index into input of the rectangle open at a run's start column
+  std::vector<int> openEnd(m_columns, 0);
+  for (int y = 0; y < m_rows; y++)
+  {
+    const unsigned char *row = &m_cells[y * m_columns];
+    std::vector<int> next(m_columns, -1);
+    int x = 0;
+    while (x < m_columns)
+    {
+      if (row[x] == DIRTYREGION_CELL_CLEAN)
+      {
+        x++;
+        continue;
+      }
+      int start = x;
+      while (x < m_columns && row[x] != DIRTYREGION_CELL_CLEAN)
+        x++;
+
+      if (open[start] >= 0 && openEnd[start] == x)
+      {
+        input[open[start]].y2 = float((y + 1) * DIRTYREGION_CELL_SIZE);
+        next[start] = open[start];
+      }
+      else
+      {
+        input.push_back(CDirtyRegion(float(start * DIRTYREGION_CELL_SIZE), float(y * DIRTYREGION_CELL_SIZE),
+                                     float(x * DIRTYREGION_CELL_SIZE), float((y + 1) * DIRTYREGION_CELL_SIZE)));
+        next[start] = input.size() - 1;
+      }
+      openEnd[start] = x;
+    }
+    open.swap(next);
+  }
+
+  m_solver->Solve(input, output);
 
   return output;
 }
@@ -93,4 +177,18 @@ void CDirtyRegionTracker::CleanMarkedRegions()
 
     i--;
   }
+
+  if (!m_dirtyCells)
+    return;
+
+  for (auto &cell : m_cells)
+  {
+    if (cell == DIRTYREGION_CELL_CLEAN)
+      continue;
+    if (++cell >= buffering)
+    {
+      cell = DIRTYREGION_CELL_CLEAN;
+      m_dirtyCells--;
+    }
+  }
 }
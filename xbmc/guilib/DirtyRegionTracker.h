@@ -21,6 +21,8 @@
 
 #include "IDirtyRegionSolver.h"
 
+#include <vector>
+
 #if defined(TARGET_DARWIN_IOS)
 #define DEFAULT_BUFFERING 4
 #else
@@ -40,7 +42,19 @@ public:
   void CleanMarkedRegions();
 
 private:
-  CDirtyRegionList m_markedRegions;
+  /*! \brief Make sure the grid covers the given number of cells, keeping marked cells.
+   */
+  void GrowGrid(int columns, int rows);
+
+  CDirtyRegionList m_markedRegions; ///< only kept while the regions are visualized
   int m_buffering;
   IDirtyRegionSolver *m_solver;
+
+  // dirty regions are binned into a grid of cells holding the number of frames since they
+  // were last marked, so that a busy window hands the solver a few merged rectangles
+  // rather than every region marked over the last frames
+  std::vector<unsigned char> m_cells;
+  int m_columns;
+  int m_rows;
+  unsigned int m_dirtyCells;
 };
@@ -94,6 +94,32 @@ static inline size_t Clamp(int64_t newPosition, size_t bufferSize)
   return std::min(std::max((int64_t) 0, newPosition), (int64_t) (bufferSize -1));
 }
 
+// get the image size from the start of frame segment of a jpeg
+static bool GetJpegSize(const unsigned char* buffer, unsigned int bufSize, unsigned int &width, unsigned int &height)
+{
+  size_t pos = 2;
+  while (pos + 9 <= bufSize)
+  {
+    if (buffer[pos] != 0xFF)
+      return false;
+
+    uint8_t marker = buffer[pos + 1];
+    if (marker == 0xFF) // fill byte
+      pos++;
+    else if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) // markers without a segment
+      pos += 2;
+    else if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+    {
+      height = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      width = (buffer[pos + 7] << 8) | buffer[pos + 8];
+      return width > 0 && height > 0;
+    }
+    else
+      pos += 2 + ((buffer[pos + 2] << 8) | buffer[pos + 3]);
+  }
+  return false;
+}
+
 static int mem_file_read(void *h, uint8_t* buf, int size)
 {
   if (size < 0)
@@ -161,7 +187,9 @@ CFFmpegImage::~CFFmpegImage()
 bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize,
                                       unsigned int width, unsigned int height)
 {
-    
+  m_maxWidth = width;
+  m_maxHeight = height;
+
   if (!Initialize(buffer, bufSize))
   {
     //log
@@ -269,6 +297,19 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
     return false;
   }
 
+  // jpegs larger than needed can be decoded at 1/2, 1/4 or 1/8 of their size (DCT scaling),
+  // which is a lot cheaper than decoding them in full and scaling them down afterwards
+  unsigned int width, height;
+  if (is_jpeg && codec->max_lowres > 0 && m_maxWidth > 0 && m_maxHeight > 0 &&
+      GetJpegSize(buffer, bufSize, width, height))
+  {
+    float scale = std::max(width / (float)m_maxWidth, height / (float)m_maxHeight);
+    int lowres = 0;
+    while (lowres < codec->max_lowres && (2 << lowres) <= scale)
+      lowres++;
+    m_codec_ctx->lowres = lowres;
+  }
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -315,6 +356,12 @@ AVFrame* CFFmpegImage::ExtractFrame()
   m_width = frame->width;
   m_originalWidth = m_width;
   m_originalHeight = m_height;
+  if (m_codec_ctx->lowres > 0)
+  {
+    // decoded at a reduced size, the coded size is the original one
+    m_originalWidth = m_codec_ctx->coded_width;
+    m_originalHeight = m_codec_ctx->coded_height;
+  }
 
   const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
   if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -488,8 +535,8 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
 
   // assumption quadratic maximums e.g. 2048x2048
   float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -501,7 +548,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  struct SwsContext* context = sws_getContext(frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
 
   if (range == AVCOL_RANGE_JPEG)
@@ -514,7 +561,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
   sws_freeContext(context);
 
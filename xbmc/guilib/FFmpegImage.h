@@ -104,4 +104,7 @@ private:
 
   AVFrame* m_pFrame;
   uint8_t* m_outputBuffer;
+
+  unsigned int m_maxWidth = 0;  ///< size the image will be scaled down to, used to decode jpegs at a reduced size
+  unsigned int m_maxHeight = 0;
 };
@@ -27,6 +27,7 @@
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "FileItem.h"
+#include "TextureCache.h"
 #include "input/Key.h"
 #include "utils/MathUtils.h"
 #include "utils/XBMCTinyXML.h"
@@ -61,13 +62,48 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_autoScrollDelayTime = 0;
   m_autoScrollIsReversed = false;
   m_lastRenderTime = 0;
+  m_prefetchDirection = 0;
+  m_prefetchOffset = 0;
 }
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
 {
+  CTextureCache::GetInstance().CancelPrefetch(this);
   delete m_listProvider;
 }
 
+CGUIListItemLayout *CGUIBaseContainer::CLayoutPool::Get()
+{
+  if (m_layouts.empty())
+    return NULL;
+  CGUIListItemLayout *layout = m_layouts.back();
+  m_layouts.pop_back();
+  return layout;
+}
+
+void CGUIBaseContainer::CLayoutPool::Put(CGUIListItemLayout *layout, unsigned int maxSize)
+{
+  if (!layout)
+    return;
+
+  // freeing resources also resets the animations, so the layout starts over like a fresh copy
+  layout->FreeResources();
+  if (m_layouts.size() < maxSize)
+  {
+    layout->SetInvalid();
+    m_layouts.push_back(layout);
+  }
+  else
+    delete layout;
+}
+
+void CGUIBaseContainer::CLayoutPool::Clear()
+{
+  for (auto *layout : m_layouts)
+    delete layout;
+  m_layouts.clear();
+}
+
 void CGUIBaseContainer::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
   CGUIControl::DoProcess(currentTime, dirtyregions);
@@ -143,6 +179,8 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   // to have same behaviour when scrolling down, we need to set page control to offset+1
   UpdatePageControl(offset + (m_scroller.IsScrollingDown() ? 1 : 0));
 
+  UpdatePrefetch(offset, cacheBefore, cacheAfter);
+
   m_lastRenderTime = currentTime;
 
   CGUIControl::Process(currentTime, dirtyregions);
@@ -161,7 +199,9 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   {
     if (!item->GetFocusedLayout())
     {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_focusedLayout, this);
+      CGUIListItemLayout *layout = m_focusedLayoutPool.Get();
+      if (!layout)
+        layout = new CGUIListItemLayout(*m_focusedLayout, this);
       item->SetFocusedLayout(layout);
     }
     if (item->GetFocusedLayout())
@@ -188,8 +228,12 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
       item->GetFocusedLayout()->SetFocusedItem(0);  // focus is not set
     if (!item->GetLayout())
     {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_layout);
-      layout->SetParentControl(this);
+      CGUIListItemLayout *layout = m_layoutPool.Get();
+      if (!layout)
+      {
+        layout = new CGUIListItemLayout(*m_layout);
+        layout->SetParentControl(this);
+      }
       item->SetLayout(layout);
     }
     if (item->GetFocusedLayout())
@@ -198,6 +242,8 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
       item->GetLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
   }
 
+  m_itemsWithLayouts.insert(item);
+
   g_graphicsContext.RestoreOrigin();
 }
 
@@ -881,6 +927,8 @@ void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
   { // free memory of items
     for (iItems it = m_items.begin(); it != m_items.end(); ++it)
       (*it)->FreeMemory();
+    m_itemsWithLayouts.clear();
+    ClearLayoutPools();
   }
   // and recalculate the layout
   CalculateLayout();
@@ -1002,6 +1050,8 @@ void CGUIBaseContainer::CalculateLayout()
   if (oldLayout == m_layout && oldFocusedLayout == m_focusedLayout)
     return; // nothing has changed, so don't update stuff
 
+  ClearLayoutPools();
+
   m_itemsPerPage = std::max((int)((Size() - m_focusedLayout->Size(m_orientation)) / m_layout->Size(m_orientation)) + 1, 1);
 
   // ensure that the scroll offset is a multiple of our size
@@ -1134,11 +1184,48 @@ int CGUIBaseContainer::CorrectOffset(int offset, int cursor) const
   return offset + cursor;
 }
 
+void CGUIBaseContainer::UpdatePrefetch(int offset, int cacheBefore, int cacheAfter)
+{
+  int direction = m_scroller.IsScrollingDown() ? 1 : (m_scroller.IsScrollingUp() ? -1 : 0);
+  if (!direction || m_items.empty() || m_itemsPerPage <= 0)
+    return; // keep caching whatever lies ahead of where we were heading
+
+  // look a page past the items we preload, or two when scrolling fast
+  bool fastScrolling = m_scrollTimer.IsRunning() && m_scrollTimer.GetElapsedMilliseconds() > std::max(m_scroller.GetDuration(), SCROLLING_THRESHOLD);
+  int rows = (fastScrolling ? 2 : 1) * m_itemsPerPage;
+  int start = direction > 0 ? offset + m_itemsPerPage + 1 + cacheAfter : offset - cacheBefore - rows;
+
+  // requeueing on every row would mostly cancel and requeue the same images
+  if (direction == m_prefetchDirection && std::abs(start - m_prefetchOffset) < m_itemsPerPage)
+    return;
+  m_prefetchDirection = direction;
+  m_prefetchOffset = start;
+
+  std::vector<std::string> images;
+  for (int i = 0; i < rows; i++)
+  {
+    // nearest rows first
+    int row = direction > 0 ? start + i : start + rows - 1 - i;
+    int first = CorrectOffset(row, 0);
+    int last = std::max(CorrectOffset(row + 1, 0), first + 1);
+    for (int itemNo = std::max(first, 0); itemNo < last && itemNo < (int)m_items.size(); itemNo++)
+    {
+      const CGUIListItem::ArtMap &art = m_items[itemNo]->GetArt();
+      for (CGUIListItem::ArtMap::const_iterator j = art.begin(); j != art.end(); ++j)
+        images.push_back(j->second);
+    }
+  }
+  CTextureCache::GetInstance().PrefetchImages(this, images);
+}
+
 void CGUIBaseContainer::Reset()
 {
+  CTextureCache::GetInstance().CancelPrefetch(this);
+  m_prefetchDirection = 0;
   m_wasReset = true;
   m_items.clear();
   m_lastItem.reset();
+  m_itemsWithLayouts.clear();
   ResetAutoScrolling();
 }
 
@@ -1184,18 +1271,45 @@ void CGUIBaseContainer::SetRenderOffset(const CPoint &offset)
 
 void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
 {
+  // only the items we gave layouts to need visiting, so long lists cost no more than short ones
+  std::unordered_set<CGUIListItem *> keep;
   if (keepStart < keepEnd)
-  { // remove before keepStart and after keepEnd
-    for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
-    for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+  { // keep from keepStart to keepEnd
+    for (int i = std::max(keepStart, 0); i <= keepEnd && i < (int)m_items.size(); ++i)
+      keep.insert(m_items[i].get());
   }
   else
   { // wrapping
-    for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+    for (int i = std::max(keepStart, 0); i < (int)m_items.size(); ++i)
+      keep.insert(m_items[i].get());
+    for (int i = 0; i <= keepEnd && i < (int)m_items.size(); ++i)
+      keep.insert(m_items[i].get());
   }
+
+  for (auto it = m_itemsWithLayouts.begin(); it != m_itemsWithLayouts.end();)
+  {
+    if (keep.find(it->get()) == keep.end())
+    {
+      RecycleLayouts(*it);
+      it = m_itemsWithLayouts.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void CGUIBaseContainer::RecycleLayouts(const CGUIListItemPtr &item)
+{
+  // enough spare layouts for a page of items scrolling in
+  unsigned int maxSize = m_itemsPerPage + m_cacheItems + 1;
+  m_layoutPool.Put(item->ReleaseLayout(), maxSize);
+  m_focusedLayoutPool.Put(item->ReleaseFocusedLayout(), 2);
+}
+
+void CGUIBaseContainer::ClearLayoutPools()
+{
+  m_layoutPool.Clear();
+  m_focusedLayoutPool.Clear();
 }
 
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
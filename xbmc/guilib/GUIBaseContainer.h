@@ -25,6 +25,7 @@
  *
  */
 
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -136,6 +137,8 @@ protected:
   inline float Size() const;
   void MoveToRow(int row);
   void FreeMemory(int keepStart, int keepEnd);
+  void RecycleLayouts(const CGUIListItemPtr &item);
+  void ClearLayoutPools();
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -167,6 +170,30 @@ protected:
 
   CScroller m_scroller;
 
+  /*! \brief Layouts taken off items that scrolled out of view, handed to the items scrolling in.
+   Pooled layouts are copies of the current m_layout/m_focusedLayout, so the pools are cleared
+   whenever those change. Copies of a container start out with empty pools.
+   */
+  class CLayoutPool
+  {
+  public:
+    CLayoutPool() = default;
+    CLayoutPool(const CLayoutPool &) {};
+    CLayoutPool &operator=(const CLayoutPool &) { Clear(); return *this; };
+    ~CLayoutPool() { Clear(); };
+
+    CGUIListItemLayout *Get();
+    void Put(CGUIListItemLayout *layout, unsigned int maxSize);
+    void Clear();
+  private:
+    std::vector<CGUIListItemLayout *> m_layouts;
+  };
+  CLayoutPool m_layoutPool;
+  CLayoutPool m_focusedLayoutPool;
+
+  // items holding layouts of ours, so that freeing memory only visits these rather than every item
+  std::unordered_set<CGUIListItemPtr> m_itemsWithLayouts;
+
   IListProvider *m_listProvider;
 
   bool m_wasReset;  // true if we've received a Reset message until we've rendered once.  Allows
@@ -176,6 +203,16 @@ protected:
 
   void UpdateScrollByLetter();
   void GetCacheOffsets(int &cacheBefore, int &cacheAfter) const;
+
+  /*! \brief Have the art of the items beyond those we preload cached while scrolling
+   Looks further ahead while scrolling fast, and drops the remainder of an earlier request
+   once the scroll direction changes.
+   \param offset the first visible row
+   \param cacheBefore rows preloaded before the visible ones
+   \param cacheAfter rows preloaded after the visible ones
+   \sa CTextureCache::PrefetchImages
+   */
+  void UpdatePrefetch(int offset, int cacheBefore, int cacheAfter);
   int GetCacheCount() const { return m_cacheItems; };
   bool ScrollingDown() const { return m_scroller.IsScrollingDown(); };
   bool ScrollingUp() const { return m_scroller.IsScrollingUp(); };
@@ -225,6 +262,8 @@ private:
   CStopWatch m_scrollTimer;
   CStopWatch m_lastScrollStartTimer;
   CStopWatch m_pageChangeTimer;
+  int m_prefetchDirection; ///< scroll direction of the last prefetch, 0 if none
+  int m_prefetchOffset;    ///< first row of the last prefetch
 
   CGUIAction m_clickActions;
   CGUIAction m_focusActions;
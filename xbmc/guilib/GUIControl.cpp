@@ -56,6 +56,7 @@ CGUIControl::CGUIControl() :
   m_controlDirtyState = DIRTY_STATE_CONTROL;
   m_stereo = 0.0f;
   m_controlStats = nullptr;
+  m_processSkippable = false;
 }
 
 CGUIControl::CGUIControl(int parentID, int controlID, float posX, float posY, float width, float height)
@@ -85,6 +86,7 @@ CGUIControl::CGUIControl(int parentID, int controlID, float posX, float posY, fl
   m_controlDirtyState = DIRTY_STATE_CONTROL;
   m_stereo = 0.0f;
   m_controlStats = nullptr;
+  m_processSkippable = false;
 }
 
 
@@ -94,6 +96,7 @@ void CGUIControl::AllocResources()
 {
   m_hasProcessed = false;
   m_bInvalidated = true;
+  m_processSkippable = false;
   m_bAllocated=true;
 }
 
@@ -162,6 +165,51 @@ void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
   {
     dirtyregions.push_back(CDirtyRegion(dirtyRegion));
   }
+
+  // only once we've had a quiet frame can we be left alone
+  m_processSkippable = !changed && CanSkipProcess();
+}
+
+bool CGUIControl::SkipProcess()
+{
+  if (!m_processSkippable || m_controlDirtyState || m_bInvalidated)
+    return false;
+
+  // our place on screen only stays put if the transform we inherit does
+  TransformMatrix transform = g_graphicsContext.AddTransform(m_transform);
+  g_graphicsContext.RemoveTransform();
+  return transform == m_cachedTransform;
+}
+
+bool CGUIControl::IsProcessStable() const
+{
+  // anything driven by skin conditions or still animating has to be processed every frame
+  if (m_hasCamera || m_bHasFocus || m_pushedUpdates || m_visible == DELAYED)
+    return false;
+  if (m_visibleCondition && m_visibleCondition->Domains())
+    return false;
+  if (m_enableCondition && m_enableCondition->Domains())
+    return false;
+  if (!m_diffuseColor.IsConstant())
+    return false;
+
+  for (const auto &anim : m_animations)
+  {
+    if (anim.GetType() == ANIM_TYPE_CONDITIONAL || anim.GetQueuedProcess() != ANIM_PROCESS_NONE)
+      return false;
+    if (anim.GetState() == ANIM_STATE_DELAYED || anim.GetState() == ANIM_STATE_IN_PROCESS)
+      return false;
+  }
+  return true;
+}
+
+void CGUIControl::SetInvalid()
+{
+  m_bInvalidated = true;
+
+  // our parents have to process again for us to be reached
+  for (CGUIControl *parent = m_parentControl; parent && parent->m_processSkippable; parent = parent->m_parentControl)
+    parent->m_processSkippable = false;
 }
 
 void CGUIControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions)
@@ -103,6 +103,12 @@ public:
   /*! \brief Returns whether or not we have processed */
   bool HasProcessed() const { return m_hasProcessed; };
 
+  /*! \brief Whether processing this control can be skipped this frame.
+   Holds when the control settled last frame, nothing marked it dirty or invalid since and
+   the transform it inherits from its parents hasn't changed.
+   */
+  bool SkipProcess();
+
   // OnAction() is called by our window when we are the focused control.
   // We should process any control-specific actions in the derived classes,
   // and return true if we have taken care of the action.  Returning false
@@ -230,7 +236,7 @@ public:
   virtual void UpdateVisibility(const CGUIListItem *item);
   virtual void SetInitialVisibility();
   virtual void SetEnabled(bool bEnable);
-  virtual void SetInvalid() { m_bInvalidated = true; };
+  virtual void SetInvalid();
   virtual void SetPulseOnSelect(bool pulse) { m_pulseOnSelect = pulse; };
   virtual std::string GetDescription() const { return ""; };
   virtual std::string GetDescriptionByIndex(int index) const { return ""; };
@@ -253,7 +259,7 @@ public:
   virtual bool IsContainer() const { return false; };
   virtual bool GetCondition(int condition, int data) const { return false; };
 
-  void SetParentControl(CGUIControl *control) { m_parentControl = control; };
+  void SetParentControl(CGUIControl *control) { m_parentControl = control; m_processSkippable = false; };
   CGUIControl *GetParentControl(void) const { return m_parentControl; };
   virtual void SaveStates(std::vector<CControlState> &states);
   virtual CGUIControl *GetControl(int id, std::vector<CGUIControl*> *idCollector = nullptr);
@@ -328,6 +334,12 @@ protected:
   virtual bool CanFocusFromPoint(const CPoint &point) const;
 
   virtual bool UpdateColors();
+  /*! \brief Whether nothing but a change from outside (dirty, invalidation, parent transform) can
+   change this control, so that it can be left out of Process() until then.
+   Only controls that know their content is constant override this.
+   */
+  virtual bool CanSkipProcess() const { return false; }
+  bool IsProcessStable() const;
   virtual bool Animate(unsigned int currentTime);
   virtual bool CheckAnimation(ANIMATION_TYPE animType);
   void UpdateStates(ANIMATION_TYPE type, ANIMATION_PROCESS currentProcess, ANIMATION_STATE currentState);
@@ -380,6 +392,7 @@ protected:
 
   unsigned int  m_controlDirtyState;
   CRect m_renderRegion;         // In screen coordinates
+  bool m_processSkippable;      // set at the end of DoProcess() from CanSkipProcess()
 };
 
 #endif
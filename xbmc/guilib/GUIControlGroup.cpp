@@ -31,6 +31,7 @@ CGUIControlGroup::CGUIControlGroup()
   m_defaultAlways = false;
   m_focusedControl = 0;
   m_renderFocusedLast = false;
+  m_childrenSkippable = false;
   ControlType = GUICONTROL_GROUP;
 }
 
@@ -41,6 +42,7 @@ CGUIControlGroup::CGUIControlGroup(int parentID, int controlID, float posX, floa
   m_defaultAlways = false;
   m_focusedControl = 0;
   m_renderFocusedLast = false;
+  m_childrenSkippable = false;
   ControlType = GUICONTROL_GROUP;
 }
 
@@ -50,6 +52,7 @@ CGUIControlGroup::CGUIControlGroup(const CGUIControlGroup &from)
   m_defaultControl = from.m_defaultControl;
   m_defaultAlways = from.m_defaultAlways;
   m_renderFocusedLast = from.m_renderFocusedLast;
+  m_childrenSkippable = false;
 
   // run through and add our controls
   for (auto *i : from.m_children)
@@ -98,13 +101,24 @@ void CGUIControlGroup::Process(unsigned int currentTime, CDirtyRegionList &dirty
   g_graphicsContext.SetOrigin(pos.x, pos.y);
 
   CRect rect;
+  m_childrenSkippable = true;
   for (auto *control : m_children)
   {
+    // settled static controls keep their last state and render region
+    if (control->SkipProcess())
+    {
+      if (control->IsVisible())
+        rect.Union(control->GetRenderRegion());
+      continue;
+    }
+
     control->UpdateVisibility(nullptr);
     unsigned int oldDirty = dirtyregions.size();
     control->DoProcess(currentTime, dirtyregions);
     if (control->IsVisible() || (oldDirty != dirtyregions.size())) // visible or dirty (was visible?)
       rect.Union(control->GetRenderRegion());
+    if (!control->SkipProcess())
+      m_childrenSkippable = false;
   }
 
   g_graphicsContext.RestoreOrigin();
@@ -112,6 +126,11 @@ void CGUIControlGroup::Process(unsigned int currentTime, CDirtyRegionList &dirty
   m_renderRegion = rect;
 }
 
+bool CGUIControlGroup::CanSkipProcess() const
+{
+  return m_childrenSkippable && IsProcessStable();
+}
+
 void CGUIControlGroup::Render()
 {
   CPoint pos(GetPosition());
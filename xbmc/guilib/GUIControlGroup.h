@@ -84,6 +84,8 @@ public:
   void DumpTextureUse() override;
 #endif
 protected:
+  bool CanSkipProcess() const override;
+
   // sub controls
   std::vector<CGUIControl *> m_children;
 
@@ -96,6 +98,7 @@ protected:
   bool m_defaultAlways;
   int m_focusedControl;
   bool m_renderFocusedLast;
+  bool m_childrenSkippable; ///< every child settled during the last Process()
 private:
   typedef std::vector< std::vector<CGUIControl *> * > COLLECTORTYPE;
 
@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFontAtlas.h"
+
+// shelves are created in steps of this height, so glyphs of similar height can share them
+#define SHELF_HEIGHT_STEP 4
+
+void CGUIFontAtlas::Reset(unsigned int width, unsigned int maxHeight)
+{
+  m_shelves.clear();
+  m_width = width;
+  m_maxHeight = maxHeight;
+  m_usedHeight = 0;
+}
+
+bool CGUIFontAtlas::Allocate(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+{
+  if (width > m_width || height == 0)
+    return false;
+
+  // use the tightest existing shelf, but don't put small glyphs on much taller shelves
+  Shelf *best = nullptr;
+  for (auto &shelf : m_shelves)
+  {
+    if (shelf.height < height || shelf.height > height + height / 2 + SHELF_HEIGHT_STEP)
+      continue;
+    if (best && best->height <= shelf.height)
+      continue;
+    for (const auto &span : shelf.free)
+    {
+      if (span.width >= width)
+      {
+        best = &shelf;
+        break;
+      }
+    }
+  }
+
+  if (best && AllocateInShelf(*best, width, x))
+  {
+    y = best->y;
+    return true;
+  }
+
+  unsigned int shelfHeight = (height + SHELF_HEIGHT_STEP - 1) / SHELF_HEIGHT_STEP * SHELF_HEIGHT_STEP;
+  if (m_usedHeight + shelfHeight > m_maxHeight)
+  {
+    shelfHeight = height;
+    if (m_usedHeight + shelfHeight > m_maxHeight)
+      return false;
+  }
+
+  Shelf shelf;
+  shelf.y = m_usedHeight;
+  shelf.height = shelfHeight;
+  shelf.free.push_back({ width, m_width - width });
+  if (shelf.free.back().width == 0)
+    shelf.free.clear();
+  m_shelves.push_back(shelf);
+  m_usedHeight += shelfHeight;
+
+  x = 0;
+  y = shelf.y;
+  return true;
+}
+
+void CGUIFontAtlas::Release(unsigned int x, unsigned int y, unsigned int width)
+{
+  if (width == 0)
+    return;
+
+  for (auto &shelf : m_shelves)
+  {
+    if (shelf.y != y)
+      continue;
+
+    auto it = shelf.free.begin();
+    while (it != shelf.free.end() && it->x < x)
+      ++it;
+    it = shelf.free.insert(it, { x, width });
+
+    // merge with the following span
+    auto next = it + 1;
+    if (next != shelf.free.end() && it->x + it->width == next->x)
+    {
+      it->width += next->width;
+      shelf.free.erase(next);
+    }
+    // and with the preceding one
+    if (it != shelf.free.begin())
+    {
+      auto prev = it - 1;
+      if (prev->x + prev->width == it->x)
+      {
+        prev->width += it->width;
+        shelf.free.erase(it);
+      }
+    }
+    return;
+  }
+}
+
+bool CGUIFontAtlas::AllocateInShelf(Shelf &shelf, unsigned int width, unsigned int &x)
+{
+  for (auto it = shelf.free.begin(); it != shelf.free.end(); ++it)
+  {
+    if (it->width < width)
+      continue;
+
+    x = it->x;
+    it->x += width;
+    it->width -= width;
+    if (it->width == 0)
+      shelf.free.erase(it);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,81 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Shelf packer for the glyph texture of a font.
+
+ Glyphs are placed on horizontal shelves whose height is close to the glyph height,
+ so small glyphs don't waste the space of a full text line. Space of glyphs that are
+ released is merged back into the free spans of their shelf and reused, which allows
+ the font to evict single glyphs instead of re-rendering its whole cache.
+ */
+class CGUIFontAtlas
+{
+public:
+  CGUIFontAtlas() = default;
+
+  /*! \brief Drop all allocations and set the dimensions of the atlas.
+   \param width width of the texture.
+   \param maxHeight height the texture may grow to.
+   */
+  void Reset(unsigned int width, unsigned int maxHeight);
+
+  /*! \brief Find space for a glyph.
+   \param width width of the glyph, including any spacing.
+   \param height height of the glyph, including any spacing.
+   \param x [out] left of the allocated space.
+   \param y [out] top of the allocated space.
+   \return false if there is no room, even when growing to the maximum height.
+   */
+  bool Allocate(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y);
+
+  /*! \brief Return space previously handed out by Allocate().
+   */
+  void Release(unsigned int x, unsigned int y, unsigned int width);
+
+  /*! \brief The height of the texture needed to hold all shelves.
+   */
+  unsigned int GetUsedHeight() const { return m_usedHeight; }
+
+private:
+  struct Span
+  {
+    unsigned int x;
+    unsigned int width;
+  };
+
+  struct Shelf
+  {
+    unsigned int y;
+    unsigned int height;
+    std::vector<Span> free; ///< sorted by x, adjacent spans are merged
+  };
+
+  static bool AllocateInShelf(Shelf &shelf, unsigned int width, unsigned int &x);
+
+  std::vector<Shelf> m_shelves;
+  unsigned int m_width = 0;
+  unsigned int m_maxHeight = 0;
+  unsigned int m_usedHeight = 0;
+};
@@ -225,3 +225,65 @@ void CVertexBuffer::clear()
   if (m_font != NULL)
     m_font->DestroyVertexBuffer(*this);
 }
+
+bool CGUIFontWidthCache::Lookup(vecText::const_iterator start, vecText::const_iterator end, float &width)
+{
+  size_t hash = Hash(start, end);
+  auto range = m_entries.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    const vecText &text = it->second.text;
+    if (text.size() == static_cast<size_t>(end - start) && std::equal(text.begin(), text.end(), start))
+    {
+      it->second.lastUsed = ++m_counter;
+      width = it->second.width;
+      return true;
+    }
+  }
+  return false;
+}
+
+void CGUIFontWidthCache::Store(vecText::const_iterator start, vecText::const_iterator end, float width)
+{
+  if (m_entries.size() >= MAX_ENTRIES)
+  {
+    // drop the least recently used half
+    std::vector<unsigned int> ages;
+    ages.reserve(m_entries.size());
+    for (const auto &entry : m_entries)
+      ages.push_back(entry.second.lastUsed);
+    std::nth_element(ages.begin(), ages.begin() + ages.size() / 2, ages.end());
+    unsigned int limit = ages[ages.size() / 2];
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+      if (it->second.lastUsed < limit)
+        it = m_entries.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  Entry entry;
+  entry.text.assign(start, end);
+  entry.width = width;
+  entry.lastUsed = ++m_counter;
+  m_entries.insert(std::make_pair(Hash(start, end), std::move(entry)));
+}
+
+void CGUIFontWidthCache::Flush()
+{
+  m_entries.clear();
+  m_counter = 0;
+}
+
+size_t CGUIFontWidthCache::Hash(vecText::const_iterator start, vecText::const_iterator end)
+{
+  // FNV-1a over the characters, including style and color bits
+  uint32_t hash = 2166136261u;
+  for (; start != end; ++start)
+  {
+    hash ^= *start;
+    hash *= 16777619u;
+  }
+  return hash;
+}
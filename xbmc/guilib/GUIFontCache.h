@@ -35,6 +35,7 @@
 #include <vector>
 #include <memory>
 #include <cassert>
+#include <unordered_map>
 
 #include "TransformMatrix.h"
 #include "system.h"
@@ -261,4 +262,39 @@ inline float MatrixHashContribution(const CGUIFontCacheKey<CGUIFontCacheDynamicP
   return 0;
 }
 
+/*!
+ \brief Cache of the measured width of long text runs.
+
+ Layout measures the same strings over and over while wrapping, aligning and
+ truncating. The width of a run only depends on the glyph metrics of the font,
+ so entries stay valid when glyphs are evicted from or re-rendered to the texture.
+ */
+class CGUIFontWidthCache
+{
+public:
+  CGUIFontWidthCache() = default;
+
+  bool Lookup(vecText::const_iterator start, vecText::const_iterator end, float &width);
+  void Store(vecText::const_iterator start, vecText::const_iterator end, float width);
+  void Flush();
+
+  /*! \brief shorter runs are cheaper to measure than to look up */
+  static const size_t MIN_RUN_LENGTH = 16;
+
+private:
+  struct Entry
+  {
+    vecText text;
+    float width;
+    unsigned int lastUsed;
+  };
+
+  static const size_t MAX_ENTRIES = 512;
+
+  static size_t Hash(vecText::const_iterator start, vecText::const_iterator end);
+
+  std::unordered_multimap<size_t, Entry> m_entries;
+  unsigned int m_counter = 0;
+};
+
 #endif
@@ -21,6 +21,7 @@
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
 #include "GUIFontManager.h"
+#include "GUIFrameProfiler.h"
 #include "Texture.h"
 #include "GraphicContext.h"
 #include "filesystem/SpecialProtocol.h"
@@ -29,9 +30,12 @@
 #include "windowing/WindowingFactory.h"
 #include "URL.h"
 #include "filesystem/File.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
+#include "utils/auto_buffer.h"
 
 #include <math.h>
+#include <map>
 #include <memory>
 #include <queue>
 
@@ -40,6 +44,7 @@
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
+#include FT_SIZES_H
 #include FT_STROKER_H
 
 #ifdef TARGET_WINDOWS
@@ -52,6 +57,7 @@
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define CHAR_EVICT_DIVISOR 4  // evict a quarter of the characters once the texture is full
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
 
@@ -66,12 +72,19 @@ public:
 
   virtual ~CFreeTypeLibrary()
   {
+    for (auto &it : m_faces)
+      FT_Done_Face(it.second.face);
     if (m_library)
       FT_Done_FreeType(m_library);
   }
 
-  FT_Face GetFont(const std::string &filename, float size, float aspect, XUTILS::auto_buffer& memoryBuf)
+  /*! \brief Get the face for a font file.
+   Faces are shared by all sizes of the same font, each size is set up via GetSize().
+   */
+  FT_Face GetFont(const std::string &filename)
   {
+    CSingleLock lock(m_section);
+
     // don't have it yet - create it
     if (!m_library)
       FT_Init_FreeType(&m_library);
@@ -81,14 +94,20 @@ public:
       return NULL;
     }
 
-    FT_Face face;
-
     // ok, now load the font face
     CURL realFile(CSpecialProtocol::TranslatePath(filename));
     if (realFile.GetFileName().empty())
       return NULL;
 
-    memoryBuf.clear();
+    auto it = m_faces.find(realFile.Get());
+    if (it != m_faces.end())
+    {
+      it->second.references++;
+      return it->second.face;
+    }
+
+    FT_Face face;
+    std::shared_ptr<XUTILS::auto_buffer> memoryBuf;
 #ifndef TARGET_WINDOWS
     if (!realFile.GetProtocol().empty())
 #endif // ! TARGET_WINDOWS
@@ -96,10 +115,11 @@ public:
       // load file into memory if it is not on local drive
       // in case of win32: always load file into memory as filename is in UTF-8,
       //                   but freetype expect filename in ANSI encoding
+      memoryBuf = std::make_shared<XUTILS::auto_buffer>();
       XFILE::CFile f;
-      if (f.LoadFile(realFile, memoryBuf) <= 0)
+      if (f.LoadFile(realFile, *memoryBuf) <= 0)
         return NULL;
-      if (FT_New_Memory_Face(m_library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
+      if (FT_New_Memory_Face(m_library, (const FT_Byte*)memoryBuf->get(), memoryBuf->size(), 0, &face) != 0)
         return NULL;
     }
 #ifndef TARGET_WINDOWS
@@ -107,6 +127,24 @@ public:
       return NULL;
 #endif // ! TARGET_WINDOWS
 
+    SharedFace &shared = m_faces[realFile.Get()];
+    shared.face = face;
+    shared.references = 1;
+    shared.memory = memoryBuf;
+    return face;
+  };
+
+  /*! \brief Create a size for a shared face.
+   The size has to be activated with FT_Activate_Size() before using the face.
+   */
+  FT_Size GetSize(FT_Face face, float size, float aspect)
+  {
+    CSingleLock lock(m_section);
+
+    FT_Size ftSize;
+    if (FT_New_Size(face, &ftSize) || FT_Activate_Size(ftSize))
+      return NULL;
+
     unsigned int ydpi = 72; // 72 points to the inch is the freetype default
     unsigned int xdpi = (unsigned int)MathUtils::round_int(ydpi * aspect);
 
@@ -116,13 +154,13 @@ public:
     // scaling to pixel ratio on screen perhaps?
     if (FT_Set_Char_Size( face, 0, (int)(size*64 + 0.5f), xdpi, ydpi ))
     {
-      FT_Done_Face(face);
+      FT_Done_Size(ftSize);
       return NULL;
     }
 
-    return face;
-  };
-  
+    return ftSize;
+  }
+
   FT_Stroker GetStroker()
   {
     if (!m_library)
@@ -135,20 +173,51 @@ public:
     return stroker;
   };
 
-  static void ReleaseFont(FT_Face face)
+  void ReleaseFont(FT_Face face)
   {
     assert(face);
-    FT_Done_Face(face);
+    CSingleLock lock(m_section);
+    for (auto it = m_faces.begin(); it != m_faces.end(); ++it)
+    {
+      if (it->second.face == face)
+      {
+        if (--it->second.references == 0)
+        {
+          FT_Done_Face(face);
+          m_faces.erase(it);
+        }
+        return;
+      }
+    }
   };
-  
+
+  void ReleaseSize(FT_Size size)
+  {
+    assert(size);
+    CSingleLock lock(m_section);
+    FT_Done_Size(size);
+  }
+
   static void ReleaseStroker(FT_Stroker stroker)
   {
     assert(stroker);
     FT_Stroker_Done(stroker);
   }
 
+  /*! \brief Lock to hold while a shared face is used with one of its sizes. */
+  CCriticalSection &GetSection() { return m_section; }
+
 private:
+  struct SharedFace
+  {
+    FT_Face face;
+    int references;
+    std::shared_ptr<XUTILS::auto_buffer> memory; ///< font data for faces that were loaded into memory
+  };
+
   FT_Library   m_library;
+  std::map<std::string, SharedFace> m_faces;
+  CCriticalSection m_section;
 };
 
 XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
@@ -164,6 +233,7 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_vertex.reserve(4*1024);
 
   m_face = NULL;
+  m_size = NULL;
   m_stroker = NULL;
   memset(m_charquick, 0, sizeof(m_charquick));
   m_strFileName = strFileName;
@@ -171,7 +241,8 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
-  m_posX = m_posY = 0;
+  m_glyphStamp = 0;
+  m_atlasReused = false;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -210,9 +281,9 @@ void CGUIFontTTFBase::ClearCharacterCache()
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth, g_Windowing.GetMaxTextureSize());
+  m_atlasReused = false;
   m_textureHeight = 0;
 }
 
@@ -225,10 +296,13 @@ void CGUIFontTTFBase::Clear()
   m_char = NULL;
   m_maxChars = 0;
   m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
+  m_atlas.Reset(0, 0);
+  m_widthCache.Flush();
   m_nestedBeginCount = 0;
 
+  if (m_size)
+    g_freeTypeLibrary.ReleaseSize(m_size);
+  m_size = NULL;
   if (m_face)
     g_freeTypeLibrary.ReleaseFont(m_face);
   m_face = NULL;
@@ -240,18 +314,26 @@ void CGUIFontTTFBase::Clear()
   m_vertex.clear();
 
   m_strFileName.clear();
-  m_fontFileInMemory.clear();
 }
 
 bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float aspect, float lineSpacing, bool border)
 {
   // we now know that this object is unique - only the GUIFont objects are non-unique, so no need
   // for reference tracking these fonts
-  m_face = g_freeTypeLibrary.GetFont(strFilename, height, aspect, m_fontFileInMemory);
+  m_face = g_freeTypeLibrary.GetFont(strFilename);
 
   if (!m_face)
     return false;
 
+  // the face is shared by all sizes of this font
+  m_size = g_freeTypeLibrary.GetSize(m_face, height, aspect);
+  if (!m_size)
+  {
+    g_freeTypeLibrary.ReleaseFont(m_face);
+    m_face = NULL;
+    return false;
+  }
+
   /*
    the values used are described below
 
@@ -279,7 +361,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
      add on the strength of any border - the non-bordered font needs
      aligning with the bordered font by utilising GetTextBaseLine()
      */
-    FT_Pos strength = FT_MulFix( m_face->units_per_EM, m_face->size->metrics.y_scale) / 12;
+    FT_Pos strength = FT_MulFix( m_face->units_per_EM, m_size->metrics.y_scale) / 12;
     if (strength < 128)
       strength = 128;
 
@@ -308,6 +390,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
   m_maxChars = 0;
   m_numChars = 0;
+  m_widthCache.Flush();
 
   m_strFilename = strFilename;
 
@@ -320,9 +403,9 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_textureWidth = g_Windowing.GetMaxTextureSize();
   m_textureScaleX = 1.0f / m_textureWidth;
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth, g_Windowing.GetMaxTextureSize());
+  m_atlasReused = false;
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -355,6 +438,7 @@ void CGUIFontTTFBase::End()
 
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
 {
+  GUIPROFILER_ZONE("CGUIFontTTF::DrawText");
   Begin();
 
   uint32_t rawAlignment = alignment;
@@ -388,6 +472,9 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
                            dirtyCache));
   if (dirtyCache)
   {
+    // characters used by this text must stay in the texture until it is rendered
+    m_glyphStamp++;
+
     // save the origin, which is scaled separately
     m_originX = x;
     m_originY = y;
@@ -559,20 +646,27 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
 float CGUIFontTTFBase::GetTextWidthInternal(vecText::const_iterator start, vecText::const_iterator end)
 {
   float width = 0;
-  while (start != end)
+  bool cacheable = static_cast<size_t>(end - start) >= CGUIFontWidthCache::MIN_RUN_LENGTH;
+  if (cacheable && m_widthCache.Lookup(start, end, width))
+    return width;
+
+  for (vecText::const_iterator pos = start; pos != end;)
   {
-    Character *c = GetCharacter(*start++);
+    Character *c = GetCharacter(*pos++);
     if (c)
     {
       // If last character in line, we want to add render width
       // and not advance distance - this makes sure that italic text isn't
       // choped on the end (as render width is larger than advance then).
-      if (start == end)
+      if (pos == end)
         width += std::max(c->right - c->left + c->offsetX, c->advance);
       else
         width += c->advance;
     }
   }
+
+  if (cacheable)
+    m_widthCache.Store(start, end, width);
   return width;
 }
 
@@ -590,18 +684,13 @@ float CGUIFontTTFBase::GetTextHeight(float lineSpacing, int numLines) const
 
 float CGUIFontTTFBase::GetLineHeight(float lineSpacing) const
 {
-  if (m_face)
-    return lineSpacing * m_face->size->metrics.height / 64.0f;
+  if (m_size)
+    return lineSpacing * m_size->metrics.height / 64.0f;
   return 0.0f;
 }
 
 const unsigned int CGUIFontTTFBase::spacing_between_characters_in_texture = 1;
 
-unsigned int CGUIFontTTFBase::GetTextureLineHeight() const
-{
-  return m_cellHeight + spacing_between_characters_in_texture;
-}
-
 CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 {
   wchar_t letter = (wchar_t)(chr & 0xffff);
@@ -616,25 +705,45 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   {
     character_t ch = (style << 8) | letter;
     if (ch < LOOKUPTABLE_SIZE && m_charquick[ch])
+    {
+      m_charquick[ch]->lastUsed = m_glyphStamp;
       return m_charquick[ch];
+    }
   }
 
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  while (low <= high)
+  int low = FindCharacter(ch);
+  if (low < m_numChars && m_char[low].letterAndStyle == ch)
   {
-    int mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
+    m_char[low].lastUsed = m_glyphStamp;
+    return &m_char[low];
+  }
+
+  // render the character to our texture
+  // must End() as we can't render text to our texture during a Begin(), End() block
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  m_nestedBeginCount = 1;
+  if (nestedBeginCount) End();
+  Character newChar;
+  if (!CacheCharacter(letter, style, &newChar))
+  { // unable to cache character - try clearing them all out and starting over
+    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+    ClearCharacterCache();
+    if (!CacheCharacter(letter, style, &newChar))
+    {
+      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
+      if (nestedBeginCount) Begin();
+      m_nestedBeginCount = nestedBeginCount;
+      return NULL;
+    }
   }
-  // if we get to here, then low is where we should insert the new character
+  if (nestedBeginCount) Begin();
+  m_nestedBeginCount = nestedBeginCount;
+
+  // caching may have evicted other characters, so find our place again
+  low = FindCharacter(ch);
 
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
@@ -654,26 +763,8 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   { // just move the data along as necessary
     memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
   }
-  // render the character to our texture
-  // must End() as we can't render text to our texture during a Begin(), End() block
-  unsigned int nestedBeginCount = m_nestedBeginCount;
-  m_nestedBeginCount = 1;
-  if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
-    {
-      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
-    }
-  }
-  if (nestedBeginCount) Begin();
-  m_nestedBeginCount = nestedBeginCount;
+  m_char[low] = newChar;
+  m_numChars++;
 
   // fixup quick access
   memset(m_charquick, 0, sizeof(m_charquick));
@@ -689,8 +780,68 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   return m_char + low;
 }
 
+int CGUIFontTTFBase::FindCharacter(character_t letterAndStyle) const
+{
+  int low = 0;
+  int high = m_numChars - 1;
+  while (low <= high)
+  {
+    int mid = (low + high) >> 1;
+    if (letterAndStyle > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else if (letterAndStyle < m_char[mid].letterAndStyle)
+      high = mid - 1;
+    else
+      return mid;
+  }
+  // if we get to here, then low is where the character should be inserted
+  return low;
+}
+
+bool CGUIFontTTFBase::EvictCharacters()
+{
+  // characters used by the text being laid out right now can't go
+  std::vector<unsigned int> ages;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].slotWidth && m_char[i].lastUsed != m_glyphStamp)
+      ages.push_back(m_char[i].lastUsed - m_glyphStamp);
+  }
+  if (ages.empty())
+    return false;
+
+  // drop the least recently used characters
+  size_t count = std::max<size_t>(ages.size() / CHAR_EVICT_DIVISOR, 1);
+  std::nth_element(ages.begin(), ages.begin() + count - 1, ages.end());
+  unsigned int limit = ages[count - 1];
+
+  int kept = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    const Character &ch = m_char[i];
+    if (ch.slotWidth && ch.lastUsed != m_glyphStamp && ch.lastUsed - m_glyphStamp <= limit)
+      m_atlas.Release(ch.slotX, ch.slotY, ch.slotWidth);
+    else
+      m_char[kept++] = ch;
+  }
+  CLog::Log(LOGDEBUG, "%s: Evicted %i of %i characters", __FUNCTION__, m_numChars - kept, m_numChars);
+  m_numChars = kept;
+  memset(m_charquick, 0, sizeof(m_charquick));
+  m_atlasReused = true;
+
+  // cached vertices may point at the released texture space
+  m_staticCache.Flush();
+  m_dynamicCache.Flush();
+  return true;
+}
+
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
+  GUIPROFILER_ZONE("CGUIFontTTF::CacheCharacter");
+  // the face is shared with the other sizes of this font
+  CSingleLock lock(g_freeTypeLibrary.GetSection());
+  FT_Activate_Size(m_size);
+
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
   FT_Glyph glyph = NULL;
@@ -726,46 +877,43 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   FT_Bitmap bitmap = bitGlyph->bitmap;
   bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
+  unsigned int slotX = 0, slotY = 0;
+  unsigned int slotWidth = bitmap.width + spacing_between_characters_in_texture;
+  unsigned int slotHeight = bitmap.rows + spacing_between_characters_in_texture;
+
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
-
-    // check we have enough room for the character.
-    // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
-
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
-      {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > g_Windowing.GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, g_Windowing.GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
+    // check we have enough room for the character, making room by dropping the
+    // least recently used characters when the texture can't grow any further
+    bool allocated = slotWidth <= m_textureWidth && m_atlas.Allocate(slotWidth, slotHeight, slotX, slotY);
+    while (!allocated && slotWidth <= m_textureWidth && EvictCharacters())
+      allocated = m_atlas.Allocate(slotWidth, slotHeight, slotX, slotY);
+    if (!allocated)
+    {
+      CLog::Log(LOGDEBUG, "%s: No room left in the cache texture for character %x", __FUNCTION__, letter);
+      FT_Done_Glyph(glyph);
+      return false;
+    }
 
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+    if (m_atlas.GetUsedHeight() > m_textureHeight)
+    {
+      // create the new larger texture
+      unsigned int newHeight = m_atlas.GetUsedHeight();
+      CBaseTexture* newTexture = NULL;
+      newTexture = ReallocTexture(newHeight);
+      if(newTexture == NULL)
+      {
+        m_atlas.Release(slotX, slotY, slotWidth);
+        FT_Done_Glyph(glyph);
+        CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
+        return false;
       }
+      m_texture = newTexture;
     }
 
     if(m_texture == NULL)
     {
+      m_atlas.Release(slotX, slotY, slotWidth);
       FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
@@ -775,25 +923,38 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   ch->letterAndStyle = (style << 16) | letter;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
-  ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
-  ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
+  ch->left = isEmptyGlyph ? 0 : (float)slotX;
+  ch->top = isEmptyGlyph ? 0 : (float)slotY;
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
   ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->slotX = slotX;
+  ch->slotY = slotY;
+  ch->slotWidth = isEmptyGlyph ? 0 : slotWidth;
+  ch->lastUsed = m_glyphStamp;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
   {
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
-  
-    m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
+    unsigned int x2 = std::min(slotX + slotWidth, m_textureWidth);
+    unsigned int y2 = std::min(slotY + slotHeight, m_textureHeight);
+
+    // space released by evicted characters still holds their pixels
+    if (m_atlasReused)
+    {
+      std::vector<unsigned char> empty(slotWidth * slotHeight);
+      FT_BitmapGlyphRec emptyGlyph;
+      memset(&emptyGlyph, 0, sizeof(emptyGlyph));
+      emptyGlyph.bitmap.width = slotWidth;
+      emptyGlyph.bitmap.rows = slotHeight;
+      emptyGlyph.bitmap.pitch = slotWidth;
+      emptyGlyph.bitmap.buffer = empty.data();
+      CopyCharToTexture(&emptyGlyph, slotX, slotY, x2, y2);
+    }
+
+    CopyCharToTexture(bitGlyph, slotX, slotY, std::min(slotX + bitmap.width, m_textureWidth), std::min(slotY + bitmap.rows, m_textureHeight));
   }
-  m_numChars++;
 
   // free the glyph
   FT_Done_Glyph(glyph);
@@ -980,7 +1141,7 @@ void CGUIFontTTFBase::SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength)
 
   /* some reasonable strength */
   FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / glyphStrength;
+                    m_size->metrics.y_scale ) / glyphStrength;
 
   FT_BBox bbox_before, bbox_after;
   FT_Outline_Get_CBox( &slot->outline, &bbox_before );
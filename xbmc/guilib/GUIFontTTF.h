@@ -31,8 +31,8 @@
 #include <stdint.h>
 #include <vector>
 
-#include "utils/auto_buffer.h"
 #include "Geometry.h"
+#include "GUIFontAtlas.h"
 
 #ifdef HAS_DX
 #include "DirectXMath.h"
@@ -47,12 +47,14 @@ constexpr size_t LOOKUPTABLE_SIZE = 256 * 8;
 class CBaseTexture;
 
 struct FT_FaceRec_;
+struct FT_SizeRec_;
 struct FT_LibraryRec_;
 struct FT_GlyphSlotRec_;
 struct FT_BitmapGlyphRec_;
 struct FT_StrokerRec_;
 
 typedef struct FT_FaceRec_ *FT_Face;
+typedef struct FT_SizeRec_ *FT_Size;
 typedef struct FT_LibraryRec_ *FT_Library;
 typedef struct FT_GlyphSlotRec_ *FT_GlyphSlot;
 typedef struct FT_BitmapGlyphRec_ *FT_BitmapGlyph;
@@ -111,6 +113,9 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    unsigned short slotX, slotY;   // space reserved in the texture
+    unsigned short slotWidth;      // 0 if the character has no pixels
+    unsigned int lastUsed;         // glyph stamp of the last text using this character
   };
   void AddReference();
   void RemoveReference();
@@ -130,7 +135,9 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
+  int FindCharacter(character_t letterAndStyle) const;
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool EvictCharacters();
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
@@ -146,13 +153,9 @@ protected:
 
   unsigned int m_textureWidth;       // width of our texture
   unsigned int m_textureHeight;      // height of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
+  CGUIFontAtlas m_atlas;             // placement of the characters in the texture
+  bool m_atlasReused;                // whether space of evicted characters is being reused
 
-  /*! \brief the height of each line in the texture.
-   Accounts for spacing between lines to avoid characters overlapping.
-   */
-  unsigned int GetTextureLineHeight() const;
   static const unsigned int spacing_between_characters_in_texture;
 
   color_t m_color;
@@ -161,6 +164,7 @@ protected:
   Character *m_charquick[LOOKUPTABLE_SIZE];     // ascii chars (7 styles) here
   int m_maxChars;                    // size of character array (can be incremented)
   int m_numChars;                    // the current number of cached characters
+  unsigned int m_glyphStamp;         // incremented for each text that is laid out
 
   float m_ellipsesWidth;               // this is used every character (width of '.')
 
@@ -170,7 +174,8 @@ protected:
   unsigned int m_nestedBeginCount;             // speedups
 
   // freetype stuff
-  FT_Face    m_face;
+  FT_Face    m_face;                 // shared by all sizes of the font
+  FT_Size    m_size;
   FT_Stroker m_stroker;
 
   float m_originX;
@@ -194,10 +199,10 @@ protected:
   float    m_textureScaleY;
 
   std::string m_strFileName;
-  XUTILS::auto_buffer m_fontFileInMemory; // used only in some cases, see CFreeTypeLibrary::GetFont()
 
   CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue> m_staticCache;
   CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue> m_dynamicCache;
+  CGUIFontWidthCache m_widthCache;
 
 private:
   virtual bool FirstBegin() = 0;
@@ -20,6 +20,7 @@
 
 #include "GUIFontTTFDX.h"
 #include "GUIFontManager.h"
+#include "GUIRenderBatch.h"
 #include "GUIShaderDX.h"
 #include "Texture.h"
 #include "windowing/WindowingFactory.h"
@@ -117,6 +118,7 @@ void CGUIFontTTFDX::LastEnd()
 
       // 6 indices and 4 vertices per character 
       pGUIShader->DrawIndexed(count * 6, 0, character * 4);
+      CGUIRenderBatch::GetInstance().CountDrawCall(count);
     }
   }
 
@@ -164,6 +166,7 @@ void CGUIFontTTFDX::LastEnd()
 
         // 6 indices and 4 vertices per character 
         pGUIShader->DrawIndexed(count * 6, 0, character * 4);
+        CGUIRenderBatch::GetInstance().CountDrawCall(count);
       }
     }
 
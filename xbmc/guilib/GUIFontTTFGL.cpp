@@ -25,6 +25,7 @@
 #include "Texture.h"
 #include "TextureManager.h"
 #include "GraphicContext.h"
+#include "GUIRenderBatch.h"
 #include "gui3d.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -154,6 +155,7 @@ void CGUIFontTTFGL::LastEnd()
   glEnableClientState(GL_VERTEX_ARRAY);
   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
   glDrawArrays(GL_QUADS, 0, m_vertex.size());
+  CGUIRenderBatch::GetInstance().CountDrawCall(m_vertex.size() / 4);
   glPopClientAttrib();
 
   glActiveTexture(GL_TEXTURE1);
@@ -203,6 +205,7 @@ void CGUIFontTTFGL::LastEnd()
     glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
 
     glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    CGUIRenderBatch::GetInstance().CountDrawCall(vecVertices.size() / 6);
   }
   if (!m_vertexTrans.empty())
   {
@@ -249,6 +252,7 @@ void CGUIFontTTFGL::LastEnd()
         glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
 
         glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+        CGUIRenderBatch::GetInstance().CountDrawCall(count);
       }
 
       glMatrixModview.Pop();
@@ -0,0 +1,190 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFrameProfiler.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+std::atomic<bool> CGUIFrameProfiler::m_tracing(false);
+
+CGUIFrameProfiler::CGUIFrameProfiler()
+  : m_lastFrame(0)
+  , m_historyPos(0)
+  , m_historyCount(0)
+  , m_traceFrames(0)
+  , m_traceStart(0)
+  , m_renderThread(-1)
+{
+  memset(m_history, 0, sizeof(m_history));
+  memset(m_buckets, 0, sizeof(m_buckets));
+}
+
+CGUIFrameProfiler &CGUIFrameProfiler::GetInstance()
+{
+  static CGUIFrameProfiler profiler;
+  return profiler;
+}
+
+void CGUIFrameProfiler::StartTrace(const std::string &outputFile, unsigned int frames)
+{
+  CSingleLock lock(m_section);
+  if (m_tracing || outputFile.empty() || !frames)
+    return;
+
+  m_outputFile = outputFile;
+  m_traceFrames = frames;
+  m_traceStart = CurrentHostCounter();
+  m_events.clear();
+  m_events.reserve(std::min(frames * 256, MAX_EVENTS));
+  m_threads.clear();
+  m_renderThread = -1;
+  m_tracing = true;
+  CLog::Log(LOGNOTICE, "CGUIFrameProfiler::StartTrace - recording %u frames", frames);
+}
+
+void CGUIFrameProfiler::StopTrace()
+{
+  CSingleLock lock(m_section);
+  if (!m_tracing)
+    return;
+
+  m_tracing = false;
+
+  // hand the events over to a job, writing them out takes far longer than a frame
+  std::shared_ptr<Trace> trace(new Trace);
+  trace->outputFile = m_outputFile;
+  trace->events.swap(m_events);
+  trace->start = m_traceStart;
+  trace->renderThread = m_renderThread;
+  m_threads.clear();
+
+  CJobManager::GetInstance().Submit([trace]() {
+    if (!SaveTrace(*trace))
+      CLog::Log(LOGERROR, "CGUIFrameProfiler::StopTrace - unable to write trace to %s", trace->outputFile.c_str());
+    else
+      CLog::Log(LOGNOTICE, "CGUIFrameProfiler::StopTrace - wrote %u events to %s", static_cast<unsigned int>(trace->events.size()), trace->outputFile.c_str());
+  });
+}
+
+int CGUIFrameProfiler::GetThreadIndex()
+{
+  std::thread::id id = std::this_thread::get_id();
+  std::vector<std::thread::id>::const_iterator it = std::find(m_threads.begin(), m_threads.end(), id);
+  if (it != m_threads.end())
+    return static_cast<int>(it - m_threads.begin());
+
+  m_threads.push_back(id);
+  return static_cast<int>(m_threads.size() - 1);
+}
+
+void CGUIFrameProfiler::AddZone(const char *name, int64_t start, int64_t end)
+{
+  CSingleLock lock(m_section);
+  if (!m_tracing || m_events.size() >= MAX_EVENTS)
+    return;
+
+  TraceEvent event = { name, start, end, GetThreadIndex() };
+  m_events.push_back(event);
+}
+
+void CGUIFrameProfiler::EndFrame()
+{
+  int64_t now = CurrentHostCounter();
+
+  CSingleLock lock(m_section);
+  if (m_lastFrame)
+  {
+    unsigned int frameTime = static_cast<unsigned int>((now - m_lastFrame) * 1000000 / CurrentHostFrequency());
+
+    // the histogram covers the frames in the history, so drop the one falling out of it
+    if (m_historyCount == HISTORY_SIZE)
+      m_buckets[std::min(m_history[m_historyPos] / 1000, BUCKET_COUNT - 1)]--;
+    else
+      m_historyCount++;
+
+    m_history[m_historyPos] = frameTime;
+    m_historyPos = (m_historyPos + 1) % HISTORY_SIZE;
+    m_buckets[std::min(frameTime / 1000, BUCKET_COUNT - 1)]++;
+
+    if (m_tracing)
+    {
+      m_renderThread = GetThreadIndex();
+      AddZone("Frame", m_lastFrame, now);
+      if (--m_traceFrames == 0)
+        StopTrace();
+    }
+  }
+  m_lastFrame = now;
+}
+
+std::string CGUIFrameProfiler::GetFrameTimeSummary() const
+{
+  CSingleLock lock(m_section);
+  if (!m_historyCount)
+    return "";
+
+  static const unsigned int percentiles[] = { 50, 95, 99 };
+  unsigned int results[3] = { 0, 0, 0 };
+  unsigned int seen = 0;
+  unsigned int p = 0;
+  for (unsigned int bucket = 0; bucket < BUCKET_COUNT && p < 3; ++bucket)
+  {
+    seen += m_buckets[bucket];
+    while (p < 3 && seen * 100 >= m_historyCount * percentiles[p])
+      results[p++] = bucket + 1;
+  }
+
+  unsigned int slowest = *std::max_element(m_history, m_history + m_historyCount);
+  return StringUtils::Format("FRAME: 50%% <%ums 95%% <%ums 99%% <%ums, max %.1fms%s",
+                             results[0], results[1], results[2], slowest / 1000.0f,
+                             m_tracing ? " (tracing)" : "");
+}
+
+bool CGUIFrameProfiler::SaveTrace(const Trace &trace)
+{
+  XFILE::CFile file;
+  if (!file.OpenForWrite(trace.outputFile, true))
+    return false;
+
+  double scale = 1000000.0 / CurrentHostFrequency();
+  std::string out = "{\"traceEvents\":[\n";
+  out += StringUtils::Format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"render\"}}",
+                             std::max(trace.renderThread, 0));
+  for (std::vector<TraceEvent>::const_iterator it = trace.events.begin(); it != trace.events.end(); ++it)
+  {
+    out += StringUtils::Format(",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.1f,\"dur\":%.1f}",
+                               it->name, it->thread, (it->start - trace.start) * scale, (it->end - it->start) * scale);
+    if (out.size() > 65536)
+    {
+      if (file.Write(out.c_str(), out.size()) != static_cast<ssize_t>(out.size()))
+        return false;
+      out.clear();
+    }
+  }
+  out += "\n]}\n";
+  return file.Write(out.c_str(), out.size()) == static_cast<ssize_t>(out.size());
+}
@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "utils/TimeUtils.h"
+
+/*!
+ \ingroup guilib
+ \brief Frame time histogram and trace recorder for the render loop.
+
+ Frame times are always collected, it costs one timestamp per frame. Zones are only recorded
+ while a trace is running, and are written out in the Chrome trace event format which can be
+ opened in chrome://tracing or ui.perfetto.dev.
+ */
+class CGUIFrameProfiler
+{
+public:
+  static CGUIFrameProfiler &GetInstance();
+  static bool IsTracing() { return m_tracing; }
+
+  /*!
+   \brief Record a trace of the next frames.
+   \param outputFile file the trace is written to once done.
+   \param frames number of frames to record.
+   */
+  void StartTrace(const std::string &outputFile, unsigned int frames);
+  void StopTrace();
+
+  void AddZone(const char *name, int64_t start, int64_t end);
+  void EndFrame(); ///< called once a frame has been presented
+
+  /*! \brief Frame time percentiles over the last few seconds, for the debug overlay */
+  std::string GetFrameTimeSummary() const;
+
+private:
+  CGUIFrameProfiler();
+  CGUIFrameProfiler(const CGUIFrameProfiler&) = delete;
+  CGUIFrameProfiler &operator=(const CGUIFrameProfiler&) = delete;
+
+  int GetThreadIndex();
+
+  static const unsigned int HISTORY_SIZE = 600;   ///< 10 seconds at 60fps
+  static const unsigned int BUCKET_COUNT = 100;   ///< 1ms buckets, the last one holds everything slower
+  static const unsigned int MAX_EVENTS = 1 << 20;
+
+  struct TraceEvent
+  {
+    const char *name;
+    int64_t start;
+    int64_t end;
+    int thread;
+  };
+
+  struct Trace
+  {
+    std::string outputFile;
+    std::vector<TraceEvent> events;
+    int64_t start;
+    int renderThread;
+  };
+
+  /*! \brief Write a finished trace, runs as a job so the render thread is not held up by the file io */
+  static bool SaveTrace(const Trace &trace);
+
+  static std::atomic<bool> m_tracing; ///< read by any thread opening a zone
+
+  mutable CCriticalSection m_section;
+  int64_t m_lastFrame;
+  unsigned int m_history[HISTORY_SIZE]; ///< frame times in microseconds
+  unsigned int m_historyPos;
+  unsigned int m_historyCount;
+  unsigned int m_buckets[BUCKET_COUNT];
+
+  std::vector<TraceEvent> m_events;
+  std::vector<std::thread::id> m_threads;
+  std::string m_outputFile;
+  unsigned int m_traceFrames;
+  int64_t m_traceStart;
+  int m_renderThread;
+};
+
+/*!
+ \ingroup guilib
+ \brief Records the lifetime of a scope as a zone in the current trace.
+ \param name name of the zone, must be a string literal as it is stored as is.
+ */
+class CGUIFrameProfilerZone
+{
+public:
+  explicit CGUIFrameProfilerZone(const char *name)
+    : m_name(name), m_start(CGUIFrameProfiler::IsTracing() ? CurrentHostCounter() : 0)
+  {
+  }
+  ~CGUIFrameProfilerZone()
+  {
+    if (m_start)
+      CGUIFrameProfiler::GetInstance().AddZone(m_name, m_start, CurrentHostCounter());
+  }
+
+private:
+  const char *m_name;
+  int64_t m_start;
+};
+
+#define GUIPROFILER_ZONE(name) CGUIFrameProfilerZone guiProfilerZone(name)
@@ -167,6 +167,13 @@ void CGUIImage::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
+bool CGUIImage::CanSkipProcess() const
+{
+  // a settled, single frame image with a fixed source has nothing left to do
+  return IsProcessStable() && IsVisible() && m_info.IsConstant() && m_fadingTextures.empty() &&
+         m_texture.ReadyToRender() && !m_texture.IsAnimated();
+}
+
 void CGUIImage::Render()
 {
   if (!IsVisible()) return;
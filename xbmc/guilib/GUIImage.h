@@ -104,6 +104,7 @@ public:
   void DumpTextureUse() override;
 #endif
 protected:
+  bool CanSkipProcess() const override;
   virtual void AllocateOnDemand();
   virtual void FreeTextures(bool immediately = false);
   void FreeResourcesButNotAnims();
@@ -64,6 +64,7 @@ public:
 
   bool Update();
   void Parse(const std::string &label, int context);
+  bool IsConstant() const { return m_info == 0; };
 
 private:
   color_t GetColor() const;
@@ -101,6 +101,15 @@ bool CGUILabel::Process(unsigned int currentTime)
   return false;
 }
 
+bool CGUILabel::IsStatic() const
+{
+  bool overFlows = (m_renderRect.Width() + 0.5f < m_textLayout.GetTextWidth());
+  if (overFlows && m_scrolling)
+    return false;
+
+  return m_label.IsConstant();
+}
+
 void CGUILabel::Render()
 {
   color_t color = GetColor();
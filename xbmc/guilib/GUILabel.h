@@ -56,6 +56,12 @@ public:
 
     return changed;
   };
+
+  bool IsConstant() const
+  {
+    return textColor.IsConstant() && shadowColor.IsConstant() && selectedColor.IsConstant() &&
+           disabledColor.IsConstant() && focusedColor.IsConstant() && invalidColor.IsConstant();
+  };
   
   CGUIInfoColor textColor;
   CGUIInfoColor shadowColor;
@@ -191,6 +197,11 @@ public:
    \sa SetMaxRect
    */
   float GetMaxWidth() const;
+
+  /*! \brief Whether the label looks the same every frame until its text, colors or layout are changed
+   \return false if the label is scrolling or has info driven colors
+   */
+  bool IsStatic() const;
   
   /*! \brief Calculates the width of some text
    \param text std::wstring of text whose width we want
@@ -41,6 +41,9 @@ CGUILabelControl::~CGUILabelControl(void) = default;
 
 void CGUILabelControl::ShowCursor(bool bShow)
 {
+  if (m_bShowCursor != bShow)
+    SetInvalid();
+
   m_bShowCursor = bShow;
 }
 
@@ -61,6 +64,7 @@ void CGUILabelControl::SetCursorPos(int iPos)
 void CGUILabelControl::SetInfo(const CGUIInfoLabel &infoLabel)
 {
   m_infoLabel = infoLabel;
+  SetInvalid();
 }
 
 bool CGUILabelControl::UpdateColors()
@@ -134,6 +138,12 @@ void CGUILabelControl::Process(unsigned int currentTime, CDirtyRegionList &dirty
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
+bool CGUILabelControl::CanSkipProcess() const
+{
+  // the cursor blinks, everything else comes in through setters which invalidate us
+  return IsProcessStable() && !m_bShowCursor && m_infoLabel.IsConstant() && m_label.IsStatic();
+}
+
 CRect CGUILabelControl::CalcRenderRegion() const
 {
   return m_label.GetRenderRect();
@@ -273,12 +283,18 @@ std::string CGUILabelControl::ShortenPath(const std::string &path)
 
 void CGUILabelControl::SetHighlight(unsigned int start, unsigned int end)
 {
+  if (m_startHighlight != start || m_endHighlight != end)
+    SetInvalid();
+
   m_startHighlight = start;
   m_endHighlight = end;
 }
 
 void CGUILabelControl::SetSelection(unsigned int start, unsigned int end)
 {
+  if (m_startSelection != start || m_endSelection != end)
+    SetInvalid();
+
   m_startSelection = start;
   m_endSelection = end;
 }
@@ -66,6 +66,7 @@ public:
 
 protected:
   bool UpdateColors() override;
+  bool CanSkipProcess() const override;
   std::string ShortenPath(const std::string &path);
 
   /*! \brief Return the maximum width of this label control.
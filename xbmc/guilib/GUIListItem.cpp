@@ -20,17 +20,76 @@
 
 #include "GUIListItem.h"
 
+#include <atomic>
 #include <utility>
 
 #include "GUIListItemLayout.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
-bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string &s2) const
+namespace
 {
-  return StringUtils::CompareNoCase(s1, s2) < 0;
+// skins and core use a few hundred distinct keys, add-ons and backends may set any number of
+// arbitrary ones, so only the first keys seen are interned
+const size_t MAX_PROPERTY_KEYS = 4096;
+const size_t PROPERTY_KEY_SLOTS = 2 * MAX_PROPERTY_KEYS; // power of two, and never full
+
+// open addressing table of interned keys. keys are only ever added, so lookups can probe it
+// without locking
+std::atomic<const std::string*> propertyKeys[PROPERTY_KEY_SLOTS];
+size_t propertyKeyCount = 0;
+CCriticalSection propertyKeysSection;
+
+size_t PropertyKeyHash(const std::string &key)
+{
+  size_t hash = 5381;
+  for (std::string::const_iterator i = key.begin(); i != key.end(); ++i)
+    hash = hash * 33 + ::tolower(static_cast<unsigned char>(*i));
+  return hash;
+}
+
+// returns the slot holding the key, or the empty slot it would be added to
+size_t FindPropertyKeySlot(const std::string &key, size_t hash, const std::string *&found)
+{
+  for (size_t slot = hash & (PROPERTY_KEY_SLOTS - 1); ; slot = (slot + 1) & (PROPERTY_KEY_SLOTS - 1))
+  {
+    found = propertyKeys[slot].load(std::memory_order_acquire);
+    if (!found || StringUtils::EqualsNoCase(*found, key))
+      return slot;
+  }
+}
+}
+
+const std::string *CGUIListItem::GetPropertyKey(const std::string &strKey, bool add)
+{
+  size_t hash = PropertyKeyHash(strKey);
+  const std::string *key;
+  FindPropertyKeySlot(strKey, hash, key);
+  if (key || !add)
+    return key;
+
+  CSingleLock lock(propertyKeysSection);
+  // probe again, it may have been added meanwhile
+  size_t slot = FindPropertyKeySlot(strKey, hash, key);
+  if (key || propertyKeyCount >= MAX_PROPERTY_KEYS)
+    return key;
+
+  key = new std::string(strKey);
+  propertyKeys[slot].store(key, std::memory_order_release);
+  propertyKeyCount++;
+  return key;
+}
+
+void CGUIListItem::ResetPropertyKeys()
+{
+  CSingleLock lock(propertyKeysSection);
+  for (size_t slot = 0; slot < PROPERTY_KEY_SLOTS; slot++)
+    delete propertyKeys[slot].exchange(NULL);
+  propertyKeyCount = 0;
 }
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
@@ -243,7 +302,7 @@ CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_strIcon = item.m_strIcon;
   m_overlayIcon = item.m_overlayIcon;
   m_bIsFolder = item.m_bIsFolder;
-  m_mapProperties = item.m_mapProperties;
+  m_properties = item.m_properties;
   m_art = item.m_art;
   m_artFallbacks = item.m_artFallbacks;
   SetInvalid();
@@ -261,10 +320,10 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << m_strIcon;
     ar << m_bSelected;
     ar << m_overlayIcon;
-    ar << (int)m_mapProperties.size();
-    for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
+    ar << (int)m_properties.size();
+    for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); ++it)
     {
-      ar << it->first;
+      ar << it->first.GetName();
       ar << it->second;
     }
     ar << (int)m_art.size();
@@ -331,9 +390,9 @@ void CGUIListItem::Serialize(CVariant &value)
   value["strIcon"] = m_strIcon;
   value["selected"] = m_bSelected;
 
-  for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
+  for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); ++it)
   {
-    value["properties"][it->first] = it->second;
+    value["properties"][it->first.GetName()] = it->second;
   }
   for (ArtMap::const_iterator it = m_art.begin(); it != m_art.end(); ++it)
     value["art"][it->first] = it->second;
@@ -385,6 +444,20 @@ CGUIListItemLayout *CGUIListItem::GetFocusedLayout()
   return m_focusedLayout;
 }
 
+CGUIListItemLayout *CGUIListItem::ReleaseLayout()
+{
+  CGUIListItemLayout *layout = m_layout;
+  m_layout = NULL;
+  return layout;
+}
+
+CGUIListItemLayout *CGUIListItem::ReleaseFocusedLayout()
+{
+  CGUIListItemLayout *layout = m_focusedLayout;
+  m_focusedLayout = NULL;
+  return layout;
+}
+
 void CGUIListItem::SetInvalid()
 {
   if (m_layout) m_layout->SetInvalid();
@@ -393,54 +466,82 @@ void CGUIListItem::SetInvalid()
 
 void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  SetProperty(strKey, GetPropertyKey(strKey, true), value);
+}
+
+CGUIListItem::PropertyList::iterator CGUIListItem::FindProperty(const std::string &strKey, const std::string *key)
+{
+  for (PropertyList::iterator iter = m_properties.begin(); iter != m_properties.end(); ++iter)
   {
-    m_mapProperties.insert(make_pair(strKey, value));
-    SetInvalid();
+    // a key that can be interned is never stored by name, and vice versa
+    if (key ? iter->first.key == key : !iter->first.key && StringUtils::EqualsNoCase(iter->first.name, strKey))
+      return iter;
   }
-  else if (iter->second != value)
+  return m_properties.end();
+}
+
+CGUIListItem::PropertyList::const_iterator CGUIListItem::FindProperty(const std::string &strKey, const std::string *key) const
+{
+  return const_cast<CGUIListItem*>(this)->FindProperty(strKey, key);
+}
+
+void CGUIListItem::SetProperty(const std::string &strKey, const std::string *key, const CVariant &value)
+{
+  PropertyList::iterator iter = FindProperty(strKey, key);
+  if (iter != m_properties.end())
   {
-    iter->second = value;
-    SetInvalid();
+    if (iter->second != value)
+    {
+      iter->second = value;
+      SetInvalid();
+    }
+    return;
   }
+
+  // as with a case insensitive map, the spelling the property was added with is kept
+  PropertyKey propertyKey;
+  propertyKey.key = key;
+  if (!key || *key != strKey)
+    propertyKey.name = strKey;
+  m_properties.push_back(std::make_pair(propertyKey, value));
+  SetInvalid();
 }
 
 const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
   static CVariant nullVariant = CVariant(CVariant::VariantTypeNull);
-  
-  if (iter == m_mapProperties.end())
-    return nullVariant;
 
-  return iter->second;
+  PropertyList::const_iterator iter = FindProperty(strKey, GetPropertyKey(strKey, false));
+  if (iter != m_properties.end())
+    return iter->second;
+  return nullVariant;
 }
 
-bool CGUIListItem::HasProperty(const std::string &strKey) const
+bool CGUIListItem::HasProperties() const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
-    return false;
+  return !m_properties.empty();
+}
 
-  return true;
+bool CGUIListItem::HasProperty(const std::string &strKey) const
+{
+  return FindProperty(strKey, GetPropertyKey(strKey, false)) != m_properties.end();
 }
 
 void CGUIListItem::ClearProperty(const std::string &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
+  PropertyList::iterator iter = FindProperty(strKey, GetPropertyKey(strKey, false));
+  if (iter != m_properties.end())
   {
-    m_mapProperties.erase(iter);
+    m_properties.erase(iter);
     SetInvalid();
   }
 }
 
 void CGUIListItem::ClearProperties()
 {
-  if (!m_mapProperties.empty())
+  if (!m_properties.empty())
   {
-    m_mapProperties.clear();
+    m_properties.clear();
     SetInvalid();
   }
 }
@@ -461,6 +562,6 @@ void CGUIListItem::IncrementProperty(const std::string &strKey, double dVal)
 
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
-  for (PropertyMap::const_iterator i = item.m_mapProperties.begin(); i != item.m_mapProperties.end(); ++i)
-    SetProperty(i->first, i->second);
+  for (PropertyList::const_iterator i = item.m_properties.begin(); i != item.m_properties.end(); ++i)
+    SetProperty(i->first.GetName(), i->first.key, i->second);
 }
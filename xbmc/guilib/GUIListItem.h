@@ -30,6 +30,8 @@
 
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 //  Forward
 class CGUIListItemLayout;
@@ -148,6 +150,12 @@ public:
   void SetFocusedLayout(CGUIListItemLayout *layout);
   CGUIListItemLayout *GetFocusedLayout();
 
+  /*! \brief Detach the layouts from this item without freeing them, passing ownership to the caller.
+   \return the detached layout, or NULL if the item had none.
+   */
+  CGUIListItemLayout *ReleaseLayout();
+  CGUIListItemLayout *ReleaseFocusedLayout();
+
   void FreeIcons();
   void FreeMemory(bool immediately = false);
   void SetInvalid();
@@ -172,11 +180,17 @@ public:
   void Serialize(CVariant& value);
 
   bool       HasProperty(const std::string &strKey) const;
-  bool       HasProperties() const { return !m_mapProperties.empty(); };
+  bool       HasProperties() const;
   void       ClearProperty(const std::string &strKey);
 
   const CVariant &GetProperty(const std::string &strKey) const;
 
+  /*! \brief Forget all interned property keys, for tests only.
+   No items may be left that hold properties when this is called, as their keys are freed.
+   \sa GetPropertyKey
+   */
+  static void ResetPropertyKeys();
+
 protected:
   std::string m_strLabel2;     // text of column2
   std::string m_strIcon;      // filename of icon
@@ -186,13 +200,34 @@ protected:
   CGUIListItemLayout *m_focusedLayout;
   bool m_bSelected;     // item is selected or not
 
-  struct icompare
+  struct PropertyKey
   {
-    bool operator()(const std::string &s1, const std::string &s2) const;
+    const std::string *key; ///< interned key, NULL if the key couldn't be interned
+    std::string name;       ///< the key as set, if it couldn't be interned or is spelled differently
+
+    const std::string &GetName() const { return key && name.empty() ? *key : name; }
   };
 
-  typedef std::map<std::string, CVariant, icompare> PropertyMap;
-  PropertyMap m_mapProperties;
+  /*! \brief Properties, mostly keyed by interned keys
+   Interned keys are shared by all items and compared by address, so an item's properties are
+   a small flat list rather than a map holding its own copy of every key.
+   \sa GetPropertyKey
+   */
+  typedef std::vector<std::pair<PropertyKey, CVariant> > PropertyList;
+  PropertyList m_properties;
+
+  /*! \brief Get the interned key for a property
+   Keys are case insensitive, items keep the spelling they set a key with. Only a limited number
+   of keys is interned, as add-ons and backends may set any number of arbitrary keys; once the
+   limit is reached, further keys are stored with each item instead. Looking up a key doesn't lock.
+   \param strKey the key of the property
+   \param add whether to add the key if it isn't interned yet
+   \return the interned key, NULL if it isn't (and can't be) interned
+   */
+  static const std::string *GetPropertyKey(const std::string &strKey, bool add);
+  PropertyList::iterator FindProperty(const std::string &strKey, const std::string *key);
+  PropertyList::const_iterator FindProperty(const std::string &strKey, const std::string *key) const;
+  void SetProperty(const std::string &strKey, const std::string *key, const CVariant &value);
 private:
   std::wstring m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   std::string m_strLabel;      // text of column1
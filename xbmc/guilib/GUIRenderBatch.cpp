@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIRenderBatch.h"
+
+#include <algorithm>
+
+#include "utils/StringUtils.h"
+
+CGUIRenderBatch &CGUIRenderBatch::GetInstance()
+{
+  static CGUIRenderBatch batch;
+  return batch;
+}
+
+void CGUIRenderBatch::Add(const State &state, const PackedVertices &vertices)
+{
+  unsigned int quads = vertices.size() / 4;
+  if (!quads || !m_backend)
+    return;
+
+  CRect bounds(vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y);
+  for (const auto &vertex : vertices)
+  {
+    bounds.x1 = std::min(bounds.x1, vertex.x);
+    bounds.y1 = std::min(bounds.y1, vertex.y);
+    bounds.x2 = std::max(bounds.x2, vertex.x);
+    bounds.y2 = std::max(bounds.y2, vertex.y);
+  }
+
+  // look for a batch with our state that nothing queued after it covers
+  Batch *target = nullptr;
+  unsigned int searched = 0;
+  for (unsigned int i = m_queued; i > 0 && searched < MAX_LOOKBEHIND; i--, searched++)
+  {
+    Batch &batch = m_batches[i - 1];
+    if (batch.state == state && (batch.vertices.size() + vertices.size()) / 4 <= MAX_QUADS)
+    {
+      target = &batch;
+      break;
+    }
+    if (!CRect(batch.bounds).Intersect(bounds).IsEmpty())
+      break;
+  }
+
+  if (!target)
+  {
+    if (m_queued == m_batches.size())
+      m_batches.emplace_back();
+    target = &m_batches[m_queued++];
+    target->state = state;
+    target->bounds = bounds;
+    target->vertices.clear();
+  }
+  else
+    target->bounds.Union(bounds);
+
+  target->vertices.insert(target->vertices.end(), vertices.begin(), vertices.end());
+}
+
+void CGUIRenderBatch::Flush()
+{
+  if (!m_queued)
+    return;
+
+  // the backend changes render state itself, which must not flush us again
+  unsigned int queued = m_queued;
+  m_queued = 0;
+  m_drawing.swap(m_batches);
+
+  for (unsigned int i = 0; i < queued; i++)
+  {
+    const Batch &batch = m_drawing[i];
+    m_backend->DrawQuads(batch.state, batch.vertices.data(), batch.vertices.size() / 4);
+  }
+
+  m_drawing.swap(m_batches);
+}
+
+void CGUIRenderBatch::CountDrawCall(unsigned int quads)
+{
+  m_drawCalls++;
+  m_quads += quads;
+}
+
+void CGUIRenderBatch::EndFrame()
+{
+  m_lastDrawCalls = m_drawCalls;
+  m_lastQuads = m_quads;
+  m_drawCalls = 0;
+  m_quads = 0;
+}
+
+std::string CGUIRenderBatch::GetSummary() const
+{
+  return StringUtils::Format("DRAW: %u calls, %u quads", m_lastDrawCalls, m_lastQuads);
+}
@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Geometry.h"
+
+class CBaseTexture;
+
+struct PackedVertex
+{
+  float x, y, z;
+  float u1, v1;
+  float u2, v2;
+};
+typedef std::vector<PackedVertex> PackedVertices;
+
+/*!
+ \ingroup textures
+ \brief Collects the textured quads of a frame and merges those sharing render state into few draws.
+
+ Quads are queued in painter's order. A new set of quads joins an earlier batch with the same
+ state when no batch queued after that one overlaps them on screen, so moving them back can't
+ change what ends up on top. Everything queued is drawn through the backend on Flush(), which the
+ render system calls before any state the batches depend on changes (shader, viewport, scissors,
+ camera, external rendering) and before presenting.
+
+ The batching itself does no rendering, so it runs headless with any backend.
+ */
+class CGUIRenderBatch
+{
+public:
+  struct State
+  {
+    CBaseTexture *texture;
+    CBaseTexture *diffuse;
+    int shader;
+    uint32_t color;
+    bool blend;
+
+    bool operator==(const State &right) const
+    {
+      return texture == right.texture && diffuse == right.diffuse && shader == right.shader &&
+             color == right.color && blend == right.blend;
+    }
+  };
+
+  class IBackend
+  {
+  public:
+    virtual ~IBackend() = default;
+    /*! \brief Draw quads with the given state, 4 vertices per quad. */
+    virtual void DrawQuads(const State &state, const PackedVertex *vertices, unsigned int quads) = 0;
+  };
+
+  static CGUIRenderBatch &GetInstance();
+
+  void SetBackend(IBackend *backend) { m_backend = backend; };
+
+  /*! \brief Queue quads (4 vertices each) to be drawn with the given state.
+   Nothing is queued until a backend has been set.
+   */
+  void Add(const State &state, const PackedVertices &vertices);
+  void Flush();
+
+  /*! \brief Count a draw call made to the GPU, batched or not, for the frame statistics. */
+  void CountDrawCall(unsigned int quads);
+  void EndFrame(); ///< called once a frame has been presented
+
+  unsigned int GetDrawCalls() const { return m_lastDrawCalls; };
+  unsigned int GetQuads() const { return m_lastQuads; };
+  /*! \brief Draw calls and quads of the last frame, for the debug overlay */
+  std::string GetSummary() const;
+
+  static const unsigned int MAX_QUADS = 16384; ///< quads in a single draw, so indices fit in 16 bits
+  static const unsigned int MAX_LOOKBEHIND = 32; ///< batches searched for one to join
+
+private:
+  CGUIRenderBatch() = default;
+  CGUIRenderBatch(const CGUIRenderBatch&) = delete;
+  CGUIRenderBatch &operator=(const CGUIRenderBatch&) = delete;
+
+  struct Batch
+  {
+    State state;
+    CRect bounds;
+    PackedVertices vertices;
+  };
+
+  std::vector<Batch> m_batches;
+  std::vector<Batch> m_drawing; ///< batches being flushed, kept to reuse their memory
+  unsigned int m_queued = 0;    ///< number of batches in use in m_batches
+  IBackend *m_backend = nullptr;
+
+  unsigned int m_drawCalls = 0;
+  unsigned int m_quads = 0;
+  unsigned int m_lastDrawCalls = 0;
+  unsigned int m_lastQuads = 0;
+};
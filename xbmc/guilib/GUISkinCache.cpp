@@ -0,0 +1,422 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#include "GUISkinCache.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+using namespace XFILE;
+
+namespace
+{
+enum NodeTag
+{
+  NODE_ELEMENT = 1,
+  NODE_TEXT,
+  NODE_CDATA
+};
+
+void WriteLength(std::string &out, size_t length)
+{
+  while (length >= 0x80)
+  {
+    out.push_back(static_cast<char>((length & 0x7f) | 0x80));
+    length >>= 7;
+  }
+  out.push_back(static_cast<char>(length));
+}
+
+void WriteString(std::string &out, const char *str)
+{
+  size_t length = str ? strlen(str) : 0;
+  WriteLength(out, length);
+  out.append(str ? str : "", length);
+}
+
+void WriteNode(std::string &out, const TiXmlNode *node)
+{
+  if (const TiXmlText *text = node->ToText())
+  {
+    out.push_back(static_cast<char>(text->CDATA() ? NODE_CDATA : NODE_TEXT));
+    WriteString(out, text->Value());
+    return;
+  }
+
+  const TiXmlElement *element = node->ToElement();
+  out.push_back(static_cast<char>(NODE_ELEMENT));
+  WriteString(out, element->Value());
+
+  size_t attributes = 0;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    attributes++;
+  WriteLength(out, attributes);
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+  {
+    WriteString(out, attribute->Name());
+    WriteString(out, attribute->Value());
+  }
+
+  // comments and other node types carry no meaning for the control factory
+  size_t children = 0;
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->ToElement() || child->ToText())
+      children++;
+  }
+  WriteLength(out, children);
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->ToElement() || child->ToText())
+      WriteNode(out, child);
+  }
+}
+
+class CReader
+{
+public:
+  explicit CReader(const std::string &data) : m_pos(data.data()), m_end(data.data() + data.size()) {}
+
+  bool AtEnd() const { return m_pos == m_end; }
+
+  bool ReadByte(unsigned char &value)
+  {
+    if (m_pos == m_end)
+      return false;
+    value = static_cast<unsigned char>(*m_pos++);
+    return true;
+  }
+
+  bool ReadLength(size_t &length)
+  {
+    length = 0;
+    for (unsigned int shift = 0; shift < sizeof(size_t) * 8; shift += 7)
+    {
+      unsigned char byte;
+      if (!ReadByte(byte))
+        return false;
+      length |= static_cast<size_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool ReadString(std::string &str)
+  {
+    size_t length;
+    if (!ReadLength(length) || length > static_cast<size_t>(m_end - m_pos))
+      return false;
+    str.assign(m_pos, length);
+    m_pos += length;
+    return true;
+  }
+
+private:
+  const char *m_pos;
+  const char *m_end;
+};
+
+// reads an element whose tag has already been consumed
+TiXmlElement *ReadElement(CReader &reader, unsigned int depth)
+{
+  std::string value;
+  if (depth > 256 || !reader.ReadString(value))
+    return nullptr;
+
+  std::unique_ptr<TiXmlElement> element(new TiXmlElement(value));
+
+  size_t count;
+  if (!reader.ReadLength(count))
+    return nullptr;
+  std::string name;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (!reader.ReadString(name) || !reader.ReadString(value))
+      return nullptr;
+    element->SetAttribute(name, value);
+  }
+
+  if (!reader.ReadLength(count))
+    return nullptr;
+  for (size_t i = 0; i < count; i++)
+  {
+    unsigned char tag;
+    if (!reader.ReadByte(tag))
+      return nullptr;
+
+    if (tag == NODE_ELEMENT)
+    {
+      TiXmlElement *child = ReadElement(reader, depth + 1);
+      if (!child)
+        return nullptr;
+      element->LinkEndChild(child);
+    }
+    else if (tag == NODE_TEXT || tag == NODE_CDATA)
+    {
+      if (!reader.ReadString(value))
+        return nullptr;
+      TiXmlText *text = new TiXmlText(value);
+      text->SetCDATA(tag == NODE_CDATA);
+      element->LinkEndChild(text);
+    }
+    else
+      return nullptr;
+  }
+
+  return element.release();
+}
+}
+
+bool CGUISkinCache::Load(const std::string &file, const std::string &skinKey)
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+  m_file = file;
+  m_key = skinKey;
+  m_dirty = false;
+
+  CFile cacheFile;
+  if (!cacheFile.Open(file))
+    return false;
+
+  try
+  {
+    CArchive ar(&cacheFile, CArchive::load);
+    int version = 0;
+    std::string key;
+    int count = 0;
+    ar >> version;
+    if (version != CACHE_VERSION)
+    {
+      CLog::Log(LOGDEBUG, "CGUISkinCache::Load - discarding cache %s with version %d", file.c_str(), version);
+      return false;
+    }
+    ar >> key;
+    if (key != skinKey)
+    {
+      CLog::Log(LOGDEBUG, "CGUISkinCache::Load - discarding cache %s built for a different skin setup", file.c_str());
+      m_dirty = true;
+      return false;
+    }
+    ar >> count;
+
+    // bound the counts by the smallest record they can describe, so a corrupt
+    // count can't allocate more than the file could hold
+    const int64_t length = cacheFile.GetLength();
+    const int64_t dependencyLength = sizeof(uint32_t) + 2 * sizeof(int64_t);
+    const int64_t conditionLength = sizeof(uint32_t) + sizeof(bool);
+    const int64_t entryLength = 4 * sizeof(uint32_t) + dependencyLength;
+    if (count < 0 || count > length / entryLength)
+      throw std::out_of_range("implausible skin cache entry count");
+
+    for (int i = 0; i < count; ++i)
+    {
+      std::string window;
+      CacheEntry entry;
+      int size = 0;
+      ar >> window;
+      ar >> size;
+      // every entry records at least the window file itself
+      if (size <= 0)
+        throw std::out_of_range("skin cache entry without dependencies");
+      if (size > length / dependencyLength)
+        throw std::out_of_range("implausible skin cache dependency count");
+      entry.dependencies.resize(size);
+      for (auto &dependency : entry.dependencies)
+      {
+        ar >> dependency.file;
+        ar >> dependency.size;
+        ar >> dependency.modified;
+      }
+      ar >> size;
+      if (size < 0 || size > length / conditionLength)
+        throw std::out_of_range("implausible skin cache condition count");
+      entry.conditions.resize(size);
+      for (auto &condition : entry.conditions)
+      {
+        ar >> condition.first;
+        ar >> condition.second;
+      }
+      ar >> entry.data;
+      m_entries.insert(std::make_pair(window, std::move(entry)));
+    }
+  }
+  catch (const std::out_of_range &)
+  {
+    CLog::Log(LOGERROR, "CGUISkinCache::Load - cache %s is corrupt", file.c_str());
+    m_entries.clear();
+    m_dirty = true;
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "CGUISkinCache::Load - loaded %u windows from %s", static_cast<unsigned int>(m_entries.size()), file.c_str());
+  return true;
+}
+
+bool CGUISkinCache::Save()
+{
+  CSingleLock lock(m_section);
+  if (!m_dirty || m_file.empty())
+    return true;
+
+  CFile cacheFile;
+  if (!cacheFile.OpenForWrite(m_file, true))
+  {
+    CLog::Log(LOGERROR, "CGUISkinCache::Save - unable to write %s", m_file.c_str());
+    return false;
+  }
+
+  CArchive ar(&cacheFile, CArchive::store);
+  ar << CACHE_VERSION;
+  ar << m_key;
+  ar << static_cast<int>(m_entries.size());
+  for (const auto &it : m_entries)
+  {
+    ar << it.first;
+    ar << static_cast<int>(it.second.dependencies.size());
+    for (const auto &dependency : it.second.dependencies)
+    {
+      ar << dependency.file;
+      ar << dependency.size;
+      ar << dependency.modified;
+    }
+    ar << static_cast<int>(it.second.conditions.size());
+    for (const auto &condition : it.second.conditions)
+    {
+      ar << condition.first;
+      ar << condition.second;
+    }
+    ar << it.second.data;
+  }
+  ar.Close();
+  cacheFile.Close();
+
+  m_dirty = false;
+  return true;
+}
+
+void CGUISkinCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+  m_file.clear();
+  m_key.clear();
+  m_dirty = false;
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::Get(const std::string &windowFile, std::vector<std::string> &includeFiles, Conditions &conditions)
+{
+  CSingleLock lock(m_section);
+  auto it = m_entries.find(windowFile);
+  if (it == m_entries.end())
+    return nullptr;
+
+  const CacheEntry &entry = it->second;
+  for (const auto &dependency : entry.dependencies)
+  {
+    Dependency current;
+    if (!GetDependency(dependency.file, current) ||
+        current.size != dependency.size || current.modified != dependency.modified)
+    {
+      CLog::Log(LOGDEBUG, "CGUISkinCache::Get - %s changed, dropping cached %s", dependency.file.c_str(), windowFile.c_str());
+      m_entries.erase(it);
+      m_dirty = true;
+      return nullptr;
+    }
+  }
+
+  std::unique_ptr<TiXmlElement> root = Deserialize(entry.data);
+  if (!root)
+  {
+    CLog::Log(LOGERROR, "CGUISkinCache::Get - cached data for %s is corrupt", windowFile.c_str());
+    m_entries.erase(it);
+    m_dirty = true;
+    return nullptr;
+  }
+
+  includeFiles.clear();
+  for (auto dependency = entry.dependencies.begin() + 1; dependency != entry.dependencies.end(); ++dependency)
+    includeFiles.push_back(dependency->file);
+  conditions = entry.conditions;
+  return root;
+}
+
+void CGUISkinCache::Set(const std::string &windowFile, const TiXmlElement *root, const std::vector<std::string> &includeFiles, const Conditions &conditions)
+{
+  if (!root)
+    return;
+
+  CacheEntry entry;
+  entry.dependencies.resize(includeFiles.size() + 1);
+  if (!GetDependency(windowFile, entry.dependencies[0]))
+    return;
+  for (size_t i = 0; i < includeFiles.size(); i++)
+  {
+    if (!GetDependency(includeFiles[i], entry.dependencies[i + 1]))
+      return;
+  }
+  entry.conditions = conditions;
+  entry.data = Serialize(root);
+
+  CSingleLock lock(m_section);
+  if (m_file.empty())
+    return;
+  m_entries[windowFile] = std::move(entry);
+  m_dirty = true;
+}
+
+std::string CGUISkinCache::Serialize(const TiXmlElement *root)
+{
+  std::string data;
+  if (root)
+    WriteNode(data, root);
+  return data;
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::Deserialize(const std::string &data)
+{
+  CReader reader(data);
+  unsigned char tag;
+  if (!reader.ReadByte(tag) || tag != NODE_ELEMENT)
+    return nullptr;
+
+  std::unique_ptr<TiXmlElement> root(ReadElement(reader, 0));
+  if (!root || !reader.AtEnd())
+    return nullptr;
+  return root;
+}
+
+bool CGUISkinCache::GetDependency(const std::string &file, Dependency &dependency)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(file, &buffer) != 0)
+    return false;
+
+  dependency.file = file;
+  dependency.size = buffer.st_size;
+  dependency.modified = buffer.st_mtime;
+  return true;
+}
@@ -0,0 +1,110 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+class TiXmlElement;
+
+/*!
+ \ingroup skin
+ \brief Persistent cache of resolved window XML.
+
+ Window files are stored after includes, constants and expressions have been resolved,
+ in a compact binary form that can be turned back into an element tree without parsing
+ or resolving anything. The whole cache is tied to a key describing the skin (id,
+ version, aspect and the include files it was built from); each entry additionally
+ records the files it depends on and the include conditions it was resolved with.
+ */
+class CGUISkinCache
+{
+public:
+  typedef std::vector<std::pair<std::string, bool>> Conditions;
+
+  CGUISkinCache() = default;
+
+  /*! \brief Load the cache from disk, replacing the current contents.
+   The cache is discarded if it was written for a different skin key.
+   \param file path of the cache file.
+   \param skinKey key describing the current skin setup.
+   \return true if the cache was loaded.
+   */
+  bool Load(const std::string &file, const std::string &skinKey);
+
+  /*! \brief Write the cache to the file it was loaded from, if it changed.
+   \return true if the cache is up to date on disk.
+   */
+  bool Save();
+
+  void Clear();
+
+  /*! \brief Retrieve the resolved tree for a window file.
+   The window file and its include files must not have changed since the tree was stored.
+   It is up to the caller to check the returned conditions still evaluate to the stored values.
+   \param windowFile path of the window xml.
+   \param includeFiles [out] include files loaded while resolving the window.
+   \param conditions [out] include conditions and the values they were resolved with.
+   \return the resolved window element, or nullptr if there is no valid entry.
+   */
+  std::unique_ptr<TiXmlElement> Get(const std::string &windowFile, std::vector<std::string> &includeFiles, Conditions &conditions);
+
+  /*! \brief Store the resolved tree for a window file.
+   \param windowFile path of the window xml.
+   \param root the resolved window element.
+   \param includeFiles include files, besides those in the skin key, the window was resolved with.
+   \param conditions include conditions and their values during resolve.
+   */
+  void Set(const std::string &windowFile, const TiXmlElement *root, const std::vector<std::string> &includeFiles, const Conditions &conditions);
+
+  static std::string Serialize(const TiXmlElement *root);
+  static std::unique_ptr<TiXmlElement> Deserialize(const std::string &data);
+
+private:
+  struct Dependency
+  {
+    std::string file;
+    int64_t size = 0;
+    int64_t modified = 0;
+  };
+
+  struct CacheEntry
+  {
+    std::vector<Dependency> dependencies; ///< window file first, then its include files
+    Conditions conditions;
+    std::string data;
+  };
+
+  static const int CACHE_VERSION = 1;
+
+  static bool GetDependency(const std::string &file, Dependency &dependency);
+
+  std::map<std::string, CacheEntry> m_entries;
+  std::string m_file;
+  std::string m_key;
+  bool m_dirty = false;
+  CCriticalSection m_section;
+};
@@ -123,7 +123,7 @@ bool CGUITextureBase::AllocateOnDemand()
 {
   if (m_visible)
   { // visible, so make sure we're allocated
-    if (!IsAllocated() || (m_isAllocated == LARGE && !m_texture.size()))
+    if (!IsAllocated() || ((m_isAllocated == LARGE || m_isAllocated == NORMAL_PENDING) && !m_texture.size()))
       return AllocResources();
   }
   else
@@ -327,9 +327,16 @@ bool CGUITextureBase::AllocResources()
         m_isAllocated = LARGE_FAILED;
     }
   }
-  else if (!IsAllocated())
+  else if (!IsAllocated() || m_isAllocated == NORMAL_PENDING)
   {
-    CTextureArray texture = g_TextureManager.Load(m_info.filename);
+    // decoded in the background, on screen textures first - nothing is rendered until it's ready
+    bool pending;
+    CTextureArray texture = g_TextureManager.LoadAsync(m_info.filename, m_visible, pending);
+    if (pending)
+    {
+      m_isAllocated = NORMAL_PENDING;
+      return false;
+    }
 
     // set allocated to true even if we couldn't load the image to save
     // us hitting the disk every frame
@@ -122,6 +122,7 @@ public:
   bool IsAllocated() const { return m_isAllocated != NO; };
   bool FailedToAlloc() const { return m_isAllocated == NORMAL_FAILED || m_isAllocated == LARGE_FAILED; };
   bool ReadyToRender() const;
+  bool IsAnimated() const { return m_texture.size() > 1; };
 protected:
   bool CalculateSize();
   void LoadDiffuseImage();
@@ -164,7 +165,7 @@ protected:
   CPoint m_diffuseOffset;                 // offset into the diffuse frame (it's not always the origin)
 
   bool m_allocateDynamically;
-  enum ALLOCATE_TYPE { NO = 0, NORMAL, LARGE, NORMAL_FAILED, LARGE_FAILED };
+  enum ALLOCATE_TYPE { NO = 0, NORMAL, LARGE, NORMAL_FAILED, LARGE_FAILED, NORMAL_PENDING };
   ALLOCATE_TYPE m_isAllocated;
 
   CTextureInfo m_info;
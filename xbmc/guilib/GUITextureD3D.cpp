@@ -19,6 +19,7 @@
  */
 
 #include "D3DResource.h"
+#include "GUIRenderBatch.h"
 #include "GUIShaderDX.h"
 #include "GUITextureD3D.h"
 #include "Texture.h"
@@ -129,6 +130,7 @@ void CGUITextureD3D::Draw(float *x, float *y, float *z, const CRect &texture, co
     pGUIShader->SetShaderViews(1, &resource);
   }
   pGUIShader->DrawQuad(verts[0], verts[1], verts[2], verts[3]);
+  CGUIRenderBatch::GetInstance().CountDrawCall(1);
 }
 
 void CGUITextureD3D::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
@@ -26,6 +26,7 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "guilib/Geometry.h"
+#include "guilib/GUIRenderBatch.h"
 #include "windowing/WindowingFactory.h"
 
 #if defined(HAS_GL)
@@ -34,6 +35,7 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
 : CGUITextureBase(posX, posY, width, height, texture)
 {
   memset(m_col, 0, sizeof(m_col));
+  m_quads = 0;
 }
 
 void CGUITextureGL::Begin(color_t color)
@@ -113,11 +115,13 @@ void CGUITextureGL::Begin(color_t color)
   //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
   //glBegin(GL_LINE_LOOP);
   glBegin(GL_QUADS);
+  m_quads = 0;
 }
 
 void CGUITextureGL::End()
 {
   glEnd();
+  CGUIRenderBatch::GetInstance().CountDrawCall(m_quads);
   glActiveTexture(GL_TEXTURE2_ARB);
   glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
@@ -131,6 +135,8 @@ void CGUITextureGL::End()
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
+  m_quads++;
+
   // Top-left vertex (corner)
   glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
   glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
@@ -220,6 +226,7 @@ void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *tex
   glVertex3f(rect.x1, rect.y2, 0);
 
   glEnd();
+  CGUIRenderBatch::GetInstance().CountDrawCall(1);
   if (texture)
     glDisable(GL_TEXTURE_2D);
 }
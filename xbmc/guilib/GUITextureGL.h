@@ -43,6 +43,7 @@ protected:
   void End() override;
 private:
   GLubyte m_col[4];
+  unsigned int m_quads;
 };
 
 #endif
@@ -33,73 +33,42 @@
 
 #if defined(HAS_GLES)
 
-
-CGUITextureGLES::CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo &texture)
-: CGUITextureBase(posX, posY, width, height, texture)
+namespace
 {
-}
 
-void CGUITextureGLES::Begin(color_t color)
+class CGUITextureBatchGLES : public CGUIRenderBatch::IBackend
 {
-  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
-  texture->LoadToGPU();
-  if (m_diffuse.size())
-    m_diffuse.m_textures[0]->LoadToGPU();
-
-  texture->BindToUnit(0);
-
-  // Setup Colors
-  m_col[0] = (GLubyte)GET_R(color);
-  m_col[1] = (GLubyte)GET_G(color);
-  m_col[2] = (GLubyte)GET_B(color);
-  m_col[3] = (GLubyte)GET_A(color);
-
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
-
-  if (m_diffuse.size())
+public:
+  void DrawQuads(const CGUIRenderBatch::State &state, const PackedVertex *vertices, unsigned int quads) override
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
+    // two triangles per quad, the indices are shared by all batches
+    while (m_idx.size() < quads * 6)
     {
-      g_Windowing.EnableGUIShader(SM_MULTI);
-    }
-    else
-    {
-      g_Windowing.EnableGUIShader(SM_MULTI_BLENDCOLOR);
+      GLushort i = m_idx.size() / 6 * 4;
+      m_idx.push_back(i+0);
+      m_idx.push_back(i+1);
+      m_idx.push_back(i+2);
+      m_idx.push_back(i+2);
+      m_idx.push_back(i+3);
+      m_idx.push_back(i+0);
     }
 
-    hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
+    state.texture->BindToUnit(0);
+    if (state.diffuse)
+      state.diffuse->BindToUnit(1);
 
-    m_diffuse.m_textures[0]->BindToUnit(1);
+    g_Windowing.EnableGUIShader((ESHADERMETHOD)state.shader);
 
-  }
-  else
-  {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
+    if (state.blend)
     {
-      g_Windowing.EnableGUIShader(SM_TEXTURE_NOBLEND);
+      glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+      glEnable( GL_BLEND );
     }
     else
     {
-      g_Windowing.EnableGUIShader(SM_TEXTURE);
+      glDisable(GL_BLEND);
     }
-  }
-
-  if ( hasAlpha )
-  {
-    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
-    glEnable( GL_BLEND );
-  }
-  else
-  {
-    glDisable(GL_BLEND);
-  }
-  m_packedVertices.clear();
-}
 
-void CGUITextureGLES::End()
-{
-  if (m_packedVertices.size())
-  {
     GLint posLoc  = g_Windowing.GUIShaderGetPos();
     GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
     GLint tex1Loc = g_Windowing.GUIShaderGetCoord1();
@@ -107,32 +76,79 @@ void CGUITextureGLES::End()
 
     if(uniColLoc >= 0)
     {
-      glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
+      glUniform4f(uniColLoc, GET_R(state.color) / 255.0f, GET_G(state.color) / 255.0f, GET_B(state.color) / 255.0f, GET_A(state.color) / 255.0f);
     }
 
-    if(m_diffuse.size())
+    if(state.diffuse)
     {
-      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u2));
+      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (const char*)vertices + offsetof(PackedVertex, u2));
       glEnableVertexAttribArray(tex1Loc);
     }
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, x));
+    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), (const char*)vertices + offsetof(PackedVertex, x));
     glEnableVertexAttribArray(posLoc);
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u1));
+    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (const char*)vertices + offsetof(PackedVertex, u1));
     glEnableVertexAttribArray(tex0Loc);
 
-    glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
+    glDrawElements(GL_TRIANGLES, quads * 6, GL_UNSIGNED_SHORT, m_idx.data());
+    CGUIRenderBatch::GetInstance().CountDrawCall(quads);
 
-    if (m_diffuse.size())
+    if (state.diffuse)
       glDisableVertexAttribArray(tex1Loc);
 
     glDisableVertexAttribArray(posLoc);
     glDisableVertexAttribArray(tex0Loc);
+
+    if (state.diffuse)
+      glActiveTexture(GL_TEXTURE0);
+    glEnable(GL_BLEND);
+    g_Windowing.DisableGUIShader();
   }
 
+private:
+  std::vector<GLushort> m_idx;
+};
+
+CGUITextureBatchGLES g_batchBackend;
+
+}
+
+CGUITextureGLES::CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo &texture)
+: CGUITextureBase(posX, posY, width, height, texture)
+{
+}
+
+void CGUITextureGLES::Begin(color_t color)
+{
+  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  texture->LoadToGPU();
   if (m_diffuse.size())
-    glActiveTexture(GL_TEXTURE0);
-  glEnable(GL_BLEND);
-  g_Windowing.DisableGUIShader();
+    m_diffuse.m_textures[0]->LoadToGPU();
+
+  bool hasAlpha = texture->HasAlpha() || GET_A(color) < 255;
+  bool opaqueWhite = color == 0xFFFFFFFF;
+
+  m_state.texture = texture;
+  m_state.diffuse = NULL;
+  m_state.color = color;
+  if (m_diffuse.size())
+  {
+    m_state.diffuse = m_diffuse.m_textures[0];
+    m_state.shader = opaqueWhite ? SM_MULTI : SM_MULTI_BLENDCOLOR;
+    hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
+  }
+  else
+    m_state.shader = opaqueWhite ? SM_TEXTURE_NOBLEND : SM_TEXTURE;
+  m_state.blend = hasAlpha;
+
+  m_packedVertices.clear();
+}
+
+void CGUITextureGLES::End()
+{
+  // drawn along with other quads of the same state once the batch is flushed
+  CGUIRenderBatch &batch = CGUIRenderBatch::GetInstance();
+  batch.SetBackend(&g_batchBackend);
+  batch.Add(m_state, m_packedVertices);
 }
 
 void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
@@ -208,17 +224,6 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
     vertices[i].z = z[i];
     m_packedVertices.push_back(vertices[i]);
   }
-
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
-  {
-    size_t i = m_packedVertices.size() - 4;
-    m_idx.push_back(i+0);
-    m_idx.push_back(i+1);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+3);
-    m_idx.push_back(i+0);
-  }
 }
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
@@ -280,6 +285,7 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *t
     tex[2][1] = tex[3][1] = coords.y2;
   }
   glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+  CGUIRenderBatch::GetInstance().CountDrawCall(1);
 
   glDisableVertexAttribArray(posLoc);
   if (texture)
@@ -29,18 +29,11 @@
  */
 
 #include "GUITexture.h"
+#include "GUIRenderBatch.h"
 
 #include "system_gl.h"
 #include <vector>
 
-struct PackedVertex
-{
-  float x, y, z;
-  float u1, v1;
-  float u2, v2;
-};
-typedef std::vector<PackedVertex> PackedVertices;
-
 class CGUITextureGLES : public CGUITextureBase
 {
 public:
@@ -51,10 +44,8 @@ protected:
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   void End();
 
-  GLubyte m_col[4];
-
+  CGUIRenderBatch::State m_state;
   PackedVertices m_packedVertices;
-  std::vector<GLushort> m_idx;
 };
 
 #endif
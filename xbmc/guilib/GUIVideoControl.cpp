@@ -21,6 +21,7 @@
 #include "system.h"
 #include "GUIVideoControl.h"
 #include "GUIWindowManager.h"
+#include "GUIRenderBatch.h"
 #include "Application.h"
 #include "input/Key.h"
 #include "WindowIDs.h"
@@ -68,7 +69,11 @@ void CGUIVideoControl::Render()
       g_graphicsContext.SetScissors(old);
     }
     else
+    {
+      // the video renderer sets up its own GL state, so anything queued has to go first
+      CGUIRenderBatch::GetInstance().Flush();
       g_application.m_pPlayer->Render(false, alpha);
+    }
 
     g_graphicsContext.RemoveTransform();
   }
@@ -142,6 +142,11 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
+  // use the already resolved window if neither its files nor its include conditions changed
+  std::unique_ptr<TiXmlElement> cachedRoot = g_SkinInfo->GetCachedWindow(strPath, &m_xmlIncludeConditions);
+  if (cachedRoot)
+    return Load(cachedRoot.get());
+
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
@@ -168,7 +173,11 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(Prepare(m_windowXMLRootElement).get());
+  std::unique_ptr<TiXmlElement> preparedRoot = Prepare(m_windowXMLRootElement);
+  if (preparedRoot)
+    g_SkinInfo->CacheWindow(strPath, preparedRoot.get(), m_xmlIncludeConditions);
+
+  return Load(preparedRoot.get());
 }
 
 std::unique_ptr<TiXmlElement> CGUIWindow::Prepare(TiXmlElement *pRootElement)
@@ -21,6 +21,7 @@
 #include "GUIWindowManager.h"
 #include "GUIAudioManager.h"
 #include "GUIDialog.h"
+#include "GUIFrameProfiler.h"
 #include "Application.h"
 #include "messaging/ApplicationMessenger.h"
 #include "messaging/helpers/DialogHelper.h"
@@ -547,7 +548,10 @@ bool CGUIWindowManager::SendMessage(CGUIMessage& message, int window)
     return SendMessage(message);
   CGUIWindow* pWindow = GetWindow(window);
   if(pWindow)
+  {
+    g_infoManager.SetDomainsChanged(INFO_DOMAIN_MASK_ALL);
     return pWindow->OnMessage(message);
+  }
   else
     return false;
 }
@@ -868,6 +872,7 @@ void CGUIWindowManager::CloseInternalModalDialogs(bool forceClose) const
 
 void CGUIWindowManager::OnApplicationMessage(ThreadMessage* pMsg)
 {
+  g_infoManager.SetDomainsChanged(INFO_DOMAIN_MASK_ALL);
   switch (pMsg->dwMessage)
   {
   case TMSG_GUI_DIALOG_OPEN:
@@ -1005,6 +1010,8 @@ bool CGUIWindowManager::OnAction(const CAction &action) const
     m_inhibitTouchGestureEvents = false;
   }
 
+  // the action may have changed focus or any other state conditions depend on
+  g_infoManager.SetDomainsChanged(INFO_DOMAIN_MASK_ALL);
   return ret;
 }
 
@@ -1052,6 +1059,7 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
+  GUIPROFILER_ZONE("CGUIWindowManager::Process");
   CSingleLock lock(g_graphicsContext);
 
   m_dirtyregions.clear();
@@ -1123,6 +1131,7 @@ void CGUIWindowManager::RenderEx() const
 bool CGUIWindowManager::Render()
 {
   assert(g_application.IsCurrentThread());
+  GUIPROFILER_ZONE("CGUIWindowManager::Render");
   CSingleExit lock(g_graphicsContext);
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
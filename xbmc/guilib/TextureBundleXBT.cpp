@@ -33,6 +33,7 @@
 #include "XBTF.h"
 #include "XBTFReader.h"
 #include <lzo/lzo1x.h>
+#include <cstring>
 
 #ifdef TARGET_WINDOWS
 #ifdef NDEBUG
@@ -158,14 +159,11 @@ bool CTextureBundleXBT::LoadTexture(const std::string& Filename, CBaseTexture**
 {
   std::string name = Normalize(Filename);
 
-  CXBTFFile file;
-  if (!m_XBTFReader->Get(name, file))
+  const CXBTFFile* file = m_XBTFReader->Find(name);
+  if (file == nullptr || file->GetFrames().empty())
     return false;
 
-  if (file.GetFrames().empty())
-    return false;
-
-  CXBTFFrame& frame = file.GetFrames().at(0);
+  const CXBTFFrame& frame = file->GetFrames().at(0);
   if (!ConvertFrameToTexture(Filename, frame, ppTexture))
   {
     return false;
@@ -182,20 +180,17 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
 {
   std::string name = Normalize(Filename);
 
-  CXBTFFile file;
-  if (!m_XBTFReader->Get(name, file))
-    return false;
-
-  if (file.GetFrames().empty())
+  const CXBTFFile* file = m_XBTFReader->Find(name);
+  if (file == nullptr || file->GetFrames().empty())
     return false;
 
-  size_t nTextures = file.GetFrames().size();
+  size_t nTextures = file->GetFrames().size();
   *ppTextures = new CBaseTexture*[nTextures];
   *ppDelays = new int[nTextures];
 
   for (size_t i = 0; i < nTextures; i++)
   {
-    CXBTFFrame& frame = file.GetFrames().at(i);
+    const CXBTFFrame& frame = file->GetFrames().at(i);
 
     if (!ConvertFrameToTexture(Filename, frame, &((*ppTextures)[i])))
     {
@@ -205,57 +200,32 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
     (*ppDelays)[i] = frame.GetDuration();
   }
 
-  width = file.GetFrames().at(0).GetWidth();
-  height = file.GetFrames().at(0).GetHeight();
-  nLoops = file.GetLoop();
+  width = file->GetFrames().at(0).GetWidth();
+  height = file->GetFrames().at(0).GetHeight();
+  nLoops = file->GetLoop();
 
   return nTextures;
 }
 
-bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
+bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, const CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  unsigned char *buffer = new unsigned char [(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
-  {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
-  }
-
-  // load the compressed texture
-  if (!m_XBTFReader->Load(frame, buffer))
+  // unpacked frames are read straight out of the mapped bundle, anything else is unpacked first
+  const uint8_t* data = frame.IsPacked() ? nullptr : m_XBTFReader->GetData(frame);
+  uint8_t* buffer = nullptr;
+  if (data == nullptr)
   {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
-  }
-
-  // check if it's packed with lzo
-  if (frame.IsPacked())
-  { // unpack
-    unsigned char *unpacked = new unsigned char[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
-    {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
-      return false;
-    }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
+    buffer = UnpackFrame(*m_XBTFReader, frame);
+    if (buffer == nullptr)
     {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
       return false;
     }
-    delete[] buffer;
-    buffer = unpacked;
+    data = buffer;
   }
 
   // create an xbmc texture
   *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
+  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), data);
 
   delete[] buffer;
 
@@ -282,24 +252,37 @@ std::string CTextureBundleXBT::Normalize(const std::string &name)
 
 uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame)
 {
-  uint8_t* packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
-  if (packedBuffer == nullptr)
+  // use the mapped bundle if we can, otherwise load the compressed frame into memory
+  const uint8_t* packedData = reader.GetData(frame);
+  uint8_t* packedBuffer = nullptr;
+  if (packedData == nullptr)
   {
-    CLog::Log(LOGERROR, "CTextureBundleXBT: out of memory loading frame with %" PRIu64" packed bytes", frame.GetPackedSize());
-    return nullptr;
-  }
+    packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
+    if (packedBuffer == nullptr)
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: out of memory loading frame with %" PRIu64" packed bytes", frame.GetPackedSize());
+      return nullptr;
+    }
 
-  // load the compressed texture
-  if (!reader.Load(frame, packedBuffer))
-  {
-    CLog::Log(LOGERROR, "CTextureBundleXBT: error loading frame");
-    delete[] packedBuffer;
-    return nullptr;
+    if (!reader.Load(frame, packedBuffer))
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: error loading frame");
+      delete[] packedBuffer;
+      return nullptr;
+    }
+    packedData = packedBuffer;
   }
 
   // if the frame isn't packed there's nothing else to be done
   if (!frame.IsPacked())
+  {
+    if (packedBuffer == nullptr)
+    {
+      packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
+      memcpy(packedBuffer, packedData, static_cast<size_t>(frame.GetPackedSize()));
+    }
     return packedBuffer;
+  }
 
   uint8_t* unpackedBuffer = new uint8_t[static_cast<size_t>(frame.GetUnpackedSize())];
   if (unpackedBuffer == nullptr)
@@ -319,7 +302,7 @@ uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFr
   }
 
   lzo_uint size = static_cast<lzo_uint>(frame.GetUnpackedSize());
-  if (lzo1x_decompress_safe(packedBuffer, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK || size != frame.GetUnpackedSize())
+  if (lzo1x_decompress_safe(packedData, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK || size != frame.GetUnpackedSize())
   {
     CLog::Log(LOGERROR, "CTextureBundleXBT: failed to decompress frame with %" PRIu64" unpacked bytes to %" PRIu64" bytes", frame.GetPackedSize(), frame.GetUnpackedSize());
     delete[] packedBuffer;
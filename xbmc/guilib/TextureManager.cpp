@@ -26,6 +26,7 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "GraphicContext.h"
+#include "GUIFrameProfiler.h"
 #include "system.h"
 #include "Texture.h"
 #include "threads/SingleLock.h"
@@ -42,6 +43,43 @@
 #include "windowing/WindowingFactory.h" // for g_Windowing in CGUITextureManager::FreeUnusedTextures
 #endif
 #include "FFmpegImage.h"
+#include "utils/JobManager.h"
+
+// bytes of decoded textures uploaded to the GPU per frame, at least one texture is always uploaded
+static const uint32_t TEXTURE_UPLOAD_BUDGET = 4 * 1024 * 1024;
+// unused textures are kept around for reuse until they exceed this many bytes
+static const uint32_t UNUSED_TEXTURE_BUDGET = 64 * 1024 * 1024;
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+class CTextureLoadJob : public CJob
+{
+public:
+  CTextureLoadJob(const std::string &textureName, const std::string &path, int bundle)
+    : m_textureName(textureName), m_path(path), m_bundle(bundle)
+  {
+  }
+  ~CTextureLoadJob() override
+  {
+    delete m_map;
+  }
+
+  const char *GetType() const override { return "textureload"; }
+
+  bool DoWork() override
+  {
+    GUIPROFILER_ZONE("CTextureLoadJob::DoWork");
+    m_map = g_TextureManager.DecodeTextureAsync(m_textureName, m_path, m_bundle);
+    return m_map != nullptr;
+  }
+
+  CTextureMap *m_map = nullptr;
+private:
+  std::string m_textureName;
+  std::string m_path;
+  int m_bundle;
+};
 
 /************************************************************************/
 /*                                                                      */
@@ -210,6 +248,12 @@ bool CTextureMap::IsEmpty() const
   return m_texture.m_textures.empty();
 }
 
+void CTextureMap::LoadToGPU()
+{
+  for (auto texture : m_texture.m_textures)
+    texture->LoadToGPU();
+}
+
 void CTextureMap::Add(CBaseTexture* texture, int delay)
 {
   m_texture.Add(texture, delay);
@@ -225,6 +269,7 @@ CGUITextureManager::CGUITextureManager(void)
 {
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
+  m_asyncBundle[0].SetThemeBundle(true);
 }
 
 CGUITextureManager::~CGUITextureManager(void)
@@ -334,25 +379,62 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   //Lock here, we will do stuff that could break rendering
   CSingleLock lock(g_graphicsContext);
+  GUIPROFILER_ZONE("CGUITextureManager::Load");
 
 #ifdef _DEBUG_TEXTURES
   int64_t start;
   start = CurrentHostCounter();
 #endif
 
-  if (bundle >= 0 && StringUtils::EndsWithNoCase(strPath, ".gif"))
+  CTextureMap* pMap = DecodeTexture(strTextureName, strPath, bundle >= 0 ? &m_TexBundle[bundle] : nullptr);
+  if (!pMap)
+    return emptyTexture;
+
+  m_vecTextures.push_back(pMap);
+
+#ifdef _DEBUG_TEXTURES
+  int64_t end, freq;
+  end = CurrentHostCounter();
+  freq = CurrentHostFrequency();
+  char temp[200];
+  sprintf(temp, "Load %s: %.1fms%s\n", strPath.c_str(), 1000.f * (end - start) / freq, (bundle >= 0) ? " (bundled)" : "");
+  OutputDebugString(temp);
+#endif
+
+  return pMap->GetTexture();
+}
+
+CTextureMap* CGUITextureManager::DecodeTextureAsync(const std::string& strTextureName, const std::string& strPath, int bundle)
+{
+  if (bundle < 0)
+    return DecodeTexture(strTextureName, strPath, nullptr);
+
+  CTextureBundle &asyncBundle = m_asyncBundle[bundle];
+  {
+    // (re)opens the bundle if needed
+    CExclusiveLock lock(m_asyncBundleSection);
+    if (!asyncBundle.HasFile(CTextureBundle::Normalize(strTextureName)))
+      return nullptr;
+  }
+  CSharedLock lock(m_asyncBundleSection);
+  return DecodeTexture(strTextureName, strPath, &asyncBundle);
+}
+
+CTextureMap* CGUITextureManager::DecodeTexture(const std::string& strTextureName, const std::string& strPath, CTextureBundle *bundle)
+{
+  if (bundle && StringUtils::EndsWithNoCase(strPath, ".gif"))
   {
     CTextureMap* pMap = nullptr;
     CBaseTexture **pTextures = nullptr;
     int nLoops = 0, width = 0, height = 0;
     int* Delay = nullptr;
-    int nImages = m_TexBundle[bundle].LoadAnim(strTextureName, &pTextures, width, height, nLoops, &Delay);
+    int nImages = bundle->LoadAnim(strTextureName, &pTextures, width, height, nLoops, &Delay);
     if (!nImages)
     {
       CLog::Log(LOGERROR, "Texture manager unable to load bundled file: %s", strTextureName.c_str());
       delete[] pTextures;
       delete[] Delay;
-      return emptyTexture;
+      return nullptr;
     }
 
     unsigned int maxWidth = 0;
@@ -371,8 +453,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     delete[] pTextures;
     delete[] Delay;
 
-    m_vecTextures.push_back(pMap);
-    return pMap->GetTexture();
+    return pMap;
   }
   else if (StringUtils::EndsWithNoCase(strPath, ".gif") ||
            StringUtils::EndsWithNoCase(strPath, ".apng"))
@@ -392,7 +473,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     {
       CLog::Log(LOGERROR, "Texture manager unable to load file: %s", CURL::GetRedacted(strPath).c_str());
       file.Close();
-      return emptyTexture;
+      return nullptr;
     }
 
     CTextureMap* pMap = new CTextureMap(strTextureName, 0, 0, 0);
@@ -428,47 +509,160 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
     file.Close();
 
-    m_vecTextures.push_back(pMap);
-    return pMap->GetTexture();
+    return pMap;
   }
 
   CBaseTexture *pTexture = NULL;
   int width = 0, height = 0;
-  if (bundle >= 0)
+  if (bundle)
   {
-    if (!m_TexBundle[bundle].LoadTexture(strTextureName, &pTexture, width, height))
+    if (!bundle->LoadTexture(strTextureName, &pTexture, width, height))
     {
       CLog::Log(LOGERROR, "Texture manager unable to load bundled file: %s", strTextureName.c_str());
-      return emptyTexture;
+      return nullptr;
     }
   }
   else
   {
     pTexture = CBaseTexture::LoadFromFile(strPath);
     if (!pTexture)
-      return emptyTexture;
+      return nullptr;
     width = pTexture->GetWidth();
     height = pTexture->GetHeight();
   }
 
-  if (!pTexture) return emptyTexture;
+  if (!pTexture) return nullptr;
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  return pMap;
+}
 
-#ifdef _DEBUG_TEXTURES
-  int64_t end, freq;
-  end = CurrentHostCounter();
-  freq = CurrentHostFrequency();
-  char temp[200];
-  sprintf(temp, "Load %s: %.1fms%s\n", strPath.c_str(), 1000.f * (end - start) / freq, (bundle >= 0) ? " (bundled)" : "");
-  OutputDebugString(temp);
-#endif
+const CTextureArray& CGUITextureManager::LoadAsync(const std::string& strTextureName, bool visible, bool &pending)
+{
+  std::string strPath;
+  static CTextureArray emptyTexture;
+  int bundle = -1;
+  int size = 0;
+  pending = false;
 
-  return pMap->GetTexture();
+  if (strTextureName.empty())
+    return emptyTexture;
+
+  if (!HasTexture(strTextureName, &strPath, &bundle, &size))
+    return emptyTexture;
+
+  bool unused = false;
+  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end() && !unused; ++i)
+    unused = i->first->GetName() == strTextureName && i->second > 0;
+
+  // nothing to decode, so hand it out straight away
+  if (size || unused)
+    return Load(strTextureName);
+
+  CSingleLock lock(m_pendingSection);
+  std::map<std::string, PendingTexture>::iterator it = m_pendingTextures.find(strTextureName);
+  if (it == m_pendingTextures.end())
+  {
+    PendingTexture &texture = m_pendingTextures[strTextureName];
+    texture.visible = visible;
+    texture.jobID = CJobManager::GetInstance().AddJob(new CTextureLoadJob(strTextureName, strPath, bundle), this,
+                                                      visible ? CJob::PRIORITY_HIGH : CJob::PRIORITY_LOW);
+  }
+  else if (it->second.failed)
+  {
+    m_pendingTextures.erase(it);
+    return emptyTexture;
+  }
+  else if (visible && !it->second.visible && it->second.jobID)
+  {
+    // it has come on screen, so requeue it ahead of the textures that are only preloading
+    CJobManager::GetInstance().CancelJob(it->second.jobID);
+    it->second.visible = true;
+    it->second.jobID = CJobManager::GetInstance().AddJob(new CTextureLoadJob(strTextureName, strPath, bundle), this,
+                                                         CJob::PRIORITY_HIGH);
+  }
+
+  pending = true;
+  return emptyTexture;
+}
+
+void CGUITextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_pendingSection);
+  for (std::map<std::string, PendingTexture>::iterator it = m_pendingTextures.begin(); it != m_pendingTextures.end(); ++it)
+  {
+    if (it->second.jobID == jobID)
+    {
+      CTextureLoadJob *loadJob = static_cast<CTextureLoadJob*>(job);
+      it->second.jobID = 0;
+      it->second.failed = !success;
+      it->second.decoded = loadJob->m_map;
+      loadJob->m_map = nullptr;
+      return;
+    }
+  }
 }
 
+void CGUITextureManager::UploadDecodedTextures()
+{
+  GUIPROFILER_ZONE("CGUITextureManager::UploadDecodedTextures");
+  CSingleLock lock(g_graphicsContext);
+  CSingleLock pendingLock(m_pendingSection);
+
+  uint32_t uploaded = 0;
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  // visible textures go first, then whatever is left of the budget goes to the preloads
+  for (int pass = 0; pass < 2 && uploaded < TEXTURE_UPLOAD_BUDGET; ++pass)
+  {
+    for (std::map<std::string, PendingTexture>::iterator it = m_pendingTextures.begin(); it != m_pendingTextures.end() && uploaded < TEXTURE_UPLOAD_BUDGET;)
+    {
+      CTextureMap* pMap = it->second.decoded;
+      if (!pMap || it->second.visible != (pass == 0))
+      {
+        ++it;
+        continue;
+      }
+
+      pMap->LoadToGPU();
+      uploaded += pMap->GetMemoryUsage();
+      // park it as unused, the next Load() of this texture picks it up from there
+      m_unusedTextures.push_back(std::make_pair(pMap, now ? now : 1));
+      it = m_pendingTextures.erase(it);
+    }
+  }
+
+  if (uploaded)
+    FreeUnusedOverBudget();
+}
+
+void CGUITextureManager::CancelPendingTextures()
+{
+  CSingleLock lock(m_pendingSection);
+  for (std::map<std::string, PendingTexture>::iterator it = m_pendingTextures.begin(); it != m_pendingTextures.end(); ++it)
+  {
+    if (it->second.jobID)
+      CJobManager::GetInstance().CancelJob(it->second.jobID);
+    delete it->second.decoded;
+  }
+  m_pendingTextures.clear();
+}
+
+void CGUITextureManager::FreeUnusedOverBudget()
+{
+  uint32_t unusedMemory = 0;
+  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+    unusedMemory += i->first->GetMemoryUsage();
+
+  // the list is in release order, so the front holds the least recently used textures
+  while (unusedMemory > UNUSED_TEXTURE_BUDGET && !m_unusedTextures.empty())
+  {
+    CTextureMap* pMap = m_unusedTextures.front().first;
+    unusedMemory -= pMap->GetMemoryUsage();
+    delete pMap;
+    m_unusedTextures.pop_front();
+  }
+}
 
 void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool immediately /*= false */)
 {
@@ -509,6 +703,7 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
     else
       ++i;
   }
+  FreeUnusedOverBudget();
 
 #if defined(HAS_GL) || defined(HAS_GLES)
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
@@ -545,8 +740,14 @@ void CGUITextureManager::Cleanup()
     i = m_vecTextures.erase(i);
   }
 
+  CancelPendingTextures();
   m_TexBundle[0] = CTextureBundle(true);
   m_TexBundle[1] = CTextureBundle();
+  {
+    CExclusiveLock bundleLock(m_asyncBundleSection);
+    m_asyncBundle[0] = CTextureBundle(true);
+    m_asyncBundle[1] = CTextureBundle();
+  }
   FreeUnusedTextures();
 }
 
@@ -565,6 +766,7 @@ void CGUITextureManager::Dump() const
 void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
+  CancelPendingTextures();
 
   ivecTextures i;
   i = m_vecTextures.begin();
@@ -25,11 +25,14 @@
 #pragma once
 
 #include <list>
+#include <map>
 #include <vector>
 #include <utility>
 
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
+#include "threads/SharedSection.h"
+#include "utils/Job.h"
 
 /************************************************************************/
 /*                                                                      */
@@ -83,6 +86,7 @@ public:
   uint32_t GetMemoryUsage() const;
   void Flush();
   bool IsEmpty() const;
+  void LoadToGPU();
   void SetHeight(int height);
   void SetWidth(int height);
 protected:
@@ -101,8 +105,9 @@ protected:
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
-class CGUITextureManager
+class CGUITextureManager : public IJobCallback
 {
+  friend class CTextureLoadJob;
 public:
   CGUITextureManager(void);
   virtual ~CGUITextureManager(void);
@@ -110,6 +115,17 @@ public:
   bool HasTexture(const std::string &textureName, std::string *path = NULL, int *bundle = NULL, int *size = NULL);
   static bool CanLoad(const std::string &texturePath); ///< Returns true if the texture manager can load this texture
   const CTextureArray& Load(const std::string& strTextureName, bool checkBundleOnly = false);
+  /*!
+   \brief Load a texture without blocking the render thread on decoding.
+
+   Textures that are already loaded are returned immediately. Others are decoded by a worker and
+   uploaded by UploadDecodedTextures(); until then an empty texture is returned and pending is set.
+   \param strTextureName name of the texture to load.
+   \param visible true if the texture is on screen, in which case it is decoded ahead of preloads.
+   \param pending [out] true while the texture is being decoded or waiting for upload.
+   */
+  const CTextureArray& LoadAsync(const std::string& strTextureName, bool visible, bool &pending);
+  void UploadDecodedTextures(); ///< Upload decoded textures within the per frame budget (called from app thread only)
   void ReleaseTexture(const std::string& strTextureName, bool immediately = false);
   void Cleanup();
   void Dump() const;
@@ -124,7 +140,22 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
 protected:
+  CTextureMap* DecodeTexture(const std::string& strTextureName, const std::string& strPath, CTextureBundle *bundle);
+  CTextureMap* DecodeTextureAsync(const std::string& strTextureName, const std::string& strPath, int bundle); ///< Decode on a worker, reading bundled textures through m_asyncBundle
+  void CancelPendingTextures();
+  void FreeUnusedOverBudget();
+
+  struct PendingTexture
+  {
+    unsigned int jobID = 0;
+    bool visible = false;
+    bool failed = false;
+    CTextureMap* decoded = nullptr;
+  };
+
   std::vector<CTextureMap*> m_vecTextures;
   std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
   std::vector<unsigned int> m_unusedHwTextures;
@@ -132,6 +163,13 @@ protected:
   typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
+  // the workers read bundles through their own copies, so that decoding never holds m_section.
+  // opening them is exclusive, decoding is shared so textures are unpacked in parallel
+  CTextureBundle m_asyncBundle[2];
+  CSharedSection m_asyncBundleSection;
+
+  std::map<std::string, PendingTexture> m_pendingTextures;
+  CCriticalSection m_pendingSection;
 
   std::vector<std::string> m_texturePaths;
   CCriticalSection m_section;
@@ -20,6 +20,7 @@
 
 #include "XBTF.h"
 
+#include <algorithm>
 #include <cstring>
 #include <utility>
 
@@ -207,48 +208,67 @@ uint64_t CXBTFBase::GetHeaderSize() const
     sizeof(uint32_t) /* number of files */;
 
   for (const auto& file : m_files)
-    result += file.second.GetHeaderSize();
+    result += file.GetHeaderSize();
 
   return result;
 }
 
+std::vector<CXBTFFile>::iterator CXBTFBase::LowerBound(const std::string& name)
+{
+  return std::lower_bound(m_files.begin(), m_files.end(), name,
+    [](const CXBTFFile& file, const std::string& path) { return file.GetPath() < path; });
+}
+
+std::vector<CXBTFFile>::const_iterator CXBTFBase::LowerBound(const std::string& name) const
+{
+  return std::lower_bound(m_files.begin(), m_files.end(), name,
+    [](const CXBTFFile& file, const std::string& path) { return file.GetPath() < path; });
+}
+
 bool CXBTFBase::Exists(const std::string& name) const
 {
-  CXBTFFile dummy;
-  return Get(name, dummy);
+  return Find(name) != nullptr;
 }
 
 bool CXBTFBase::Get(const std::string& name, CXBTFFile& file) const
 {
-  const auto& iter = m_files.find(name);
-  if (iter == m_files.end())
+  const CXBTFFile* found = Find(name);
+  if (found == nullptr)
     return false;
 
-  file = iter->second;
+  file = *found;
   return true;
 }
 
-std::vector<CXBTFFile> CXBTFBase::GetFiles() const
+const CXBTFFile* CXBTFBase::Find(const std::string& name) const
 {
-  std::vector<CXBTFFile> files;
-  files.reserve(m_files.size());
+  const auto iter = LowerBound(name);
+  if (iter == m_files.end() || iter->GetPath() != name)
+    return nullptr;
 
-  for (const auto& file : m_files)
-    files.push_back(file.second);
+  return &(*iter);
+}
 
-  return files;
+std::vector<CXBTFFile> CXBTFBase::GetFiles() const
+{
+  return m_files;
 }
 
 void CXBTFBase::AddFile(const CXBTFFile& file)
 {
-  m_files.insert(std::make_pair(file.GetPath(), file));
+  // the first file added under a name wins
+  auto iter = LowerBound(file.GetPath());
+  if (iter != m_files.end() && iter->GetPath() == file.GetPath())
+    return;
+
+  m_files.insert(iter, file);
 }
 
 void CXBTFBase::UpdateFile(const CXBTFFile& file)
 {
-  auto&& it = m_files.find(file.GetPath());
-  if (it == m_files.end())
+  auto iter = LowerBound(file.GetPath());
+  if (iter == m_files.end() || iter->GetPath() != file.GetPath())
     return;
 
-  it->second = file;
+  *iter = file;
 }
@@ -19,7 +19,6 @@
  *
  */
 
-#include <map>
 #include <string>
 #include <vector>
 
@@ -107,6 +106,7 @@ public:
 
   bool Exists(const std::string& name) const;
   bool Get(const std::string& name, CXBTFFile& file) const;
+  const CXBTFFile* Find(const std::string& name) const; ///< Look up a file without copying it, nullptr if it doesn't exist
   std::vector<CXBTFFile> GetFiles() const;
   void AddFile(const CXBTFFile& file);
   void UpdateFile(const CXBTFFile& file);
@@ -114,5 +114,8 @@ public:
 protected:
   CXBTFBase() = default;
 
-  std::map<std::string, CXBTFFile> m_files;
+  std::vector<CXBTFFile>::iterator LowerBound(const std::string& name);
+  std::vector<CXBTFFile>::const_iterator LowerBound(const std::string& name) const;
+
+  std::vector<CXBTFFile> m_files; ///< sorted by path, looked up by binary search
 };
@@ -22,6 +22,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#ifndef TARGET_WINDOWS
+#include <sys/mman.h>
+#endif
 
 #include "XBTFReader.h"
 #include "guilib/XBTF.h"
@@ -31,6 +34,8 @@
 #include "filesystem/SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
 #include "platform/win32/PlatformDefs.h"
+#include <io.h>
+#include <windows.h>
 #endif
 
 static bool ReadString(FILE* file, char* str, size_t max_length)
@@ -68,7 +73,10 @@ static bool ReadUInt64(FILE* file, uint64_t& value)
 CXBTFReader::CXBTFReader()
   : CXBTFBase(),
     m_path(),
-    m_file(nullptr)
+    m_file(nullptr),
+    m_data(nullptr),
+    m_dataSize(0),
+    m_mapping(nullptr)
 { }
 
 CXBTFReader::~CXBTFReader()
@@ -177,9 +185,63 @@ bool CXBTFReader::Open(const std::string& path)
   if (pos != GetHeaderSize())
     return false;
 
+  // not being able to map the bundle isn't fatal, we'll just read it instead
+  Map();
+
   return true;
 }
 
+bool CXBTFReader::Map()
+{
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == -1 || fileStat.st_size <= 0)
+    return false;
+
+  m_dataSize = static_cast<uint64_t>(fileStat.st_size);
+#ifdef TARGET_WINDOWS
+  HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file)));
+  m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_mapping != nullptr)
+  {
+    m_data = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+    {
+      CloseHandle(m_mapping);
+      m_mapping = nullptr;
+    }
+  }
+#else
+  void* data = mmap(nullptr, static_cast<size_t>(m_dataSize), PROT_READ, MAP_SHARED, fileno(m_file), 0);
+  if (data != MAP_FAILED)
+  {
+    m_data = static_cast<uint8_t*>(data);
+    // skin textures are read all over the place as windows load
+    madvise(data, static_cast<size_t>(m_dataSize), MADV_RANDOM);
+  }
+#endif
+
+  if (m_data == nullptr)
+    m_dataSize = 0;
+
+  return m_data != nullptr;
+}
+
+void CXBTFReader::Unmap()
+{
+  if (m_data == nullptr)
+    return;
+
+#ifdef TARGET_WINDOWS
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping);
+  m_mapping = nullptr;
+#else
+  munmap(m_data, static_cast<size_t>(m_dataSize));
+#endif
+  m_data = nullptr;
+  m_dataSize = 0;
+}
+
 bool CXBTFReader::IsOpen() const
 {
   return m_file != nullptr;
@@ -187,6 +249,8 @@ bool CXBTFReader::IsOpen() const
 
 void CXBTFReader::Close()
 {
+  Unmap();
+
   if (m_file != nullptr)
   {
     fclose(m_file);
@@ -209,11 +273,32 @@ time_t CXBTFReader::GetLastModificationTimestamp() const
   return fileStat.st_mtime;
 }
 
+const uint8_t* CXBTFReader::GetData(const CXBTFFrame& frame) const
+{
+  if (m_data == nullptr || frame.GetOffset() > m_dataSize ||
+      frame.GetPackedSize() > m_dataSize - frame.GetOffset())
+    return nullptr;
+
+  return m_data + frame.GetOffset();
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 {
   if (m_file == nullptr)
     return false;
 
+  if (m_data != nullptr)
+  {
+    const uint8_t* data = GetData(frame);
+    if (data == nullptr)
+      return false;
+
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(m_fileMutex);
+
 #if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD) || defined(TARGET_ANDROID)
   if (fseeko(m_file, static_cast<off_t>(frame.GetOffset()), SEEK_SET) == -1)
 #else
@@ -20,6 +20,7 @@
  */
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -40,10 +41,23 @@ public:
   time_t GetLastModificationTimestamp() const;
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
+  /*!
+   \brief Get the packed data of a frame straight from the bundle mapped into memory.
+   \return pointer to GetPackedSize() bytes valid until Close(), nullptr if the bundle couldn't be mapped.
+   */
+  const uint8_t* GetData(const CXBTFFrame& frame) const;
 
 private:
+  bool Map();
+  void Unmap();
+
   std::string m_path;
   FILE* m_file;
+  // the whole bundle is mapped read-only so frames can be read from any thread without seeking
+  uint8_t* m_data;
+  uint64_t m_dataSize;
+  void* m_mapping;
+  mutable std::mutex m_fileMutex; ///< serializes Load() when the bundle isn't mapped
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
@@ -0,0 +1,140 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "guilib/GUIControlGroup.h"
+#include "guilib/GUILabelControl.h"
+
+#include "gtest/gtest.h"
+
+#include <functional>
+
+namespace
+{
+class CCountingLabelControl : public CGUILabelControl
+{
+public:
+  CCountingLabelControl()
+    : CGUILabelControl(0, 2, 0, 0, 100, 20, CLabelInfo(), false, false) {}
+
+  void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions) override
+  {
+    m_processed++;
+    CGUILabelControl::Process(currentTime, dirtyregions);
+  }
+
+  unsigned int m_processed = 0;
+};
+
+class TestGUILabelControl : public testing::Test
+{
+protected:
+  TestGUILabelControl() : m_group(0, 1, 0, 0, 100, 100)
+  {
+    // the label sits in a subtree which is left out as a whole once settled
+    CGUIControlGroup *subtree = new CGUIControlGroup(0, 3, 0, 0, 100, 100);
+    m_label = new CCountingLabelControl;
+    m_label->SetLabel("12345678");
+    subtree->AddControl(m_label);
+    m_group.AddControl(subtree);
+  }
+
+  void ProcessFrame()
+  {
+    CDirtyRegionList dirtyRegions;
+    m_group.DoProcess(m_time, dirtyRegions);
+    m_time += 20;
+  }
+
+  // processes frames until the label is left out, returns false if it never is
+  bool Settle()
+  {
+    for (int frame = 0; frame < 10; frame++)
+    {
+      unsigned int processed = m_label->m_processed;
+      ProcessFrame();
+      if (m_label->m_processed == processed)
+        return true;
+    }
+    return false;
+  }
+
+  // true if the label is processed in the frame after the change
+  bool ProcessedAfter(const std::function<void()> &change)
+  {
+    change();
+    unsigned int processed = m_label->m_processed;
+    ProcessFrame();
+    return m_label->m_processed != processed;
+  }
+
+  CGUIControlGroup m_group;
+  CCountingLabelControl *m_label;
+  unsigned int m_time = 0;
+};
+}
+
+TEST_F(TestGUILabelControl, SettledLabelIsSkipped)
+{
+  ASSERT_TRUE(Settle());
+  EXPECT_FALSE(ProcessedAfter([]() {}));
+}
+
+TEST_F(TestGUILabelControl, SetHighlightProcessesAgain)
+{
+  ASSERT_TRUE(Settle());
+  EXPECT_TRUE(ProcessedAfter([this]() { m_label->SetHighlight(2, 4); }));
+
+  // setting the same highlight changes nothing
+  ASSERT_TRUE(Settle());
+  EXPECT_FALSE(ProcessedAfter([this]() { m_label->SetHighlight(2, 4); }));
+}
+
+TEST_F(TestGUILabelControl, SetSelectionProcessesAgain)
+{
+  ASSERT_TRUE(Settle());
+  EXPECT_TRUE(ProcessedAfter([this]() { m_label->SetSelection(1, 3); }));
+}
+
+TEST_F(TestGUILabelControl, SetInfoProcessesAgain)
+{
+  ASSERT_TRUE(Settle());
+  EXPECT_TRUE(ProcessedAfter([this]() { m_label->SetInfo(CGUIInfoLabel("87654321")); }));
+}
+
+TEST_F(TestGUILabelControl, HidingCursorProcessesAgain)
+{
+  // a shown cursor blinks, so the label is only left out once it is hidden again
+  m_label->ShowCursor(true);
+  ProcessFrame();
+  m_label->ShowCursor(false);
+  ASSERT_TRUE(Settle());
+  EXPECT_TRUE(ProcessedAfter([this]() { m_label->ShowCursor(true); }));
+}
+
+TEST_F(TestGUILabelControl, SetLabelAndHighlightProcessesAgain)
+{
+  // as CGUIDialogNumeric moves its highlight while keeping the label
+  ASSERT_TRUE(Settle());
+  EXPECT_TRUE(ProcessedAfter([this]() {
+    m_label->SetLabel("12345678");
+    m_label->SetHighlight(4, 6);
+  }));
+}
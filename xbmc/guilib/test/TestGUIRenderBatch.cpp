@@ -0,0 +1,176 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "guilib/GUIRenderBatch.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+class CFakeBackend : public CGUIRenderBatch::IBackend
+{
+public:
+  struct Draw
+  {
+    int shader;
+    unsigned int quads;
+    float x; ///< left edge of the first quad
+  };
+
+  void DrawQuads(const CGUIRenderBatch::State &state, const PackedVertex *vertices, unsigned int quads) override
+  {
+    m_draws.push_back({ state.shader, quads, vertices[0].x });
+  }
+
+  std::vector<Draw> m_draws;
+};
+
+CGUIRenderBatch::State MakeState(int shader)
+{
+  CGUIRenderBatch::State state = { nullptr, nullptr, shader, 0xffffffff, true };
+  return state;
+}
+
+// count quads of size 10x10, the first at x, the others following it to the right
+PackedVertices MakeQuads(float x, float y, unsigned int count = 1)
+{
+  PackedVertices vertices;
+  for (unsigned int i = 0; i < count; i++, x += 10)
+  {
+    vertices.push_back({ x, y, 0, 0, 0, 0, 0 });
+    vertices.push_back({ x + 10, y, 0, 1, 0, 0, 0 });
+    vertices.push_back({ x + 10, y + 10, 0, 1, 1, 0, 0 });
+    vertices.push_back({ x, y + 10, 0, 0, 1, 0, 0 });
+  }
+  return vertices;
+}
+
+class TestGUIRenderBatch : public testing::Test
+{
+protected:
+  TestGUIRenderBatch() : m_batch(CGUIRenderBatch::GetInstance())
+  {
+    m_batch.SetBackend(&m_backend);
+  }
+
+  ~TestGUIRenderBatch() override
+  {
+    m_batch.Flush();
+    m_batch.SetBackend(nullptr);
+  }
+
+  CGUIRenderBatch &m_batch;
+  CFakeBackend m_backend;
+};
+}
+
+TEST_F(TestGUIRenderBatch, SameStateIsMerged)
+{
+  m_batch.Add(MakeState(1), MakeQuads(0, 0));
+  m_batch.Add(MakeState(2), MakeQuads(100, 0));
+  m_batch.Add(MakeState(1), MakeQuads(200, 0));
+  m_batch.Flush();
+
+  ASSERT_EQ(2u, m_backend.m_draws.size());
+  EXPECT_EQ(1, m_backend.m_draws[0].shader);
+  EXPECT_EQ(2u, m_backend.m_draws[0].quads);
+  EXPECT_EQ(0.0f, m_backend.m_draws[0].x);
+  EXPECT_EQ(2, m_backend.m_draws[1].shader);
+  EXPECT_EQ(1u, m_backend.m_draws[1].quads);
+}
+
+TEST_F(TestGUIRenderBatch, DifferentStateIsNotMerged)
+{
+  CGUIRenderBatch::State state = MakeState(1);
+  m_batch.Add(state, MakeQuads(0, 0));
+  state.color = 0xff000000;
+  m_batch.Add(state, MakeQuads(100, 0));
+  state.blend = false;
+  m_batch.Add(state, MakeQuads(200, 0));
+  m_batch.Flush();
+
+  EXPECT_EQ(3u, m_backend.m_draws.size());
+}
+
+TEST_F(TestGUIRenderBatch, OverlapKeepsPainterOrder)
+{
+  m_batch.Add(MakeState(1), MakeQuads(0, 0));
+  m_batch.Add(MakeState(2), MakeQuads(5, 5));
+  m_batch.Add(MakeState(1), MakeQuads(8, 8));
+  m_batch.Flush();
+
+  ASSERT_EQ(3u, m_backend.m_draws.size());
+  EXPECT_EQ(1, m_backend.m_draws[0].shader);
+  EXPECT_EQ(2, m_backend.m_draws[1].shader);
+  EXPECT_EQ(1, m_backend.m_draws[2].shader);
+  EXPECT_EQ(8.0f, m_backend.m_draws[2].x);
+}
+
+TEST_F(TestGUIRenderBatch, OverlapOnlyBlocksEarlierBatches)
+{
+  // the quads of state 1 overlap each other, but nothing of another state covers them
+  m_batch.Add(MakeState(1), MakeQuads(0, 0));
+  m_batch.Add(MakeState(1), MakeQuads(5, 5));
+  m_batch.Add(MakeState(2), MakeQuads(100, 0));
+  m_batch.Add(MakeState(1), MakeQuads(5, 5));
+  m_batch.Flush();
+
+  ASSERT_EQ(2u, m_backend.m_draws.size());
+  EXPECT_EQ(1, m_backend.m_draws[0].shader);
+  EXPECT_EQ(3u, m_backend.m_draws[0].quads);
+  EXPECT_EQ(2, m_backend.m_draws[1].shader);
+}
+
+TEST_F(TestGUIRenderBatch, SplitsAtMaxQuads)
+{
+  m_batch.Add(MakeState(1), MakeQuads(0, 0, CGUIRenderBatch::MAX_QUADS - 1));
+  m_batch.Add(MakeState(1), MakeQuads(0, 100));
+  m_batch.Add(MakeState(1), MakeQuads(0, 200));
+  m_batch.Flush();
+
+  ASSERT_EQ(2u, m_backend.m_draws.size());
+  EXPECT_EQ(static_cast<unsigned int>(CGUIRenderBatch::MAX_QUADS), m_backend.m_draws[0].quads);
+  EXPECT_EQ(1u, m_backend.m_draws[1].quads);
+}
+
+TEST_F(TestGUIRenderBatch, FlushDrawsOnce)
+{
+  m_batch.Add(MakeState(1), MakeQuads(0, 0));
+  m_batch.Flush();
+  m_batch.Flush();
+  EXPECT_EQ(1u, m_backend.m_draws.size());
+
+  // batches are reused after a flush
+  m_batch.Add(MakeState(2), MakeQuads(0, 0));
+  m_batch.Flush();
+  ASSERT_EQ(2u, m_backend.m_draws.size());
+  EXPECT_EQ(2, m_backend.m_draws[1].shader);
+  EXPECT_EQ(1u, m_backend.m_draws[1].quads);
+}
+
+TEST_F(TestGUIRenderBatch, NothingQueuedWithoutBackend)
+{
+  m_batch.SetBackend(nullptr);
+  m_batch.Add(MakeState(1), MakeQuads(0, 0));
+  m_batch.SetBackend(&m_backend);
+  m_batch.Flush();
+  EXPECT_TRUE(m_backend.m_draws.empty());
+}
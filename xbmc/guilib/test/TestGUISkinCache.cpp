@@ -0,0 +1,178 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "filesystem/File.h"
+#include "guilib/GUISkinCache.h"
+#include "test/TestUtils.h"
+#include "utils/Archive.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const std::string WINDOW_XML =
+  "<window id=\"1\" type=\"dialog\">"
+  "<!-- dropped -->"
+  "<controls>"
+  "<control type=\"label\"><label>Some &amp; text</label><visible>true</visible></control>"
+  "<control type=\"image\"><texture><![CDATA[a<b>.png]]></texture></control>"
+  "<control type=\"group\"/>"
+  "</controls>"
+  "</window>";
+
+// true if the cache file loads, or yields the window stored by the tests below
+bool IsAccepted(const std::string &path)
+{
+  CGUISkinCache cache;
+  bool loaded = cache.Load(path, "skin");
+  std::vector<std::string> includeFiles;
+  CGUISkinCache::Conditions conditions;
+  return cache.Get("special://skin/xml/Home.xml", includeFiles, conditions) != nullptr || loaded;
+}
+}
+
+TEST(TestGUISkinCache, SerializeRoundTrip)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(WINDOW_XML));
+  const TiXmlElement *root = doc.RootElement();
+  ASSERT_NE(nullptr, root);
+
+  std::string data = CGUISkinCache::Serialize(root);
+  ASSERT_FALSE(data.empty());
+
+  std::unique_ptr<TiXmlElement> copy = CGUISkinCache::Deserialize(data);
+  ASSERT_NE(nullptr, copy);
+  EXPECT_STREQ("window", copy->Value());
+  EXPECT_STREQ("1", copy->Attribute("id"));
+  EXPECT_STREQ("dialog", copy->Attribute("type"));
+
+  const TiXmlElement *controls = copy->FirstChildElement("controls");
+  ASSERT_NE(nullptr, controls);
+  const TiXmlElement *label = controls->FirstChildElement("control");
+  ASSERT_NE(nullptr, label);
+  EXPECT_STREQ("label", label->Attribute("type"));
+  ASSERT_NE(nullptr, label->FirstChildElement("label"));
+  EXPECT_STREQ("Some & text", label->FirstChildElement("label")->GetText());
+
+  const TiXmlElement *image = label->NextSiblingElement("control");
+  ASSERT_NE(nullptr, image);
+  const TiXmlElement *texture = image->FirstChildElement("texture");
+  ASSERT_NE(nullptr, texture);
+  ASSERT_NE(nullptr, texture->FirstChild());
+  ASSERT_NE(nullptr, texture->FirstChild()->ToText());
+  EXPECT_TRUE(texture->FirstChild()->ToText()->CDATA());
+  EXPECT_STREQ("a<b>.png", texture->GetText());
+
+  const TiXmlElement *group = image->NextSiblingElement("control");
+  ASSERT_NE(nullptr, group);
+  EXPECT_EQ(nullptr, group->FirstChild());
+  EXPECT_EQ(nullptr, group->NextSibling());
+
+  // the comment is not stored, everything else survives unchanged
+  EXPECT_EQ(controls, copy->FirstChild());
+  EXPECT_EQ(data, CGUISkinCache::Serialize(copy.get()));
+}
+
+TEST(TestGUISkinCache, DeserializeRejectsTruncatedData)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(WINDOW_XML));
+  std::string data = CGUISkinCache::Serialize(doc.RootElement());
+
+  EXPECT_EQ(nullptr, CGUISkinCache::Deserialize(""));
+  for (size_t length = 1; length < data.size(); length++)
+    EXPECT_EQ(nullptr, CGUISkinCache::Deserialize(data.substr(0, length))) << "length " << length;
+  EXPECT_EQ(nullptr, CGUISkinCache::Deserialize(data + '\0'));
+}
+
+TEST(TestGUISkinCache, EntryWithoutDependenciesIsRejected)
+{
+  XFILE::CFile *file = XBMC_CREATEARCHIVEFILE(".cache", [](CArchive &ar) {
+    CXBMCTinyXML doc;
+    doc.Parse(WINDOW_XML);
+    ar << 1; // version
+    ar << std::string("skin");
+    ar << 1; // count
+    ar << std::string("special://skin/xml/Home.xml");
+    ar << 0; // dependencies
+    ar << 0; // conditions
+    ar << CGUISkinCache::Serialize(doc.RootElement());
+  });
+  ASSERT_NE(nullptr, file);
+
+  EXPECT_FALSE(IsAccepted(XBMC_TEMPFILEPATH(file)));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestGUISkinCache, ImplausibleEntryCountIsRejected)
+{
+  XFILE::CFile *file = XBMC_CREATEARCHIVEFILE(".cache", [](CArchive &ar) {
+    ar << 1; // version
+    ar << std::string("skin");
+    ar << 100000000; // count
+    ar << std::string("special://skin/xml/Home.xml");
+  });
+  ASSERT_NE(nullptr, file);
+
+  EXPECT_FALSE(IsAccepted(XBMC_TEMPFILEPATH(file)));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestGUISkinCache, ImplausibleDependencyCountIsRejected)
+{
+  XFILE::CFile *file = XBMC_CREATEARCHIVEFILE(".cache", [](CArchive &ar) {
+    ar << 1; // version
+    ar << std::string("skin");
+    ar << 1; // count
+    ar << std::string("special://skin/xml/Home.xml");
+    ar << 100000000; // dependencies
+    ar << std::string("special://skin/xml/Home.xml");
+  });
+  ASSERT_NE(nullptr, file);
+
+  EXPECT_FALSE(IsAccepted(XBMC_TEMPFILEPATH(file)));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestGUISkinCache, ImplausibleConditionCountIsRejected)
+{
+  XFILE::CFile *file = XBMC_CREATEARCHIVEFILE(".cache", [](CArchive &ar) {
+    ar << 1; // version
+    ar << std::string("skin");
+    ar << 1; // count
+    ar << std::string("special://skin/xml/Home.xml");
+    ar << 1; // dependencies
+    ar << std::string("special://skin/xml/Home.xml");
+    ar << static_cast<int64_t>(0);
+    ar << static_cast<int64_t>(0);
+    ar << 100000000; // conditions
+  });
+  ASSERT_NE(nullptr, file);
+
+  EXPECT_FALSE(IsAccepted(XBMC_TEMPFILEPATH(file)));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/GraphicContext.h"
+#include "guilib/TextureFormats.h"
+#include "guilib/TextureManager.h"
+#include "guilib/XBTF.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+void WriteUInt32(std::string &out, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+void WriteUInt64(std::string &out, uint64_t value)
+{
+  for (int i = 0; i < 8; i++)
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+// writes a bundle holding a single unpacked 2x2 texture
+bool WriteBundle(const std::string &file, const std::string &textureName)
+{
+  const uint64_t dataSize = 2 * 2 * 4;
+  std::string out = XBTF_MAGIC + XBTF_VERSION;
+  WriteUInt32(out, 1);
+
+  std::string path(textureName);
+  path.resize(CXBTFFile::MaximumPathLength, '\0');
+  out += path;
+  WriteUInt32(out, 0); // loop
+  WriteUInt32(out, 1); // frames
+
+  const uint64_t offset = out.size() + 4 * 3 + 8 * 2 + 4 + 8;
+  WriteUInt32(out, 2); // width
+  WriteUInt32(out, 2); // height
+  WriteUInt32(out, XB_FMT_A8R8G8B8);
+  WriteUInt64(out, dataSize); // packed size, equal to the unpacked size as it isn't compressed
+  WriteUInt64(out, dataSize);
+  WriteUInt32(out, 0); // duration
+  WriteUInt64(out, offset);
+  out.append(dataSize, '\x7f');
+
+  XFILE::CFile bundle;
+  if (!bundle.OpenForWrite(file, true))
+    return false;
+  bool written = bundle.Write(out.c_str(), out.size()) == static_cast<ssize_t>(out.size());
+  bundle.Close();
+  return written;
+}
+
+class CTestTextureManager : public CGUITextureManager
+{
+public:
+  using CGUITextureManager::DecodeTextureAsync;
+};
+}
+
+class TestTextureManager : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_mediaDir = g_graphicsContext.GetMediaDir();
+    m_skinDir = CSpecialProtocol::TranslatePath("special://temp/testtexturemanager");
+    ASSERT_TRUE(XFILE::CDirectory::Create(m_skinDir));
+    ASSERT_TRUE(XFILE::CDirectory::Create(URIUtils::AddFileToFolder(m_skinDir, "media")));
+    ASSERT_TRUE(WriteBundle(URIUtils::AddFileToFolder(m_skinDir, "media", "Textures.xbt"), "test.png"));
+    g_graphicsContext.SetMediaDir(m_skinDir);
+  }
+
+  void TearDown() override
+  {
+    g_graphicsContext.SetMediaDir(m_mediaDir);
+    XFILE::CDirectory::RemoveRecursive(m_skinDir);
+  }
+
+  std::string m_mediaDir;
+  std::string m_skinDir;
+};
+
+TEST_F(TestTextureManager, DecodeBundledTextureAsync)
+{
+  CTestTextureManager manager;
+  std::string path;
+  int bundle = -1;
+  ASSERT_TRUE(manager.HasTexture("test.png", &path, &bundle));
+  EXPECT_EQ(1, bundle);
+
+  std::unique_ptr<CTextureMap> map(manager.DecodeTextureAsync("test.png", path, bundle));
+  ASSERT_NE(nullptr, map);
+  const CTextureArray &texture = map->GetTexture();
+  EXPECT_EQ(1u, texture.size());
+  EXPECT_EQ(2, texture.m_width);
+  EXPECT_EQ(2, texture.m_height);
+
+  // the workers' bundles are reset with the main ones and have to be reopened on the next decode
+  manager.Cleanup();
+  EXPECT_EQ(nullptr, manager.DecodeTextureAsync("test.png", path, 0));
+  map.reset(manager.DecodeTextureAsync("test.png", path, 1));
+  ASSERT_NE(nullptr, map);
+  EXPECT_EQ(2, map->GetTexture().m_width);
+}
+
+TEST_F(TestTextureManager, DecodeMissingBundledTextureAsync)
+{
+  CTestTextureManager manager;
+  EXPECT_EQ(nullptr, manager.DecodeTextureAsync("missing.png", "missing.png", 1));
+}
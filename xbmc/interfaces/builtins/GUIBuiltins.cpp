@@ -28,6 +28,7 @@
 #include "input/ActionTranslator.h"
 #include "input/Key.h"
 #include "input/WindowTranslator.h"
+#include "guilib/GUIFrameProfiler.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
 #include "guilib/StereoscopicsManager.h"
@@ -37,6 +38,7 @@
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "Util.h"
+#include "filesystem/SpecialProtocol.h"
 #include "utils/URIUtils.h"
 #include "utils/Screenshot.h"
 #include "utils/RssManager.h"
@@ -414,6 +416,27 @@ static int ToggleDirty(const std::vector<std::string>&)
   return 0;
 }
 
+/*! \brief Record a trace of the GUI render loop.
+ *  \param params The parameters.
+ *  \details params[0] = Number of frames to record (optional, defaults to 300).
+ */
+static int TraceGUI(const std::vector<std::string>& params)
+{
+  if (CGUIFrameProfiler::IsTracing())
+  {
+    CGUIFrameProfiler::GetInstance().StopTrace();
+    return 0;
+  }
+
+  int frames = params.empty() ? 300 : atoi(params[0].c_str());
+  if (frames <= 0)
+    return -1;
+
+  CGUIFrameProfiler::GetInstance().StartTrace(CSpecialProtocol::TranslatePath("special://home/guitrace.json"), frames);
+
+  return 0;
+}
+
 // Note: For new Texts with comma add a "\" before!!! Is used for table text.
 //
 /// \page page_List_of_built_in_functions
@@ -582,6 +605,13 @@ static int ToggleDirty(const std::vector<std::string>&)
 ///     ,
 ///     makes dirty regions visible for debugging proposes.
 ///   }
+///   \table_row2_l{
+///     <b>`TraceGUI([frames])`</b>
+///     ,
+///     Records a trace of the GUI render loop into special://home/guitrace.json\, which
+///     can be opened in chrome://tracing or ui.perfetto.dev. Stops a running trace early.
+///     @param[in] frames                Number of frames to record (optional\, defaults to 300).
+///   }
 ///  \table_end
 ///
 
@@ -604,6 +634,7 @@ CBuiltins::CommandMap CGUIBuiltins::GetOperations() const
            {"setproperty",                    {"Sets a window property for the current focused window/dialog (key,value)", 2, SetProperty}},
            {"setstereomode",                  {"Changes the stereo mode of the GUI. Params can be: toggle, next, previous, select, tomono or any of the supported stereomodes (off, split_vertical, split_horizontal, row_interleaved, hardware_based, anaglyph_cyan_red, anaglyph_green_magenta, anaglyph_yellow_blue, monoscopic)", 1, SetStereoMode}},
            {"takescreenshot",                 {"Takes a Screenshot", 0, Screenshot}},
-           {"toggledirtyregionvisualization", {"Enables/disables dirty-region visualization", 0, ToggleDirty}}
+           {"toggledirtyregionvisualization", {"Enables/disables dirty-region visualization", 0, ToggleDirty}},
+           {"tracegui",                       {"Records a trace of the GUI render loop", 0, TraceGUI}}
          };
 }
@@ -23,13 +23,15 @@
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  InfoBool::InfoBool(const std::string &expression, int context, const std::atomic<unsigned int> *domainVersions)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_domains(INFO_DOMAIN_MASK(INFO_DOMAIN_SYSTEM)),
       m_expression(expression),
-      m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_evaluated(false),
+      m_version(0),
+      m_domainVersions(domainVersions)
   {
     StringUtils::ToLower(m_expression);
   }
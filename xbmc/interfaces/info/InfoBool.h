@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <memory>
 
@@ -27,6 +28,25 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief State domains a condition may depend on.
+ Each domain has a version counter which is bumped whenever state in that domain
+ may have changed. A cached info bool is only re-evaluated once one of the domains
+ it depends on has a new version.
+ */
+enum InfoDomain
+{
+  INFO_DOMAIN_SYSTEM = 0,   ///< anything not covered below, including time dependent state
+  INFO_DOMAIN_PLAYER,       ///< state of the current player, changes continuously while playing
+  INFO_DOMAIN_CONTAINER,    ///< state of containers in the active windows
+  INFO_DOMAIN_LISTITEM,     ///< properties of the focused list items
+  INFO_DOMAIN_MAX
+};
+
+#define INFO_DOMAIN_MASK(domain) (1u << (domain))
+#define INFO_DOMAIN_MASK_ALL ((1u << INFO::INFO_DOMAIN_MAX) - 1)
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -34,7 +54,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, const std::atomic<unsigned int> *domainVersions);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -47,10 +67,15 @@ public:
   {
     if (item && m_listItemDependent)
       Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+    else
     {
-      Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      unsigned int version = GetVersion();
+      if (!m_evaluated || version != m_version)
+      {
+        Update(NULL);
+        m_version = version;
+        m_evaluated = true;
+      }
     }
     return m_value;
   }
@@ -78,16 +103,36 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief Mask of the InfoDomains this info bool depends on
+   */
+  unsigned int Domains() const { return m_domains; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_domains;      ///< mask of InfoDomains the value depends on, set by Initialize()
   std::string  m_expression;   ///< original expression
 
 private:
-  unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  /*! \brief Combined version of all domains we depend on.
+   Versions only ever increase, so their sum changes whenever one of them does.
+   */
+  inline unsigned int GetVersion() const
+  {
+    unsigned int version = 0;
+    for (unsigned int domain = 0; domain < INFO_DOMAIN_MAX; ++domain)
+    {
+      if (m_domains & INFO_DOMAIN_MASK(domain))
+        version += m_domainVersions[domain].load(std::memory_order_relaxed);
+    }
+    return version;
+  }
+
+  bool m_evaluated;
+  unsigned int m_version;
+  const std::atomic<unsigned int> *m_domainVersions;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
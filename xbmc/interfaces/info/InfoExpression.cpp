@@ -30,6 +30,7 @@ using namespace INFO;
 void InfoSingle::Initialize()
 {
   m_condition = g_infoManager.TranslateSingleString(m_expression, m_listItemDependent);
+  m_domains = g_infoManager.GetConditionDomains(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -42,36 +43,67 @@ void InfoExpression::Initialize()
   if (!Parse(m_expression))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false);
+    Compile(std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false));
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  /* Run the compiled program. Only one value is ever live since each group either
+   * exits early with the value of its last evaluated child or discards it and moves
+   * on to the next child, so a single register replaces the stack.
+   */
+  bool value = false;
+  const size_t end = m_program.size();
+  size_t pc = 0;
+  while (pc < end)
+  {
+    const Instruction &instruction = m_program[pc];
+    switch (instruction.opcode)
+    {
+      case OPCODE_LEAF:
+        value = instruction.invert ^ m_leaves[instruction.arg]->Get(item);
+        ++pc;
+        break;
+      case OPCODE_JUMP_IF_TRUE:
+        pc = value ? instruction.arg : pc + 1;
+        break;
+      case OPCODE_JUMP_IF_FALSE:
+        pc = value ? pc + 1 : instruction.arg;
+        break;
+    }
+  }
+  m_value = value;
+}
+
+InfoPtr InfoExpression::RegisterOperand(const std::string &operand)
+{
+  return g_infoManager.Register(operand, m_context);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
- * formation of groups of associative nodes. These groups are then reordered at
- * evaluation time such that nodes whose value renders the evaluation of the
- * remainder of the group unnecessary tend to be evaluated first (these are
- * true nodes for OR subexpressions, or false nodes for AND subexpressions).
- * The end effect is to minimise the number of leaf nodes that need to be
- * evaluated in order to determine the value of the expression. The runtime
- * adaptability has the advantage of not being customised for any particular skin.
+ * formation of groups of associative nodes, which are then compiled into a flat
+ * program where each group short-circuits as soon as its value is known
+ * (on the first true child of an OR, or the first false child of an AND).
  *
  * The modifications to the expression at parse time fall into two groups:
  * 1) Moving logical NOTs so that they are only applied to leaf nodes.
- *    For example, rewriting ![A+B]|C as !A|!B|C allows reordering such that
- *    any of the three leaves can be evaluated first.
+ *    For example, rewriting ![A+B]|C as !A|!B|C so that no instruction is
+ *    needed to invert the value of a group.
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * The expression as a whole depends on the union of the domains of its leaves,
+ * so it is only re-evaluated once one of those has changed.
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+void InfoExpression::InfoLeaf::Compile(InfoExpression &expression) const
 {
-  return m_invert ^ m_info->Get(item);
+  Instruction instruction = { OPCODE_LEAF, m_invert, static_cast<unsigned int>(expression.m_leaves.size()) };
+  expression.m_leaves.push_back(m_info);
+  expression.m_program.push_back(instruction);
+  expression.m_domains |= m_info->Domains();
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -94,27 +126,53 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
+void InfoExpression::InfoAssociativeGroup::Compile(InfoExpression &expression) const
+{
+  // after each child but the last, leave the group if its value decides the group
+  opcode_t exit = (m_type == NODE_AND) ? OPCODE_JUMP_IF_FALSE : OPCODE_JUMP_IF_TRUE;
+  std::vector<size_t> exits;
+  for (std::list<InfoSubexpressionPtr>::const_iterator it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if (it != m_children.begin())
+    {
+      Instruction instruction = { exit, false, 0 };
+      exits.push_back(expression.m_program.size());
+      expression.m_program.push_back(instruction);
+    }
+    (*it)->Compile(expression);
+  }
+  for (size_t jump : exits)
+    expression.m_program[jump].arg = static_cast<unsigned int>(expression.m_program.size());
+}
+
+void InfoExpression::Compile(const InfoSubexpressionPtr &tree)
+{
+  m_program.clear();
+  m_leaves.clear();
+  m_domains = 0;
+  tree->Compile(*this);
+  ThreadJumps();
+}
+
+void InfoExpression::ThreadJumps()
 {
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
+  /* A group exit lands on the exit of its parent group, where the value is already
+   * known. Follow such chains at compile time so each decision costs a single jump.
    */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
+  for (Instruction &instruction : m_program)
   {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
+    if (instruction.opcode == OPCODE_LEAF)
+      continue;
+    bool value = (instruction.opcode == OPCODE_JUMP_IF_TRUE);
+    while (instruction.arg < m_program.size())
     {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
+      const Instruction &target = m_program[instruction.arg];
+      if (target.opcode == OPCODE_LEAF)
+        break;
+      bool taken = (target.opcode == OPCODE_JUMP_IF_TRUE) == value;
+      instruction.arg = taken ? target.arg : instruction.arg + 1;
     }
   }
-  return use_and ^ result;
 }
 
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
@@ -240,7 +298,7 @@ bool InfoExpression::Parse(const std::string &expression)
       }
       if (!operand.empty())
       {
-        InfoPtr info = g_infoManager.Register(operand, m_context);
+        InfoPtr info = RegisterOperand(operand);
         if (!info)
         {
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
@@ -291,7 +349,7 @@ bool InfoExpression::Parse(const std::string &expression)
   }
   if (!operand.empty())
   {
-    InfoPtr info = g_infoManager.Register(operand, m_context);
+    InfoPtr info = RegisterOperand(operand);
     if (!info)
     {
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
@@ -304,6 +362,6 @@ bool InfoExpression::Parse(const std::string &expression)
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  Compile(nodes.top());
   return true;
 }
@@ -34,8 +34,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, const std::atomic<unsigned int> *domainVersions)
+    : InfoBool(expression, context, domainVersions) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -44,17 +44,24 @@ private:
 };
 
 /*! \brief Class to wrap active boolean expressions
+ The expression is parsed into a tree which is then compiled into a flat program
+ of leaf evaluations and short-circuit jumps.
  */
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, const std::atomic<unsigned int> *domainVersions)
+    : InfoBool(expression, context, domainVersions) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
+protected:
+  /*! \brief Get the info bool for an operand of the expression
+   \return the registered info bool, or an empty pointer if the operand is invalid
+   */
+  virtual InfoPtr RegisterOperand(const std::string &operand);
 private:
   typedef enum
   {
@@ -73,12 +80,26 @@ private:
     NODE_OR,
   } node_type_t;
 
+  typedef enum
+  {
+    OPCODE_LEAF,          // value = leaf[arg] ^ invert
+    OPCODE_JUMP_IF_TRUE,  // if (value) goto arg
+    OPCODE_JUMP_IF_FALSE, // if (!value) goto arg
+  } opcode_t;
+
+  struct Instruction
+  {
+    opcode_t opcode;
+    bool invert;
+    unsigned int arg;
+  };
+
   // An abstract base class for nodes in the expression tree
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
+    virtual void Compile(InfoExpression &expression) const = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -89,7 +110,7 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    bool Evaluate(const CGUIListItem *item) override;
+    void Compile(InfoExpression &expression) const override;
     node_type_t Type() const override { return NODE_LEAF; };
   private:
     InfoPtr m_info;
@@ -103,7 +124,7 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    bool Evaluate(const CGUIListItem *item) override;
+    void Compile(InfoExpression &expression) const override;
     node_type_t Type() const override { return m_type; };
   private:
     node_type_t m_type;
@@ -113,7 +134,11 @@ private:
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  void Compile(const InfoSubexpressionPtr &tree);
+  void ThreadJumps();
+
+  std::vector<Instruction> m_program;
+  std::vector<InfoPtr> m_leaves;
 };
 
 };
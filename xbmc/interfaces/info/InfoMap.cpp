@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "InfoMap.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+
+using namespace INFO;
+
+CInfoMapIndex::CInfoMapIndex(const infomap *table, size_t size)
+{
+  // drop repeated keys, keeping the first as a linear scan would
+  std::vector<const infomap*> keys;
+  for (size_t i = 0; i < size; ++i)
+  {
+    bool seen = false;
+    for (const infomap *key : keys)
+    {
+      size_t length = strlen(key->str);
+      if (length == strlen(table[i].str) && Equals(key->str, table[i].str, length))
+      {
+        seen = true;
+        break;
+      }
+    }
+    if (!seen)
+      keys.push_back(&table[i]);
+  }
+
+  const size_t slotCount = std::max<size_t>(keys.size(), 1);
+  const size_t bucketCount = std::max<size_t>(keys.size() / 2, 1);
+
+  std::vector<std::vector<const infomap*>> buckets(bucketCount);
+  for (const infomap *key : keys)
+    buckets[Hash(key->str, strlen(key->str), 0) % bucketCount].push_back(key);
+
+  // place the largest buckets first while most slots are still free
+  std::vector<size_t> order(bucketCount);
+  for (size_t i = 0; i < bucketCount; ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&buckets](size_t a, size_t b) {
+    return buckets[a].size() > buckets[b].size();
+  });
+
+  m_seeds.assign(bucketCount, 0);
+  Slot empty = { NULL, 0 };
+  m_slots.assign(slotCount, empty);
+
+  std::vector<size_t> placed;
+  for (size_t bucket : order)
+  {
+    const std::vector<const infomap*> &members = buckets[bucket];
+    if (members.empty())
+      break;
+
+    // distinct keys are placed within a handful of seeds, running out means the hash is broken
+    for (uint32_t seed = 1; ; ++seed)
+    {
+      if (seed > MAX_SEED)
+        throw std::logic_error("CInfoMapIndex: unable to place the keys of " + std::string(members[0]->str));
+
+      placed.clear();
+      for (const infomap *key : members)
+      {
+        size_t slot = Hash(key->str, strlen(key->str), seed) % slotCount;
+        if (m_slots[slot].entry || std::find(placed.begin(), placed.end(), slot) != placed.end())
+          break;
+        placed.push_back(slot);
+      }
+      if (placed.size() == members.size())
+      {
+        for (size_t i = 0; i < members.size(); ++i)
+        {
+          m_slots[placed[i]].entry = members[i];
+          m_slots[placed[i]].length = strlen(members[i]->str);
+        }
+        m_seeds[bucket] = seed;
+        break;
+      }
+    }
+  }
+}
+
+const infomap *CInfoMapIndex::Find(const char *key, size_t length) const
+{
+  uint32_t seed = m_seeds[Hash(key, length, 0) % m_seeds.size()];
+  if (!seed)
+    return NULL;
+
+  const Slot &slot = m_slots[Hash(key, length, seed) % m_slots.size()];
+  if (slot.entry && slot.length == length && Equals(slot.entry->str, key, length))
+    return slot.entry;
+  return NULL;
+}
+
+bool CInfoMapIndex::Equals(const char *left, const char *right, size_t length)
+{
+  return memcmp(left, right, length) == 0;
+}
+
+uint32_t CInfoMapIndex::Hash(const char *key, size_t length, uint32_t seed)
+{
+  // FNV-1a with the seed mixed into the offset basis
+  uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+  for (size_t i = 0; i < length; ++i)
+  {
+    hash ^= static_cast<uint32_t>(static_cast<unsigned char>(key[i]));
+    hash *= 16777619u;
+  }
+  // FNV leaves the low bits poorly mixed, finish with the murmur3 avalanche
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  hash ^= hash >> 16;
+  return hash;
+}
@@ -0,0 +1,76 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+typedef struct
+{
+  const char *str;
+  int  val;
+} infomap;
+
+namespace INFO
+{
+/*!
+ \ingroup info
+ \brief Minimal perfect hash over a static infomap table.
+
+ The index is built once from the table using hash and displace: keys are grouped
+ into buckets by a first hash, and each bucket gets a seed for a second hash that
+ places all of its keys into distinct slots. A lookup costs two hashes of the key
+ and a single string comparison. Keys are matched exactly, as the tables are
+ lower case the caller lower cases keys which may be in any case. If a key occurs
+ more than once in the table the first occurrence wins, as it would for a linear
+ scan.
+ */
+class CInfoMapIndex
+{
+public:
+  template<size_t N>
+  explicit CInfoMapIndex(const infomap (&table)[N]) : CInfoMapIndex(table, N) {}
+  CInfoMapIndex(const infomap *table, size_t size);
+
+  /*! \brief Find the entry for the given key
+   \param key the key to look up
+   \return the matching table entry, or NULL if the key is not in the table
+   */
+  const infomap *Find(const std::string &key) const { return Find(key.c_str(), key.size()); }
+  const infomap *Find(const char *key, size_t length) const;
+
+private:
+  static const uint32_t MAX_SEED = 1 << 20; ///< seeds tried per bucket before giving up
+
+  static uint32_t Hash(const char *key, size_t length, uint32_t seed);
+  static bool Equals(const char *left, const char *right, size_t length);
+
+  struct Slot
+  {
+    const infomap *entry;
+    size_t length;
+  };
+
+  std::vector<uint32_t> m_seeds; ///< displacement seed per bucket
+  std::vector<Slot> m_slots;     ///< one slot per distinct key
+};
+}
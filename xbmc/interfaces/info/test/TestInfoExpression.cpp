@@ -0,0 +1,234 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "interfaces/info/InfoExpression.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+
+using namespace INFO;
+
+namespace
+{
+class CFakeInfo : public InfoBool
+{
+public:
+  CFakeInfo(const std::string &expression, unsigned int domains, const std::atomic<unsigned int> *versions)
+    : InfoBool(expression, 0, versions)
+  {
+    m_domains = domains;
+  }
+
+  void Update(const CGUIListItem *item) override
+  {
+    m_evaluations++;
+    m_value = m_state;
+  }
+
+  bool m_state = false;
+  unsigned int m_evaluations = 0;
+};
+
+class CTestInfoExpression : public InfoExpression
+{
+public:
+  CTestInfoExpression(const std::string &expression, const std::atomic<unsigned int> *versions,
+                      const std::map<std::string, InfoPtr> &operands)
+    : InfoExpression(expression, 0, versions), m_operands(operands) {}
+
+protected:
+  InfoPtr RegisterOperand(const std::string &operand) override
+  {
+    auto it = m_operands.find(operand);
+    return it != m_operands.end() ? it->second : InfoPtr();
+  }
+
+private:
+  const std::map<std::string, InfoPtr> &m_operands;
+};
+
+class TestInfoExpression : public testing::Test
+{
+protected:
+  TestInfoExpression()
+  {
+    for (auto &version : m_versions)
+      version = 0;
+    a = AddOperand("a", INFO_DOMAIN_MASK(INFO_DOMAIN_SYSTEM));
+    b = AddOperand("b", INFO_DOMAIN_MASK(INFO_DOMAIN_PLAYER));
+    c = AddOperand("c", INFO_DOMAIN_MASK(INFO_DOMAIN_LISTITEM));
+  }
+
+  std::shared_ptr<CFakeInfo> AddOperand(const std::string &name, unsigned int domains)
+  {
+    auto info = std::make_shared<CFakeInfo>(name, domains, m_versions);
+    m_operands[name] = info;
+    return info;
+  }
+
+  std::shared_ptr<CTestInfoExpression> Compile(const std::string &expression)
+  {
+    auto info = std::make_shared<CTestInfoExpression>(expression, m_versions, m_operands);
+    info->Initialize();
+    return info;
+  }
+
+  // sets the operands and invalidates every cached value
+  void Set(bool valueA, bool valueB, bool valueC)
+  {
+    a->m_state = valueA;
+    b->m_state = valueB;
+    c->m_state = valueC;
+    for (auto &version : m_versions)
+      version++;
+  }
+
+  void ResetEvaluations()
+  {
+    a->m_evaluations = b->m_evaluations = c->m_evaluations = 0;
+  }
+
+  std::atomic<unsigned int> m_versions[INFO_DOMAIN_MAX];
+  std::map<std::string, InfoPtr> m_operands;
+  std::shared_ptr<CFakeInfo> a;
+  std::shared_ptr<CFakeInfo> b;
+  std::shared_ptr<CFakeInfo> c;
+};
+}
+
+TEST_F(TestInfoExpression, MatchesTruthTables)
+{
+  struct
+  {
+    const char *expression;
+    bool (*expected)(bool, bool, bool);
+  } cases[] = {
+    { "a+b",          [](bool a, bool b, bool c) { return a && b; } },
+    { "a|b",          [](bool a, bool b, bool c) { return a || b; } },
+    { "!a",           [](bool a, bool b, bool c) { return !a; } },
+    { "!!a",          [](bool a, bool b, bool c) { return a; } },
+    { "a|b+c",        [](bool a, bool b, bool c) { return a || (b && c); } },
+    { "a+b|c",        [](bool a, bool b, bool c) { return (a && b) || c; } },
+    { "[a|b]+c",      [](bool a, bool b, bool c) { return (a || b) && c; } },
+    { "![a+b]",       [](bool a, bool b, bool c) { return !(a && b); } },
+    { "![a|b]+c",     [](bool a, bool b, bool c) { return !(a || b) && c; } },
+    { "!a|![b+!c]",   [](bool a, bool b, bool c) { return !a || !(b && !c); } },
+    { "[a|b]|[c+a]",  [](bool a, bool b, bool c) { return a || b || (c && a); } },
+  };
+
+  for (const auto &test : cases)
+  {
+    auto expression = Compile(test.expression);
+    for (unsigned int bits = 0; bits < 8; bits++)
+    {
+      bool valueA = bits & 1, valueB = bits & 2, valueC = bits & 4;
+      Set(valueA, valueB, valueC);
+      EXPECT_EQ(test.expected(valueA, valueB, valueC), expression->Get())
+        << test.expression << " with a=" << valueA << " b=" << valueB << " c=" << valueC;
+    }
+  }
+}
+
+TEST_F(TestInfoExpression, AndShortCircuits)
+{
+  auto expression = Compile("a+b+c");
+  Set(false, true, true);
+  ResetEvaluations();
+  EXPECT_FALSE(expression->Get());
+  EXPECT_EQ(1u, a->m_evaluations);
+  EXPECT_EQ(0u, b->m_evaluations);
+  EXPECT_EQ(0u, c->m_evaluations);
+
+  Set(true, false, true);
+  ResetEvaluations();
+  EXPECT_FALSE(expression->Get());
+  EXPECT_EQ(1u, b->m_evaluations);
+  EXPECT_EQ(0u, c->m_evaluations);
+}
+
+TEST_F(TestInfoExpression, OrShortCircuits)
+{
+  auto expression = Compile("a|b|c");
+  Set(true, false, false);
+  ResetEvaluations();
+  EXPECT_TRUE(expression->Get());
+  EXPECT_EQ(1u, a->m_evaluations);
+  EXPECT_EQ(0u, b->m_evaluations);
+  EXPECT_EQ(0u, c->m_evaluations);
+}
+
+TEST_F(TestInfoExpression, NestedGroupShortCircuits)
+{
+  // a decides the inner AND, which then decides nothing for the OR
+  auto expression = Compile("[a+b]|c");
+  Set(false, true, true);
+  ResetEvaluations();
+  EXPECT_TRUE(expression->Get());
+  EXPECT_EQ(0u, b->m_evaluations);
+  EXPECT_EQ(1u, c->m_evaluations);
+
+  // a true inner AND leaves the OR without evaluating c
+  Set(true, true, true);
+  ResetEvaluations();
+  EXPECT_TRUE(expression->Get());
+  EXPECT_EQ(0u, c->m_evaluations);
+}
+
+TEST_F(TestInfoExpression, NegatedGroupShortCircuits)
+{
+  // ![a|b] is rewritten to !a+!b, so a true a decides the expression
+  auto expression = Compile("![a|b]");
+  Set(true, false, false);
+  ResetEvaluations();
+  EXPECT_FALSE(expression->Get());
+  EXPECT_EQ(1u, a->m_evaluations);
+  EXPECT_EQ(0u, b->m_evaluations);
+}
+
+TEST_F(TestInfoExpression, DomainsAreUnionOfOperands)
+{
+  EXPECT_EQ(INFO_DOMAIN_MASK(INFO_DOMAIN_SYSTEM) | INFO_DOMAIN_MASK(INFO_DOMAIN_PLAYER),
+            Compile("a+!b")->Domains());
+  EXPECT_EQ(INFO_DOMAIN_MASK(INFO_DOMAIN_SYSTEM) | INFO_DOMAIN_MASK(INFO_DOMAIN_PLAYER) |
+            INFO_DOMAIN_MASK(INFO_DOMAIN_LISTITEM),
+            Compile("![a|b]+c")->Domains());
+}
+
+TEST_F(TestInfoExpression, CachesUntilDomainChanges)
+{
+  auto expression = Compile("a+b");
+  Set(true, true, false);
+  EXPECT_TRUE(expression->Get());
+
+  // a change in a domain neither operand depends on keeps the cached value
+  a->m_state = false;
+  ResetEvaluations();
+  m_versions[INFO_DOMAIN_CONTAINER]++;
+  EXPECT_TRUE(expression->Get());
+  EXPECT_EQ(0u, a->m_evaluations);
+
+  // a change in the domain of one operand updates only that operand
+  m_versions[INFO_DOMAIN_SYSTEM]++;
+  EXPECT_FALSE(expression->Get());
+  EXPECT_EQ(1u, a->m_evaluations);
+  EXPECT_EQ(0u, b->m_evaluations);
+}
@@ -0,0 +1,105 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/info/InfoMap.h"
+
+#include "gtest/gtest.h"
+
+using namespace INFO;
+
+namespace
+{
+const infomap test_map[] = {{ "isplaying",       1 },
+                            { "hasaudio",        2 },
+                            { "hasvideo",        3 },
+                            { "time",            4 },
+                            { "duration",        5 },
+                            { "time",            6 },
+                            { "volume",          7 }};
+}
+
+TEST(TestInfoMap, FindsEveryKey)
+{
+  CInfoMapIndex index(test_map);
+  const infomap *entry = index.Find("hasvideo");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(3, entry->val);
+  entry = index.Find("volume");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(7, entry->val);
+}
+
+TEST(TestInfoMap, FirstDuplicateWins)
+{
+  CInfoMapIndex index(test_map);
+  const infomap *entry = index.Find("time");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(4, entry->val);
+}
+
+TEST(TestInfoMap, CaseSensitive)
+{
+  // matches the string comparison of the linear scan it replaces
+  CInfoMapIndex index(test_map);
+  EXPECT_TRUE(index.Find(std::string("IsPlaying")) == NULL);
+  EXPECT_TRUE(index.Find(std::string("ISPLAYING")) == NULL);
+  EXPECT_TRUE(index.Find(std::string("isplaying")) != NULL);
+}
+
+TEST(TestInfoMap, KeysDifferingInCase)
+{
+  const infomap mixed_map[] = {{ "time", 1 },
+                               { "Time", 2 }};
+  CInfoMapIndex index(mixed_map);
+  const infomap *entry = index.Find("time");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(1, entry->val);
+  entry = index.Find("Time");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(2, entry->val);
+}
+
+TEST(TestInfoMap, MissingKeys)
+{
+  CInfoMapIndex index(test_map);
+  EXPECT_TRUE(index.Find("") == NULL);
+  EXPECT_TRUE(index.Find("isplayin") == NULL);
+  EXPECT_TRUE(index.Find("isplayingx") == NULL);
+  EXPECT_TRUE(index.Find("unknown") == NULL);
+}
+
+TEST(TestInfoMap, LargeTable)
+{
+  std::vector<std::string> keys;
+  std::vector<infomap> table;
+  for (int i = 0; i < 1000; i++)
+    keys.push_back("key" + std::to_string(i));
+  for (int i = 0; i < 1000; i++)
+    table.push_back({ keys[i].c_str(), i });
+
+  CInfoMapIndex index(table.data(), table.size());
+  for (int i = 0; i < 1000; i++)
+  {
+    const infomap *entry = index.Find(keys[i]);
+    ASSERT_TRUE(entry != NULL);
+    EXPECT_EQ(i, entry->val);
+  }
+  EXPECT_TRUE(index.Find("key1000") == NULL);
+}
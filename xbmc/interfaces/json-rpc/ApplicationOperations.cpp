@@ -29,6 +29,7 @@
 #include "GUIInfoManager.h"
 #include "system.h"
 #include "CompileInfo.h"
+#include "cores/AudioEngine/Utils/AETelemetry.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include <string.h>
@@ -112,6 +113,12 @@ JSONRPC_STATUS CApplicationOperations::Quit(const std::string &method, ITranspor
   return ACK;
 }
 
+JSONRPC_STATUS CApplicationOperations::GetAudioEngineStats(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CAETelemetry::GetInstance().Serialize(result);
+  return OK;
+}
+
 JSONRPC_STATUS CApplicationOperations::GetPropertyValue(const std::string &property, CVariant &result)
 {
   if (property == "volume")
@@ -20,6 +20,9 @@
 
 #include "MusicDatabase.h"
 
+#include <atomic>
+#include <set>
+
 #include "addons/Addon.h"
 #include "addons/AddonManager.h"
 #include "addons/AddonSystemSettings.h"
@@ -56,9 +59,11 @@
 #include "storage/MediaManager.h"
 #include "system.h"
 #include "TextureCache.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
 #include "utils/FileUtils.h"
+#include "utils/JobManager.h"
 #include "utils/LegacyPathTranslation.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
@@ -75,6 +80,13 @@ using KODI::MESSAGING::HELPERS::DialogResponse;
 
 #define RECENTLY_PLAYED_LIMIT 25
 #define MIN_FULL_SEARCH_LENGTH 3
+#define SEARCH_INDEX_CHUNK 2000 // queued items indexed per transaction
+
+namespace
+{
+CCriticalSection searchIndexSection;
+std::atomic<bool> searchIndexQueued(false);
+}
 
 #ifdef HAS_DVD_DRIVE
 using namespace CDDB;
@@ -156,6 +168,10 @@ void CMusicDatabase::CreateTables()
               " strReleaseType text, "
               " idInfoSetting INTEGER NOT NULL DEFAULT 0)");
 
+  CLog::Log(LOGINFO, "create albumstats table");
+  m_pDS->exec("CREATE TABLE albumstats (idAlbum integer primary key, iTimesPlayed float, "
+              " dateAdded text, lastplayed varchar(20) default NULL)");
+
   CLog::Log(LOGINFO, "create audiobook table");
   m_pDS->exec("CREATE TABLE audiobook (idBook integer primary key, "
               " strBook varchar(256), strAuthor text,"
@@ -200,6 +216,10 @@ void CMusicDatabase::CreateTables()
   CLog::Log(LOGINFO, "create art table");
   m_pDS->exec("CREATE TABLE art(art_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, type TEXT, url TEXT)");
 
+  CLog::Log(LOGINFO, "create search tables");
+  m_pDS->exec("CREATE TABLE searchword (word varchar(255), media_id integer, media_type text)");
+  m_pDS->exec("CREATE TABLE searchqueue (idQueue integer primary key, media_id integer, media_type text)");
+
   CLog::Log(LOGINFO, "create versiontagscan table");
   m_pDS->exec("CREATE TABLE versiontagscan (idVersion integer, iNeedsScan integer)");
   m_pDS->exec(PrepareSQL("INSERT INTO versiontagscan (idVersion, iNeedsScan) values(%i, 0)", GetSchemaVersion()));
@@ -249,29 +269,97 @@ void CMusicDatabase::CreateAnalytics()
 
   m_pDS->exec("CREATE INDEX ix_art ON art(media_id, media_type(20), type(20))");
 
+  m_pDS->exec("CREATE INDEX idxAlbumStats_1 ON albumstats(iTimesPlayed)");
+  m_pDS->exec("CREATE INDEX idxAlbumStats_2 ON albumstats(lastplayed)");
+
+  m_pDS->exec("CREATE INDEX idxSearchWord_1 ON searchword(media_type(20), word(255))");
+  m_pDS->exec("CREATE INDEX idxSearchWord_2 ON searchword(media_id, media_type(20))");
+
   CLog::Log(LOGINFO, "create triggers");
   m_pDS->exec("CREATE TRIGGER tgrDeleteAlbum AFTER delete ON album FOR EACH ROW BEGIN"
               "  DELETE FROM song WHERE song.idAlbum = old.idAlbum;"
               "  DELETE FROM album_artist WHERE album_artist.idAlbum = old.idAlbum;"
               "  DELETE FROM album_genre WHERE album_genre.idAlbum = old.idAlbum;"
               "  DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album';"
+              "  DELETE FROM albumstats WHERE albumstats.idAlbum = old.idAlbum;"
+              "  DELETE FROM searchword WHERE media_id=old.idAlbum AND media_type='album';"
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteArtist AFTER delete ON artist FOR EACH ROW BEGIN"
               "  DELETE FROM album_artist WHERE album_artist.idArtist = old.idArtist;"
               "  DELETE FROM song_artist WHERE song_artist.idArtist = old.idArtist;"
               "  DELETE FROM discography WHERE discography.idArtist = old.idArtist;"
               "  DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist';"
+              "  DELETE FROM searchword WHERE media_id=old.idArtist AND media_type='artist';"
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteSong AFTER delete ON song FOR EACH ROW BEGIN"
               "  DELETE FROM song_artist WHERE song_artist.idSong = old.idSong;"
               "  DELETE FROM song_genre WHERE song_genre.idSong = old.idSong;"
               "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song';"
+              "  DELETE FROM searchword WHERE media_id=old.idSong AND media_type='song'; " +
+              GetAlbumStatsUpdate("idAlbum = old.idAlbum") +
+              " END");
+
+  // keep the album stats up to date with the songs and their playcounts,
+  // and queue changed items for (re)indexing their words for searching
+  m_pDS->exec("CREATE TRIGGER tgrInsertAlbum AFTER insert ON album FOR EACH ROW BEGIN"
+              "  INSERT INTO albumstats (idAlbum) VALUES (new.idAlbum);"
+              "  INSERT INTO searchqueue (media_id, media_type) VALUES (new.idAlbum, 'album');"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateAlbum AFTER update ON album FOR EACH ROW BEGIN " +
+              GetSearchQueueUpdate("album", "idAlbum", "strAlbum") +
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrInsertArtist AFTER insert ON artist FOR EACH ROW BEGIN"
+              "  INSERT INTO searchqueue (media_id, media_type) VALUES (new.idArtist, 'artist');"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateArtist AFTER update ON artist FOR EACH ROW BEGIN " +
+              GetSearchQueueUpdate("artist", "idArtist", "strArtist") +
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrInsertSong AFTER insert ON song FOR EACH ROW BEGIN " +
+              GetAlbumStatsUpdate("idAlbum = new.idAlbum") +
+              "  INSERT INTO searchqueue (media_id, media_type) VALUES (new.idSong, 'song');"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateSong AFTER update ON song FOR EACH ROW BEGIN " +
+              GetAlbumStatsUpdate("idAlbum IN (old.idAlbum, new.idAlbum)") +
+              GetSearchQueueUpdate("song", "idSong", "strTitle") +
               " END");
   
   // we create views last to ensure all indexes are rolled in
   CreateViews();
 }
 
+std::string CMusicDatabase::GetAlbumStatsUpdate(const std::string &where) const
+{
+  return "UPDATE albumstats SET "
+         "iTimesPlayed = (SELECT AVG(song.iTimesPlayed) FROM song WHERE song.idAlbum = albumstats.idAlbum), "
+         "dateAdded = (SELECT MAX(song.dateAdded) FROM song WHERE song.idAlbum = albumstats.idAlbum), "
+         "lastplayed = (SELECT MAX(song.lastplayed) FROM song WHERE song.idAlbum = albumstats.idAlbum) "
+         "WHERE " + where + ";";
+}
+
+std::string CMusicDatabase::GetSearchQueueUpdate(const std::string &table, const std::string &idField, const std::string &textField) const
+{
+  // only the indexed text needs reindexing. MySQL has no WHEN clause for triggers, so the
+  // condition is part of the insert. The text may be NULL, which never compares unequal
+  return "INSERT INTO searchqueue (media_id, media_type) "
+         "SELECT new." + idField + ", '" + table + "' FROM " + table + " "
+         "WHERE " + idField + " = new." + idField + " AND "
+         "COALESCE(old." + textField + ", '') <> COALESCE(new." + textField + ", '');";
+}
+
+std::set<std::string> CMusicDatabase::GetSearchWords(const std::string &text)
+{
+  std::set<std::string> words;
+  for (const auto &split : StringUtils::Split(text, " "))
+  {
+    if (split.empty())
+      continue;
+    std::string word = split.substr(0, 255);
+    StringUtils::ToLower(word);
+    words.insert(word);
+  }
+  return words;
+}
+
 void CMusicDatabase::CreateViews()
 {
   CLog::Log(LOGINFO, "create song view");
@@ -330,11 +418,13 @@ void CMusicDatabase::CreateViews()
               "        bCompilation, "
               "        bScrapedMBID,"
               "        lastScraped,"
-              "        (SELECT AVG(song.iTimesPlayed) FROM song WHERE song.idAlbum = album.idAlbum) AS iTimesPlayed, "
+              "        albumstats.iTimesPlayed AS iTimesPlayed, "
               "        strReleaseType, "
-              "        (SELECT MAX(song.dateAdded) FROM song WHERE song.idAlbum = album.idAlbum) AS dateAdded, "
-              "        (SELECT MAX(song.lastplayed) FROM song WHERE song.idAlbum = album.idAlbum) AS lastplayed "
+              "        albumstats.dateAdded AS dateAdded, "
+              "        albumstats.lastplayed AS lastplayed "
               "FROM album"
+              "  LEFT JOIN albumstats ON"
+              "    albumstats.idAlbum = album.idAlbum"
               );
 
   CLog::Log(LOGINFO, "create artist view");
@@ -2259,7 +2349,7 @@ int CMusicDatabase::GetSongByArtistAndAlbumAndTitle(const std::string& strArtist
   return -1;
 }
 
-bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &artists)
+bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &artists, bool useIndex)
 {
   try
   {
@@ -2267,14 +2357,14 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
     if (NULL == m_pDS.get()) return false;
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
-    std::string strSQL;
+    std::string strSQL = "select * from artist where ";
+    if (useIndex)
+      strSQL += GetSearchIndexFilter(search, MediaTypeArtist, "idArtist");
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from artist "
-                                "where (strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
+      strSQL += PrepareSQL("(strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
                                 , search.c_str(), search.c_str(), strVariousArtists.c_str() );
     else
-      strSQL=PrepareSQL("select * from artist "
-                                "where strArtist like '%s%%' and strArtist <> '%s' "
+      strSQL += PrepareSQL("strArtist like '%s%%' and strArtist <> '%s' "
                                 , search.c_str(), strVariousArtists.c_str() );
 
     if (!m_pDS->query(strSQL)) return false;
@@ -2784,24 +2874,152 @@ void CMusicDatabase::EmptyCache()
 bool CMusicDatabase::Search(const std::string& search, CFileItemList &items)
 {
   unsigned int time = XbmcThreads::SystemClockMillis();
+  // recent changes (or the whole library after an upgrade) may not be indexed yet. They are
+  // indexed in the background, until then the search can't rely on the index
+  bool useIndex = GetSingleValue("SELECT idQueue FROM searchqueue LIMIT 1").empty();
+  if (!useIndex)
+    QueueSearchIndexUpdate();
+
   // first grab all the artists that match
-  SearchArtists(search, items);
+  SearchArtists(search, items, useIndex);
   CLog::Log(LOGDEBUG, "%s Artist search in %i ms",
             __FUNCTION__, XbmcThreads::SystemClockMillis() - time); time = XbmcThreads::SystemClockMillis();
 
   // then albums that match
-  SearchAlbums(search, items);
+  SearchAlbums(search, items, useIndex);
   CLog::Log(LOGDEBUG, "%s Album search in %i ms",
             __FUNCTION__, XbmcThreads::SystemClockMillis() - time); time = XbmcThreads::SystemClockMillis();
 
   // and finally songs
-  SearchSongs(search, items);
+  SearchSongs(search, items, useIndex);
   CLog::Log(LOGDEBUG, "%s Songs search in %i ms",
             __FUNCTION__, XbmcThreads::SystemClockMillis() - time); time = XbmcThreads::SystemClockMillis();
   return true;
 }
 
-bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items)
+void CMusicDatabase::UpdateSearchIndex()
+{
+  static const struct
+  {
+    const char *mediaType;
+    const char *table;
+    const char *idField;
+    const char *textField;
+  } searchTables[] = {
+    { MediaTypeArtist, "artist", "idArtist", "strArtist" },
+    { MediaTypeAlbum,  "album",  "idAlbum",  "strAlbum" },
+    { MediaTypeSong,   "song",   "idSong",   "strTitle" },
+  };
+
+  try
+  {
+    if (NULL == m_pDB.get()) return;
+    if (NULL == m_pDS.get()) return;
+
+    // the job and the scanner may both be indexing
+    CSingleLock lock(searchIndexSection);
+    while (true)
+    {
+      // index in chunks, so a large queue doesn't keep the database locked for long.
+      // only handle what's queued now, the triggers may queue more while we index
+      std::string lastQueued = GetSingleValue(PrepareSQL("SELECT idQueue FROM searchqueue ORDER BY idQueue LIMIT 1 OFFSET %i", SEARCH_INDEX_CHUNK - 1));
+      if (lastQueued.empty())
+        lastQueued = GetSingleValue("SELECT MAX(idQueue) FROM searchqueue");
+      if (lastQueued.empty())
+        return;
+
+      BeginTransaction();
+      for (const auto &searchTable : searchTables)
+      {
+        std::string queued = PrepareSQL("SELECT media_id FROM searchqueue WHERE media_type = '%s' AND idQueue <= %s",
+                                        searchTable.mediaType, lastQueued.c_str());
+        m_pDS->exec(PrepareSQL("DELETE FROM searchword WHERE media_type = '%s' AND media_id IN (%s)",
+                               searchTable.mediaType, queued.c_str()));
+
+        if (!m_pDS->query(PrepareSQL("SELECT %s, %s FROM %s WHERE %s IN (%s)",
+                                     searchTable.idField, searchTable.textField, searchTable.table,
+                                     searchTable.idField, queued.c_str())))
+          continue;
+
+        std::string insert;
+        while (!m_pDS->eof())
+        {
+          for (const auto &word : GetSearchWords(m_pDS->fv(1).get_asString()))
+            insert += PrepareSQL("%s('%s', %i, '%s')", insert.empty() ? "" : ",",
+                                 word.c_str(), m_pDS->fv(0).get_asInt(), searchTable.mediaType);
+
+          if (insert.size() > 100000)
+          {
+            m_pDS2->exec("INSERT INTO searchword (word, media_id, media_type) VALUES " + insert);
+            insert.clear();
+          }
+          m_pDS->next();
+        }
+        m_pDS->close();
+
+        if (!insert.empty())
+          m_pDS2->exec("INSERT INTO searchword (word, media_id, media_type) VALUES " + insert);
+      }
+      m_pDS->exec(PrepareSQL("DELETE FROM searchqueue WHERE idQueue <= %s", lastQueued.c_str()));
+      if (!CommitTransaction())
+        return;
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+}
+
+void CMusicDatabase::QueueSearchIndexUpdate()
+{
+  bool queued = false;
+  if (!searchIndexQueued.compare_exchange_strong(queued, true))
+    return;
+
+  CJobManager::GetInstance().Submit([]() {
+    CMusicDatabase database;
+    if (database.Open())
+    {
+      unsigned int time = XbmcThreads::SystemClockMillis();
+      database.UpdateSearchIndex();
+      database.Close();
+      CLog::Log(LOGDEBUG, "CMusicDatabase::QueueSearchIndexUpdate - index updated in %u ms", XbmcThreads::SystemClockMillis() - time);
+    }
+    searchIndexQueued = false;
+  }, CJob::PRIORITY_LOW_PAUSABLE);
+}
+
+std::string CMusicDatabase::GetSearchIndexFilter(const std::string &search, const std::string &mediaType, const std::string &idField)
+{
+  // the phrase matches at the start of a word, so all items found contain a word
+  // starting with its first word, or equal to it if more words follow.
+  // wildcards would match more than that, so can't use the index
+  size_t end = search.find(' ');
+  std::string word = search.substr(0, end);
+  if (word.empty() || word.size() > 255 || word.find_first_of("%_") != std::string::npos)
+    return "";
+  StringUtils::ToLower(word);
+
+  std::string match;
+  if (end != std::string::npos)
+    match = PrepareSQL("word = '%s'", word.c_str());
+  else if (static_cast<unsigned char>(word.back()) < 0x7f)
+  {
+    // all words with the prefix sort before the prefix with its last character incremented
+    std::string next = word;
+    next.back()++;
+    match = PrepareSQL("word >= '%s' AND word < '%s'", word.c_str(), next.c_str());
+  }
+  else
+    match = PrepareSQL("word LIKE '%s%%'", word.c_str());
+
+  return PrepareSQL("%s IN (SELECT media_id FROM searchword WHERE media_type = '%s' AND %s) AND ",
+                    idField.c_str(), mediaType.c_str(), match.c_str());
+}
+
+bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items, bool useIndex)
 {
   try
   {
@@ -2812,11 +3030,13 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
     if (!baseUrl.FromString("musicdb://songs/"))
       return false;
 
-    std::string strSQL;
+    std::string strSQL = "select * from songview where ";
+    if (useIndex)
+      strSQL += GetSearchIndexFilter(search, MediaTypeSong, "idSong");
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
+      strSQL += PrepareSQL("(strTitle like '%s%%' or strTitle like '%% %s%%') limit 1000", search.c_str(), search.c_str());
     else
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
+      strSQL += PrepareSQL("strTitle like '%s%%' limit 1000", search.c_str());
 
     if (!m_pDS->query(strSQL)) return false;
     if (m_pDS->num_rows() == 0) return false;
@@ -2841,18 +3061,20 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
   return false;
 }
 
-bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albums)
+bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albums, bool useIndex)
 {
   try
   {
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string strSQL;
+    std::string strSQL = "select * from albumview where ";
+    if (useIndex)
+      strSQL += GetSearchIndexFilter(search, MediaTypeAlbum, "idAlbum");
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
+      strSQL += PrepareSQL("(strAlbum like '%s%%' or strAlbum like '%% %s%%')", search.c_str(), search.c_str());
     else
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
+      strSQL += PrepareSQL("strAlbum like '%s%%'", search.c_str());
 
     if (!m_pDS->query(strSQL)) return false;
 
@@ -5172,6 +5394,25 @@ void CMusicDatabase::UpdateTables(int version)
     // Remove albuminfosong table
     m_pDS->exec("DROP TABLE albuminfosong");
   }
+  if (version < 68)
+  {
+    // The album playcount and dates were aggregated from the songs by albumview, now kept up to date by triggers
+    m_pDS->exec("CREATE TABLE albumstats (idAlbum integer primary key, iTimesPlayed float, "
+                " dateAdded text, lastplayed varchar(20) default NULL)");
+    m_pDS->exec("INSERT INTO albumstats (idAlbum, iTimesPlayed, dateAdded, lastplayed) "
+                "SELECT album.idAlbum, AVG(song.iTimesPlayed), MAX(song.dateAdded), MAX(song.lastplayed) "
+                "FROM album LEFT JOIN song ON song.idAlbum = album.idAlbum "
+                "GROUP BY album.idAlbum");
+  }
+  if (version < 69)
+  {
+    // Add the index for searching, queue everything for it to be built in the background
+    m_pDS->exec("CREATE TABLE searchword (word varchar(255), media_id integer, media_type text)");
+    m_pDS->exec("CREATE TABLE searchqueue (idQueue integer primary key, media_id integer, media_type text)");
+    m_pDS->exec("INSERT INTO searchqueue (media_id, media_type) SELECT idArtist, 'artist' FROM artist");
+    m_pDS->exec("INSERT INTO searchqueue (media_id, media_type) SELECT idAlbum, 'album' FROM album");
+    m_pDS->exec("INSERT INTO searchqueue (media_id, media_type) SELECT idSong, 'song' FROM song");
+  }
   // Set the verion of tag scanning required. 
   // Not every schema change requires the tags to be rescanned, set to the highest schema version 
   // that needs this. Forced rescanning (of music files that have not changed since they were 
@@ -5191,7 +5432,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 67;
+  return 69;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -198,6 +198,25 @@ public:
   bool GetSongByFileName(const std::string& strFileName, CSong& song, int startOffset = 0);
   bool GetSongsByPath(const std::string& strPath, MAPSONGS& songs, bool bAppendToMap = false);
   bool Search(const std::string& search, CFileItemList &items);
+
+  /*! \brief Index the words of the songs, albums and artists that changed since the last call.
+   The triggers queue every changed item in searchqueue, so the searchword index is brought up
+   to date here regardless of which code path modified the library. Searches don't use the index
+   while items are queued, see QueueSearchIndexUpdate.
+   */
+  void UpdateSearchIndex();
+
+  /*! \brief Update the search index from a background job, unless one is already queued.
+   */
+  static void QueueSearchIndexUpdate();
+
+  /*! \brief Split a text into the words indexed for searching.
+   Words are separated by spaces, lower-cased and cut to 255 characters, the way the searches
+   match them.
+   \param text the song title, album or artist name.
+   \return the distinct words of the text.
+   */
+  static std::set<std::string> GetSearchWords(const std::string &text);
   bool RemoveSongsFromPath(const std::string &path, MAPSONGS& songs, bool exact=true);
   bool SetSongUserrating(const std::string &filePath, int userrating);
   bool SetSongVotes(const std::string &filePath, int votes);
@@ -554,6 +573,21 @@ private:
    */
   virtual void CreateViews();
 
+  /*! \brief Get the SQL that recalculates the playcount and last played/added dates
+   of the albums matching the given condition from their songs.
+   albumstats holds these so that listing albums doesn't need to aggregate all songs.
+   \param where condition on albumstats.idAlbum selecting the albums to update.
+   */
+  std::string GetAlbumStatsUpdate(const std::string &where) const;
+
+  /*! \brief Get the SQL for an update trigger queueing the item for the search index when
+   its indexed text changed.
+   \param table the table of the items, also their media type.
+   \param idField the id field of the items.
+   \param textField the field holding the text indexed.
+   */
+  std::string GetSearchQueueUpdate(const std::string &table, const std::string &idField, const std::string &textField) const;
+
   CSong GetSongFromDataset();
   CSong GetSongFromDataset(const dbiplus::sql_record* const record, int offset = 0);
   CArtist GetArtistFromDataset(dbiplus::Dataset* pDS, int offset = 0, bool needThumb = true);
@@ -580,9 +614,20 @@ private:
   bool CleanupInfoSettings();
   bool CleanupRoles();
   void UpdateTables(int version) override;
-  bool SearchArtists(const std::string& search, CFileItemList &artists);
-  bool SearchAlbums(const std::string& search, CFileItemList &albums);
-  bool SearchSongs(const std::string& strSearch, CFileItemList &songs);
+  bool SearchArtists(const std::string& search, CFileItemList &artists, bool useIndex);
+  bool SearchAlbums(const std::string& search, CFileItemList &albums, bool useIndex);
+  bool SearchSongs(const std::string& strSearch, CFileItemList &songs, bool useIndex);
+
+  /*! \brief Get a condition narrowing a search down to the items having a word starting with
+   the first word of the search phrase.
+   The condition only preselects items using the searchword index, the caller still needs to match
+   the phrase itself.
+   \param search the phrase searched for.
+   \param mediaType the media type of the items searched.
+   \param idField the id field of the items searched.
+   \return the condition followed by " AND ", or an empty string if the index can't be used.
+   */
+  std::string GetSearchIndexFilter(const std::string &search, const std::string &mediaType, const std::string &idField);
   int GetSongIDFromPath(const std::string &filePath);
 
   bool m_translateBlankArtist;
@@ -21,6 +21,7 @@
 #include "MusicInfoScanner.h"
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "ServiceBroker.h"
@@ -47,13 +48,18 @@
 #include "music/MusicThumbLoader.h"
 #include "music/tags/MusicInfoTag.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/MusicTagCache.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "NfoFile.h"
+#include "ScanJournal.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
+#include "threads/Event.h"
 #include "threads/SystemClock.h"
+#include "URL.h"
+#include "utils/Job.h"
 #include "Util.h"
 #include "utils/log.h"
 #include "utils/md5.h"
@@ -67,11 +73,61 @@ using namespace MUSICDATABASEDIRECTORY;
 using namespace MUSIC_GRABBER;
 using namespace ADDON;
 
+#define TAG_CACHE_FILE     "special://database/MusicTags.cache"
+#define TAG_READERS_LOCAL  4
+#define TAG_READERS_REMOTE 2
+
+namespace
+{
+/*! \brief Shared completion state of a batch of tag reading jobs.
+ Held by the jobs themselves so a cancelled scan can return while reads are still in flight.
+ */
+struct TagReadBatch
+{
+  std::atomic<int> remaining{0};
+  CEvent done;
+};
+
+class CTagReadJob : public CJob
+{
+public:
+  CTagReadJob(const CFileItemPtr &item,
+              const std::shared_ptr<CMusicTagCache> &cache,
+              const std::shared_ptr<TagReadBatch> &batch)
+    : m_item(item), m_cache(cache), m_batch(batch)
+  {
+  }
+
+  bool DoWork() override
+  {
+    CMusicInfoTag& tag = *m_item->GetMusicInfoTag();
+    if (!m_cache->Get(*m_item, tag))
+    {
+      std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(*m_item));
+      if (NULL != pLoader.get() && pLoader->Load(m_item->GetPath(), tag))
+        m_cache->Set(*m_item, tag);
+    }
+
+    if (--m_batch->remaining == 0)
+      m_batch->done.Set();
+    return true;
+  }
+
+  const char *GetType() const override { return "musictagread"; }
+
+private:
+  CFileItemPtr m_item;
+  std::shared_ptr<CMusicTagCache> m_cache;
+  std::shared_ptr<TagReadBatch> m_batch;
+};
+}
+
 CMusicInfoScanner::CMusicInfoScanner()
 : CThread("MusicInfoScanner"),
   m_needsCleanup(false),
   m_scanType(0),
-  m_fileCountReader(this, "MusicFileCounter")
+  m_fileCountReader(this, "MusicFileCounter"),
+  m_tagCache(std::make_shared<CMusicTagCache>())
 {
   m_bRunning = false;
   m_showDialog = false;
@@ -115,6 +171,7 @@ void CMusicInfoScanner::Process()
     if (m_scanType == 0) // load info from files
     {
       CLog::Log(LOGDEBUG, "%s - Starting scan", __FUNCTION__);
+      m_tagCache->Load(TAG_CACHE_FILE);
 
       if (m_handle)
         m_handle->SetTitle(g_localizeStrings.Get(505));
@@ -167,6 +224,9 @@ void CMusicInfoScanner::Process()
       {
         g_infoManager.ResetLibraryBools();
 
+        // index what was added now rather than on the next search
+        m_musicDatabase.UpdateSearchIndex();
+
         if (m_needsCleanup)
         {
           if (m_handle)
@@ -263,6 +323,7 @@ void CMusicInfoScanner::Process()
   {
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
   }
+  m_tagCache->Save();
   m_musicDatabase.Close();
   CLog::Log(LOGDEBUG, "%s - Finished scan", __FUNCTION__);
   
@@ -496,22 +557,50 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   // Discard all excluded files defined by m_musicExcludeRegExps
   const std::vector<std::string> &regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
-  if (IsExcluded(strDirectory, regexps))
+  // a folder the change journal vouches for needs no filesystem access at all
+  std::string dbHash;
+  std::vector<std::string> subfolders;
+  unsigned int journalToken = 0;
+  bool unchanged = false;
+  if (g_advancedSettings.m_bMusicLibraryUseChangeJournal && !(m_flags & SCAN_RESCAN))
+  {
+    journalToken = CScanJournal::GetInstance().BeginScan(strDirectory);
+    unchanged = m_musicDatabase.GetPathHash(strDirectory, dbHash) && CScanJournal::GetInstance().IsUnchanged(strDirectory, dbHash, &subfolders);
+  }
+
+  if (unchanged ? CUtil::ExcludeFileOrFolder(strDirectory, regexps) : IsExcluded(strDirectory, regexps))
     return true;
 
   // load subfolder
   CFileItemList items;
-  CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg");
-
-  // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
-  // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
-  // if we have a changed hash.
-  items.Sort(SortByLabel, SortOrderAscending);
   std::string hash;
-  GetPathHash(items, hash);
+  if (unchanged)
+    hash = dbHash;
+  else
+  {
+    bool listed = CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg");
+
+    // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
+    // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
+    // if we have a changed hash.
+    items.Sort(SortByLabel, SortOrderAscending);
+    GetPathHash(items, hash);
+
+    // if we have a directory item (non-playlist) we then recurse into that folder
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      const CFileItemPtr pItem = items[i];
+      if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
+        subfolders.push_back(pItem->GetPath());
+    }
+
+    // forget the cached tags of files that have gone. A failed listing (e.g. an
+    // unreachable share) says nothing about them
+    if (listed)
+      m_tagCache->Prune(strDirectory, items);
+  }
 
   // check whether we need to rescan or not
-  std::string dbHash;
   if ((m_flags & SCAN_RESCAN) || !m_musicDatabase.GetPathHash(strDirectory, dbHash) || dbHash != hash)
   { // path has changed - rescan
     if (dbHash.empty())
@@ -535,8 +624,14 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   }
   else
   { // path is the same - no need to rescan
-    CLog::Log(LOGDEBUG, "%s Skipping dir '%s' due to no change", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
-    m_currentItem += CountFiles(items, false);  // false for non-recursive
+    CLog::Log(LOGDEBUG, "%s Skipping dir '%s' due to no change%s", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str(), unchanged ? " (journal)" : "");
+    if (unchanged)
+    { // the folder wasn't listed, the songs stored for it stand in for its files
+      CDatabase::Filter filter(m_musicDatabase.PrepareSQL("strPath = '%s'", strDirectory.c_str()));
+      m_currentItem += m_musicDatabase.GetSongsCount(filter);
+    }
+    else
+      m_currentItem += CountFiles(items, false);  // false for non-recursive
 
     // updated the dialog with our progress
     if (m_handle)
@@ -547,21 +642,18 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     }
   }
 
+  if (journalToken)
+    CScanJournal::GetInstance().SetScanned(strDirectory, journalToken, hash, subfolders);
+
   // now scan the subfolders
-  for (int i = 0; i < items.Size(); ++i)
+  for (const auto &subfolder : subfolders)
   {
-    CFileItemPtr pItem = items[i];
-
     if (m_bStop)
       break;
-    // if we have a directory item (non-playlist) we then recurse into that folder
-    if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
+
+    if (!DoScan(subfolder))
     {
-      std::string strPath=pItem->GetPath();
-      if (!DoScan(strPath))
-      {
-        m_bStop = true;
-      }
+      m_bStop = true;
     }
   }
   return !m_bStop;
@@ -571,11 +663,9 @@ INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList&
 {
   std::vector<std::string> regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> tagItems;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -584,15 +674,42 @@ INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList&
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
-    m_currentItem++;
+    tagItems.push_back(pItem);
+  }
 
-    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
+  // read the tags in parallel, bounded per source so a single NAS isn't flooded with requests
+  std::shared_ptr<TagReadBatch> batch(new TagReadBatch);
+  std::vector<CFileItemPtr> loadItems;
+  for (const auto& pItem : tagItems)
+  {
+    if (!pItem->GetMusicInfoTag()->Loaded())
+      loadItems.push_back(pItem);
+  }
+  if (!loadItems.empty())
+  {
+    CJobQueue& reader = GetTagReader(loadItems.front()->GetPath());
+    batch->remaining = static_cast<int>(loadItems.size());
+    for (const auto& pItem : loadItems)
+      reader.AddJob(new CTagReadJob(pItem, m_tagCache, batch));
+
+    while (!batch->done.WaitMSec(100))
     {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (NULL != pLoader.get())
-        pLoader->Load(pItem->GetPath(), tag);
+      if (m_bStop)
+      {
+        reader.CancelJobs();
+        return INFO_CANCELLED;
+      }
     }
+  }
+
+  for (const auto& pItem : tagItems)
+  {
+    if (m_bStop)
+      return INFO_CANCELLED;
+
+    m_currentItem++;
+
+    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
 
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
@@ -616,6 +733,18 @@ INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList&
   return INFO_ADDED;
 }
 
+CJobQueue& CMusicInfoScanner::GetTagReader(const std::string& path)
+{
+  // all shares of a remote host use the same queue, local files get one of their own
+  bool remote = URIUtils::IsRemote(path);
+  std::string source = remote ? CURL(path).GetHostName() : "";
+
+  std::unique_ptr<CJobQueue>& reader = m_tagReaders[source];
+  if (!reader)
+    reader.reset(new CJobQueue(false, remote ? TAG_READERS_REMOTE : TAG_READERS_LOCAL, CJob::PRIORITY_NORMAL));
+  return *reader;
+}
+
 static bool SortSongsByTrack(const CSong& song, const CSong& song2)
 {
   return song.iTrack < song2.iTrack;
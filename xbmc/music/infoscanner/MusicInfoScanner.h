@@ -18,11 +18,15 @@
  *  <http://www.gnu.org/licenses/>.
  *
  */
+#include <map>
+#include <memory>
+
 #include "InfoScanner.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "music/MusicDatabase.h"
 #include "threads/Thread.h"
+#include "utils/JobManager.h"
 
 class CAlbum;
 class CArtist;
@@ -30,6 +34,8 @@ class CGUIDialogProgressBarHandle;
 
 namespace MUSIC_INFO
 {
+class CMusicTagCache;
+
 /*! \brief return values from the information lookup functions
  */
 enum INFO_RET 
@@ -191,6 +197,13 @@ protected:
    \param scannedItems [in] list to populate with the scannedItems
    */
   INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief Get the job queue reading tags for the source of the given path
+   Each remote host and the local filesystem have their own queue to bound the
+   number of concurrent reads per source.
+   \param path [in] path of a file on the source
+   */
+  CJobQueue& GetTagReader(const std::string& path);
   int GetPathHash(const CFileItemList &items, std::string &hash);
   void GetAlbumArtwork(long id, const CAlbum &artist);
 
@@ -227,5 +240,7 @@ protected:
   std::set<std::string> m_seenPaths;
   int m_flags;
   CThread m_fileCountReader;
+  std::shared_ptr<CMusicTagCache> m_tagCache;
+  std::map<std::string, std::unique_ptr<CJobQueue>> m_tagReaders;
 };
 }
@@ -944,6 +944,11 @@ void CMusicInfoTag::Archive(CArchive& ar)
     ar << m_coverArt;
     ar << m_cuesheet;
     ar << static_cast<int>(m_albumReleaseType);
+    ar << m_strComposerSort;
+    ar << m_strAlbumArtistSort;
+    ar << m_musicBrainzArtistHints;
+    ar << m_musicBrainzAlbumArtistHints;
+    ar << m_replayGain.Get();
   }
   else
   {
@@ -1002,6 +1007,14 @@ void CMusicInfoTag::Archive(CArchive& ar)
     int albumReleaseType;
     ar >> albumReleaseType;
     m_albumReleaseType = static_cast<CAlbum::ReleaseType>(albumReleaseType);
+
+    ar >> m_strComposerSort;
+    ar >> m_strAlbumArtistSort;
+    ar >> m_musicBrainzArtistHints;
+    ar >> m_musicBrainzAlbumArtistHints;
+    std::string replayGain;
+    ar >> replayGain;
+    m_replayGain.Set(replayGain);
   }
 }
 
@@ -0,0 +1,202 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MusicTagCache.h"
+#include "FileItem.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <set>
+#include <stdexcept>
+
+using namespace XFILE;
+using namespace MUSIC_INFO;
+
+bool CMusicTagCache::Load(const std::string &file)
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+  m_file = file;
+  m_dirty = false;
+
+  CFile cacheFile;
+  if (!cacheFile.Open(file))
+    return false;
+
+  CArchive ar(&cacheFile, CArchive::load);
+  int version = 0;
+  int count = 0;
+  ar >> version;
+  if (version != CACHE_VERSION)
+  {
+    CLog::Log(LOGDEBUG, "CMusicTagCache::Load - discarding cache %s with version %d", file.c_str(), version);
+    m_dirty = true; // so that the stale cache is overwritten
+    return false;
+  }
+
+  // every entry takes at least the length of its path and its size, so the
+  // count can't exceed what the file holds
+  ar >> count;
+  if (count < 0 || count > cacheFile.GetLength() / static_cast<int64_t>(sizeof(uint32_t) + sizeof(int64_t)))
+  {
+    CLog::Log(LOGERROR, "CMusicTagCache::Load - cache %s is corrupt", file.c_str());
+    m_dirty = true;
+    return false;
+  }
+
+  try
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      std::string path;
+      CacheEntry entry;
+      ar >> path;
+      ar >> entry.size;
+      ar >> entry.modified;
+      ar >> entry.tag;
+      m_entries.insert(std::make_pair(path, entry));
+    }
+  }
+  catch (const std::out_of_range &)
+  {
+    CLog::Log(LOGERROR, "CMusicTagCache::Load - cache %s is corrupt", file.c_str());
+    m_entries.clear();
+    m_dirty = true;
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "CMusicTagCache::Load - loaded %u tags from %s", static_cast<unsigned int>(m_entries.size()), file.c_str());
+  return true;
+}
+
+bool CMusicTagCache::Save()
+{
+  CSingleLock lock(m_section);
+  if (!m_dirty || m_file.empty())
+    return true;
+
+  if (m_entries.size() > MAX_ENTRIES)
+  {
+    for (auto it = m_entries.begin(); it != m_entries.end() && m_entries.size() > MAX_ENTRIES; )
+    {
+      if (!it->second.used)
+        it = m_entries.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  CFile cacheFile;
+  if (!cacheFile.OpenForWrite(m_file, true))
+  {
+    CLog::Log(LOGERROR, "CMusicTagCache::Save - unable to write %s", m_file.c_str());
+    return false;
+  }
+
+  CArchive ar(&cacheFile, CArchive::store);
+  ar << CACHE_VERSION;
+  ar << static_cast<int>(m_entries.size());
+  for (auto &it : m_entries)
+  {
+    ar << it.first;
+    ar << it.second.size;
+    ar << it.second.modified;
+    ar << it.second.tag;
+  }
+  ar.Close();
+  cacheFile.Close();
+
+  m_dirty = false;
+  return true;
+}
+
+bool CMusicTagCache::Get(const CFileItem &item, CMusicInfoTag &tag)
+{
+  if (!IsCacheable(item))
+    return false;
+
+  CSingleLock lock(m_section);
+  auto it = m_entries.find(item.GetPath());
+  if (it == m_entries.end())
+    return false;
+
+  if (it->second.size != item.m_dwSize || it->second.modified != item.m_dateTime)
+  {
+    m_entries.erase(it);
+    m_dirty = true;
+    return false;
+  }
+
+  it->second.used = true;
+  tag = it->second.tag;
+  return true;
+}
+
+void CMusicTagCache::Set(const CFileItem &item, const CMusicInfoTag &tag)
+{
+  if (!IsCacheable(item) || !tag.Loaded())
+    return;
+
+  CSingleLock lock(m_section);
+  CacheEntry &entry = m_entries[item.GetPath()];
+  entry.size = item.m_dwSize;
+  entry.modified = item.m_dateTime;
+  entry.tag = tag;
+  entry.used = true;
+  m_dirty = true;
+}
+
+void CMusicTagCache::Prune(const std::string &directory, const CFileItemList &items)
+{
+  std::set<std::string> paths;
+  for (int i = 0; i < items.Size(); ++i)
+    paths.insert(items[i]->GetPath());
+
+  CSingleLock lock(m_section);
+  for (auto it = m_entries.lower_bound(directory); it != m_entries.end() && StringUtils::StartsWith(it->first, directory); )
+  {
+    // keep files that are listed, and anything below a listed subfolder
+    std::string relative = it->first.substr(directory.size());
+    size_t separator = relative.find_first_of("/\\");
+    std::string child = directory + (separator == std::string::npos ? relative : relative.substr(0, separator + 1));
+    if (paths.find(child) == paths.end())
+    {
+      it = m_entries.erase(it);
+      m_dirty = true;
+    }
+    else
+      ++it;
+  }
+}
+
+void CMusicTagCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_dirty = !m_entries.empty();
+  m_entries.clear();
+}
+
+bool CMusicTagCache::IsCacheable(const CFileItem &item)
+{
+  return item.m_dwSize > 0 && item.m_dateTime.IsValid();
+}
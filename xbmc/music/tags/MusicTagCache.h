@@ -0,0 +1,101 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "MusicInfoTag.h"
+#include "XBDateTime.h"
+#include "threads/CriticalSection.h"
+
+class CFileItem;
+class CFileItemList;
+
+namespace MUSIC_INFO
+{
+  /*!
+   \brief Persistent cache of parsed music tags.
+
+   Tags are keyed by path and validated against the size and modification time
+   reported by the directory listing, so an unchanged file is never re-opened
+   on rescan. All methods are thread safe.
+   */
+  class CMusicTagCache
+  {
+  public:
+    CMusicTagCache() = default;
+
+    /*! \brief Load the cache from disk, replacing the current contents.
+     \param file path of the cache file.
+     \return true if the cache was loaded.
+     */
+    bool Load(const std::string &file);
+
+    /*! \brief Write the cache to the file it was loaded from, if it changed.
+     Entries that were not used during this session are dropped first once the cache
+     exceeds MAX_ENTRIES.
+     \return true if the cache is up to date on disk.
+     */
+    bool Save();
+
+    /*! \brief Retrieve the cached tag for an item.
+     \param item the item to look up, its size and date must be set.
+     \param tag [out] the cached tag.
+     \return true if a valid tag was found.
+     */
+    bool Get(const CFileItem &item, CMusicInfoTag &tag);
+
+    /*! \brief Store the tag for an item.
+     Items without size or date information are not cached.
+     */
+    void Set(const CFileItem &item, const CMusicInfoTag &tag);
+
+    /*! \brief Drop the entries of files that are no longer in a directory.
+     Entries below subfolders that are no longer listed are dropped as well.
+     \param directory path of the directory that was listed.
+     \param items the listing of the directory.
+     */
+    void Prune(const std::string &directory, const CFileItemList &items);
+
+    void Clear();
+
+  private:
+    struct CacheEntry
+    {
+      int64_t size = 0;
+      CDateTime modified;
+      CMusicInfoTag tag;
+      bool used = false;
+    };
+
+    // bump whenever the layout of the cache or of CMusicInfoTag::Archive changes,
+    // caches written with another version are discarded
+    static const int CACHE_VERSION = 2;
+    static const size_t MAX_ENTRIES = 250000;
+
+    static bool IsCacheable(const CFileItem &item);
+
+    std::map<std::string, CacheEntry> m_entries;
+    std::string m_file;
+    bool m_dirty = false;
+    CCriticalSection m_section;
+  };
+}
@@ -35,7 +35,9 @@ TagLibVFSStream::TagLibVFSStream(const std::string& strFileName, bool readOnly)
   m_bIsOpen = true;
   if (readOnly)
   {
-    if (!m_file.Open(strFileName))
+    // tags live in small regions at the start and end of the file, so seek directly
+    // (range requests where the VFS supports them) instead of filling a read cache
+    if (!m_file.Open(strFileName, READ_NO_CACHE))
       m_bIsOpen = false;
   }
   else
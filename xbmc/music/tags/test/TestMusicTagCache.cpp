@@ -0,0 +1,171 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "filesystem/File.h"
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/MusicTagCache.h"
+#include "test/TestUtils.h"
+#include "utils/Archive.h"
+
+#include "gtest/gtest.h"
+
+using namespace MUSIC_INFO;
+
+namespace
+{
+CFileItem MakeItem(const std::string &path, int64_t size)
+{
+  CFileItem item(path, false);
+  item.m_dwSize = size;
+  item.m_dateTime = CDateTime(2017, 5, 1, 12, 0, 0);
+  return item;
+}
+
+CMusicInfoTag MakeTag(const std::string &title)
+{
+  CMusicInfoTag tag;
+  tag.SetTitle(title);
+  tag.SetArtist("Artist");
+  tag.SetTrackNumber(3);
+  tag.SetLoaded(true);
+  return tag;
+}
+}
+
+TEST(TestMusicTagCache, GetAfterSet)
+{
+  CMusicTagCache cache;
+  CFileItem item = MakeItem("/music/a.flac", 1000);
+  cache.Set(item, MakeTag("Title"));
+
+  CMusicInfoTag tag;
+  ASSERT_TRUE(cache.Get(item, tag));
+  EXPECT_EQ("Title", tag.GetTitle());
+  EXPECT_EQ(3, tag.GetTrackNumber());
+}
+
+TEST(TestMusicTagCache, ChangedFileIsInvalidated)
+{
+  CMusicTagCache cache;
+  CFileItem item = MakeItem("/music/a.flac", 1000);
+  cache.Set(item, MakeTag("Title"));
+
+  CMusicInfoTag tag;
+  CFileItem resized = MakeItem("/music/a.flac", 1001);
+  EXPECT_FALSE(cache.Get(resized, tag));
+
+  CFileItem touched = MakeItem("/music/a.flac", 1000);
+  touched.m_dateTime = CDateTime(2017, 5, 2, 12, 0, 0);
+  EXPECT_FALSE(cache.Get(touched, tag));
+}
+
+TEST(TestMusicTagCache, ItemsWithoutStatAreNotCached)
+{
+  CMusicTagCache cache;
+  CFileItem item("/music/a.flac", false);
+  cache.Set(item, MakeTag("Title"));
+
+  CMusicInfoTag tag;
+  EXPECT_FALSE(cache.Get(item, tag));
+}
+
+TEST(TestMusicTagCache, SaveAndLoad)
+{
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".cache");
+  ASSERT_NE(nullptr, file);
+  std::string path = XBMC_TEMPFILEPATH(file);
+  file->Close();
+
+  CFileItem item = MakeItem("/music/a.flac", 1000);
+  {
+    CMusicTagCache cache;
+    cache.Load(path);
+    cache.Set(item, MakeTag("Title"));
+    EXPECT_TRUE(cache.Save());
+  }
+
+  CMusicTagCache cache;
+  ASSERT_TRUE(cache.Load(path));
+  CMusicInfoTag tag;
+  ASSERT_TRUE(cache.Get(item, tag));
+  EXPECT_EQ("Title", tag.GetTitle());
+  EXPECT_TRUE(tag.Loaded());
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestMusicTagCache, PruneDropsMissingFiles)
+{
+  CMusicTagCache cache;
+  CFileItem kept = MakeItem("/music/a.flac", 1000);
+  CFileItem removed = MakeItem("/music/b.flac", 1000);
+  CFileItem inKeptFolder = MakeItem("/music/album/c.flac", 1000);
+  CFileItem inRemovedFolder = MakeItem("/music/gone/d.flac", 1000);
+  CFileItem elsewhere = MakeItem("/other/e.flac", 1000);
+  for (const CFileItem *item : { &kept, &removed, &inKeptFolder, &inRemovedFolder, &elsewhere })
+    cache.Set(*item, MakeTag("Title"));
+
+  CFileItemList items;
+  items.Add(CFileItemPtr(new CFileItem(kept)));
+  items.Add(CFileItemPtr(new CFileItem("/music/album/", true)));
+  cache.Prune("/music/", items);
+
+  CMusicInfoTag tag;
+  EXPECT_TRUE(cache.Get(kept, tag));
+  EXPECT_FALSE(cache.Get(removed, tag));
+  EXPECT_TRUE(cache.Get(inKeptFolder, tag));
+  EXPECT_FALSE(cache.Get(inRemovedFolder, tag));
+  EXPECT_TRUE(cache.Get(elsewhere, tag));
+}
+
+TEST(TestMusicTagCache, OtherVersionIsDiscarded)
+{
+  XFILE::CFile *file = XBMC_CREATEARCHIVEFILE(".cache", [](CArchive &ar) {
+    ar << 1; // version
+    ar << 1; // count
+    ar << std::string("/music/a.flac");
+  });
+  ASSERT_NE(nullptr, file);
+
+  CMusicTagCache cache;
+  EXPECT_FALSE(cache.Load(XBMC_TEMPFILEPATH(file)));
+  CMusicInfoTag tag;
+  EXPECT_FALSE(cache.Get(MakeItem("/music/a.flac", 1000), tag));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestMusicTagCache, ImplausibleCountIsDiscarded)
+{
+  XFILE::CFile *file = XBMC_CREATEARCHIVEFILE(".cache", [](CArchive &ar) {
+    ar << 2; // version
+    ar << 100000000; // count
+    ar << std::string("/music/a.flac");
+  });
+  ASSERT_NE(nullptr, file);
+
+  CMusicTagCache cache;
+  EXPECT_FALSE(cache.Load(XBMC_TEMPFILEPATH(file)));
+  CMusicInfoTag tag;
+  EXPECT_FALSE(cache.Get(MakeItem("/music/a.flac", 1000), tag));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
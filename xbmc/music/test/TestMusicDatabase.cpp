@@ -0,0 +1,198 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <cstdlib>
+
+#include "FileItem.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/MusicDatabase.h"
+#include "settings/AdvancedSettings.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+class CTestMusicDatabase : public CMusicDatabase
+{
+public:
+  bool Create()
+  {
+    XFILE::CFile::Delete("special://temp/TestMusic1.db");
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    return Connect("TestMusic1", settings, true);
+  }
+
+  void Exec(const std::string &sql)
+  {
+    m_pDS->exec(sql);
+  }
+
+  int GetQueued()
+  {
+    return atoi(GetSingleValue("SELECT COUNT(*) FROM searchqueue").c_str());
+  }
+
+  // the indexed words of an item, in order
+  std::string GetWords(const std::string &mediaType, int id)
+  {
+    std::unique_ptr<dbiplus::Dataset> ds(m_pDB->CreateDataset());
+    ds->query(PrepareSQL("SELECT word FROM searchword WHERE media_type = '%s' AND media_id = %i ORDER BY word",
+                         mediaType.c_str(), id));
+    std::string words;
+    while (!ds->eof())
+    {
+      words += (words.empty() ? "" : " ") + ds->fv(0).get_asString();
+      ds->next();
+    }
+    ds->close();
+    return words;
+  }
+};
+
+class TestMusicDatabase : public testing::Test
+{
+protected:
+  TestMusicDatabase()
+  {
+    m_created = m_db.Create();
+  }
+
+  ~TestMusicDatabase() override
+  {
+    m_db.Close();
+    XFILE::CFile::Delete("special://temp/TestMusic1.db");
+  }
+
+  CTestMusicDatabase m_db;
+  bool m_created;
+};
+}
+
+TEST(TestMusicSearchWords, SplitsOnSpaces)
+{
+  std::set<std::string> expected = { "one", "two", "three" };
+  EXPECT_EQ(expected, CMusicDatabase::GetSearchWords("One  two Three "));
+}
+
+TEST(TestMusicSearchWords, KeepsPunctuation)
+{
+  // the searches match at the start of space separated words only
+  std::set<std::string> expected = { "(live)", "rock'n'roll", "ac/dc" };
+  EXPECT_EQ(expected, CMusicDatabase::GetSearchWords("Rock'n'Roll AC/DC (Live)"));
+}
+
+TEST(TestMusicSearchWords, Distinct)
+{
+  std::set<std::string> expected = { "la" };
+  EXPECT_EQ(expected, CMusicDatabase::GetSearchWords("La la LA"));
+}
+
+TEST(TestMusicSearchWords, LongWords)
+{
+  std::set<std::string> words = CMusicDatabase::GetSearchWords(std::string(300, 'a'));
+  ASSERT_EQ(1u, words.size());
+  EXPECT_EQ(255u, words.begin()->size());
+}
+
+TEST(TestMusicSearchWords, Empty)
+{
+  EXPECT_TRUE(CMusicDatabase::GetSearchWords("").empty());
+  EXPECT_TRUE(CMusicDatabase::GetSearchWords("   ").empty());
+}
+
+TEST_F(TestMusicDatabase, IndexesInsertedItems)
+{
+  ASSERT_TRUE(m_created);
+  m_db.Exec("INSERT INTO artist (idArtist, strArtist) VALUES (1, 'The Blue Notes')");
+  m_db.Exec("INSERT INTO album (idAlbum, strAlbum) VALUES (2, 'Blue Train')");
+  m_db.Exec("INSERT INTO song (idSong, idAlbum, strTitle) VALUES (3, 2, 'Moment''s Notice')");
+  EXPECT_EQ(3, m_db.GetQueued());
+
+  m_db.UpdateSearchIndex();
+  EXPECT_EQ(0, m_db.GetQueued());
+  EXPECT_EQ("blue notes the", m_db.GetWords("artist", 1));
+  EXPECT_EQ("blue train", m_db.GetWords("album", 2));
+  EXPECT_EQ("moment's notice", m_db.GetWords("song", 3));
+}
+
+TEST_F(TestMusicDatabase, QueuesChangedTextOnly)
+{
+  ASSERT_TRUE(m_created);
+  m_db.Exec("INSERT INTO artist (idArtist, strArtist) VALUES (1, 'Blue')");
+  m_db.Exec("INSERT INTO album (idAlbum, strAlbum) VALUES (2, 'Blue')");
+  m_db.Exec("INSERT INTO song (idSong, idAlbum, strTitle) VALUES (3, 2, 'Blue')");
+  m_db.UpdateSearchIndex();
+
+  // playing or rating items doesn't change what they're found by
+  m_db.Exec("UPDATE artist SET strBiography = 'biography' WHERE idArtist = 1");
+  m_db.Exec("UPDATE album SET iUserrating = 5 WHERE idAlbum = 2");
+  m_db.Exec("UPDATE song SET iTimesPlayed = 1, lastplayed = '2017-01-01 00:00:00' WHERE idSong = 3");
+  m_db.Exec("UPDATE song SET strTitle = 'Blue' WHERE idSong = 3");
+  EXPECT_EQ(0, m_db.GetQueued());
+
+  m_db.Exec("UPDATE artist SET strArtist = 'Red' WHERE idArtist = 1");
+  m_db.Exec("UPDATE album SET strAlbum = NULL WHERE idAlbum = 2");
+  m_db.Exec("UPDATE song SET strTitle = 'Green' WHERE idSong = 3");
+  EXPECT_EQ(3, m_db.GetQueued());
+
+  m_db.UpdateSearchIndex();
+  EXPECT_EQ("red", m_db.GetWords("artist", 1));
+  EXPECT_EQ("", m_db.GetWords("album", 2));
+  EXPECT_EQ("green", m_db.GetWords("song", 3));
+}
+
+TEST_F(TestMusicDatabase, DropsWordsOfDeletedItems)
+{
+  ASSERT_TRUE(m_created);
+  m_db.Exec("INSERT INTO artist (idArtist, strArtist) VALUES (1, 'Blue')");
+  m_db.UpdateSearchIndex();
+  m_db.Exec("DELETE FROM artist WHERE idArtist = 1");
+  EXPECT_EQ("", m_db.GetWords("artist", 1));
+}
+
+TEST_F(TestMusicDatabase, SearchUsesIndex)
+{
+  ASSERT_TRUE(m_created);
+  m_db.Exec("INSERT INTO artist (idArtist, strArtist) VALUES (1, 'The Blue Notes')");
+  m_db.Exec("INSERT INTO artist (idArtist, strArtist) VALUES (2, 'Bluegrass Band')");
+  m_db.Exec("INSERT INTO artist (idArtist, strArtist) VALUES (3, 'Notes in Blue')");
+  m_db.UpdateSearchIndex();
+
+  // words starting with a single word
+  CFileItemList items;
+  m_db.Search("blue", items);
+  EXPECT_EQ(3, items.Size());
+
+  // a phrase starting a word
+  items.Clear();
+  m_db.Search("blue n", items);
+  ASSERT_EQ(1, items.Size());
+  EXPECT_EQ("musicdb://artists/1/", items[0]->GetPath());
+
+  // the phrase only starts words
+  items.Clear();
+  m_db.Search("lue", items);
+  EXPECT_EQ(0, items.Size());
+}
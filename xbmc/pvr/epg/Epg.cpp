@@ -581,7 +581,13 @@ int CPVREpg::Get(CFileItemList &results, const CPVREpgSearchFilter &filter) cons
 
   CSingleLock lock(m_critSection);
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  // only tags starting within the searched period can match, so skip the others. the tags are
+  // keyed by their start time in UTC, allow a day on both ends for the local time conversion
+  const CDateTimeSpan oneDay(1, 0, 0, 0);
+  const CDateTime firstStart = filter.GetStartDateTime().GetAsUTCDateTime() - oneDay;
+  const CDateTime lastStart = filter.GetEndDateTime().GetAsUTCDateTime() + oneDay;
+
+  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.lower_bound(firstStart); it != m_tags.end() && it->first <= lastStart; ++it)
   {
     if (filter.FilterEntry(it->second))
       results.Add(CFileItemPtr(new CFileItem(it->second)));
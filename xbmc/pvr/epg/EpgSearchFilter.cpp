@@ -42,6 +42,7 @@ CPVREpgSearchFilter::CPVREpgSearchFilter()
 void CPVREpgSearchFilter::Reset()
 {
   m_strSearchTerm.clear();
+  m_textSearch.reset();
   m_bIsCaseSensitive         = false;
   m_bSearchInDescription     = false;
   m_iGenreType               = EPG_SEARCH_UNSET;
@@ -102,24 +103,45 @@ bool CPVREpgSearchFilter::MatchStartAndEndTimes(const CPVREpgInfoTagPtr &tag) co
   return (tag->StartAsLocalTime() >= m_startDateTime && tag->EndAsLocalTime() <= m_endDateTime);
 }
 
+void CPVREpgSearchFilter::SetSearchTerm(const std::string &strSearchTerm)
+{
+  m_strSearchTerm = strSearchTerm;
+  UpdateTextSearch();
+}
+
 void CPVREpgSearchFilter::SetSearchPhrase(const std::string &strSearchPhrase)
 {
   // match the exact phrase
   m_strSearchTerm = "\"";
   m_strSearchTerm.append(strSearchPhrase);
   m_strSearchTerm.append("\"");
+  UpdateTextSearch();
+}
+
+void CPVREpgSearchFilter::SetCaseSensitive(bool bIsCaseSensitive)
+{
+  m_bIsCaseSensitive = bIsCaseSensitive;
+  UpdateTextSearch();
+}
+
+void CPVREpgSearchFilter::UpdateTextSearch()
+{
+  // parse the search term once instead of for every tag
+  if (m_strSearchTerm.empty())
+    m_textSearch.reset();
+  else
+    m_textSearch = std::make_shared<CTextSearch>(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
 }
 
 bool CPVREpgSearchFilter::MatchSearchTerm(const CPVREpgInfoTagPtr &tag) const
 {
   bool bReturn(true);
 
-  if (!m_strSearchTerm.empty())
+  if (m_textSearch)
   {
-    CTextSearch search(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
-    bReturn = search.Search(tag->Title()) ||
-              search.Search(tag->PlotOutline()) ||
-              (m_bSearchInDescription && search.Search(tag->Plot()));
+    bReturn = m_textSearch->Search(tag->Title()) ||
+              m_textSearch->Search(tag->PlotOutline()) ||
+              (m_bSearchInDescription && m_textSearch->Search(tag->Plot()));
   }
 
   return bReturn;
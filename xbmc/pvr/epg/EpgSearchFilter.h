@@ -19,11 +19,14 @@
  *
  */
 
+#include <memory>
+
 #include "XBDateTime.h"
 
 #include "pvr/PVRTypes.h"
 
 class CFileItemList;
+class CTextSearch;
 
 namespace PVR
 {
@@ -56,11 +59,11 @@ namespace PVR
     static int RemoveDuplicates(CFileItemList &results);
 
     const std::string &GetSearchTerm() const { return m_strSearchTerm; }
-    void SetSearchTerm(const std::string &strSearchTerm) { m_strSearchTerm = strSearchTerm; }
+    void SetSearchTerm(const std::string &strSearchTerm);
     void SetSearchPhrase(const std::string &strSearchPhrase);
 
     bool IsCaseSensitive() const { return m_bIsCaseSensitive; }
-    void SetCaseSensitive(bool bIsCaseSensitive) { m_bIsCaseSensitive = bIsCaseSensitive; }
+    void SetCaseSensitive(bool bIsCaseSensitive);
 
     bool ShouldSearchInDescription() const { return m_bSearchInDescription; }
     void SetSearchInDescription(bool bSearchInDescription) {m_bSearchInDescription = bSearchInDescription; }
@@ -122,8 +125,10 @@ namespace PVR
     bool MatchFreeToAir(const CPVREpgInfoTagPtr &tag) const;
     bool MatchTimers(const CPVREpgInfoTagPtr &tag) const;
     bool MatchRecordings(const CPVREpgInfoTagPtr &tag) const;
+    void UpdateTextSearch();
 
     std::string   m_strSearchTerm;            /*!< The term to search for */
+    std::shared_ptr<CTextSearch> m_textSearch; /*!< The parsed search term, shared by all tags searched */
     bool          m_bIsCaseSensitive;         /*!< Do a case sensitive search */
     bool          m_bSearchInDescription;     /*!< Search for strSearchTerm in the description too */
     int           m_iGenreType;               /*!< The genre type for an entry */
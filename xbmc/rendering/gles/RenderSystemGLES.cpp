@@ -22,6 +22,7 @@
 #include "system.h"
 
 #include "guilib/GraphicContext.h"
+#include "guilib/GUIRenderBatch.h"
 #include "settings/AdvancedSettings.h"
 #include "RenderSystemGLES.h"
 #include "guilib/MatrixGLES.h"
@@ -213,6 +214,7 @@ bool CRenderSystemGLES::EndRender()
 {
   if (!m_bRenderCreated)
     return false;
+  CGUIRenderBatch::GetInstance().Flush();
 
   return true;
 }
@@ -221,6 +223,7 @@ bool CRenderSystemGLES::ClearBuffers(color_t color)
 {
   if (!m_bRenderCreated)
     return false;
+  CGUIRenderBatch::GetInstance().Flush();
 
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
@@ -271,6 +274,7 @@ void CRenderSystemGLES::PresentRender(bool rendered, bool videoLayer)
 
   if (!m_bRenderCreated)
     return;
+  CGUIRenderBatch::GetInstance().Flush();
 
   PresentRenderImpl(rendered);
 
@@ -312,6 +316,7 @@ void CRenderSystemGLES::CaptureStateBlock()
 {
   if (!m_bRenderCreated)
     return;
+  CGUIRenderBatch::GetInstance().Flush();
 
   glMatrixProject.Push();
   glMatrixModview.Push();
@@ -341,6 +346,7 @@ void CRenderSystemGLES::SetCameraPosition(const CPoint &camera, int screenWidth,
 { 
   if (!m_bRenderCreated)
     return;
+  CGUIRenderBatch::GetInstance().Flush();
   
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
   
@@ -464,6 +470,7 @@ void CRenderSystemGLES::SetViewPort(CRect& viewPort)
 {
   if (!m_bRenderCreated)
     return;
+  CGUIRenderBatch::GetInstance().Flush();
 
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
@@ -499,6 +506,7 @@ void CRenderSystemGLES::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+  CGUIRenderBatch::GetInstance().Flush();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -550,6 +558,8 @@ void CRenderSystemGLES::InitialiseGUIShader()
 
 void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 {
+  // queued quads are drawn with the shader state they were queued with
+  CGUIRenderBatch::GetInstance().Flush();
   m_method = method;
   if (m_pGUIshader[m_method])
   {
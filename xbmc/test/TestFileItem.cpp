@@ -21,6 +21,8 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
@@ -136,3 +138,84 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_CASE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+TEST(TestFileItem, Properties)
+{
+  CFileItem item;
+  EXPECT_FALSE(item.HasProperties());
+  EXPECT_TRUE(item.GetProperty("TestFileItem.Unset").isNull());
+
+  item.SetProperty("TestFileItem.Count", 1);
+  item.SetProperty("TestFileItem.Name", "name");
+  EXPECT_TRUE(item.HasProperty("testfileitem.count"));
+  EXPECT_EQ(1, item.GetProperty("TESTFILEITEM.COUNT").asInteger());
+
+  item.IncrementProperty("testfileitem.Count", 2);
+  EXPECT_EQ(3, item.GetProperty("TestFileItem.Count").asInteger());
+
+  CFileItem copy(item);
+  copy.ClearProperty("TestFileItem.Name");
+  EXPECT_FALSE(copy.HasProperty("TestFileItem.Name"));
+  EXPECT_EQ("name", item.GetProperty("TestFileItem.Name").asString());
+  EXPECT_EQ(3, copy.GetProperty("TestFileItem.Count").asInteger());
+
+  item.ClearProperties();
+  EXPECT_FALSE(item.HasProperties());
+}
+
+TEST(TestFileItem, PropertyKeySpelling)
+{
+  CFileItem first;
+  first.SetProperty("TestFileItem.Spelling", 1);
+
+  // each item keeps the spelling it added the key with
+  CFileItem item;
+  item.SetProperty("TESTFILEITEM.SPELLING", 2);
+  item.SetProperty("testfileitem.spelling", 3);
+  CVariant value;
+  item.Serialize(value);
+  EXPECT_TRUE(value["properties"].isMember("TESTFILEITEM.SPELLING"));
+  EXPECT_FALSE(value["properties"].isMember("TestFileItem.Spelling"));
+  EXPECT_EQ(3, item.GetProperty("TestFileItem.Spelling").asInteger());
+
+  CFileItem copy;
+  copy.AppendProperties(item);
+  value.clear();
+  copy.Serialize(value);
+  EXPECT_TRUE(value["properties"].isMember("TESTFILEITEM.SPELLING"));
+
+  value.clear();
+  first.Serialize(value);
+  EXPECT_TRUE(value["properties"].isMember("TestFileItem.Spelling"));
+}
+
+TEST(TestFileItem, ManyPropertyKeys)
+{
+  // don't leave the keys of this test taking up the interned ones for other tests
+  class ResetKeys
+  {
+  public:
+    ResetKeys() { CGUIListItem::ResetPropertyKeys(); }
+    ~ResetKeys() { CGUIListItem::ResetPropertyKeys(); }
+  } resetKeys;
+
+  // more distinct keys than are interned, the rest are stored with the item
+  CFileItem item;
+  for (int i = 0; i < 5000; i++)
+    item.SetProperty(StringUtils::Format("TestFileItem.Key%d", i), i);
+
+  CFileItem copy;
+  copy.AppendProperties(item);
+  for (int i = 0; i < 5000; i++)
+  {
+    std::string key = StringUtils::Format("testfileitem.key%d", i);
+    EXPECT_EQ(i, item.GetProperty(key).asInteger());
+    EXPECT_TRUE(copy.HasProperty(key));
+  }
+
+  copy.ClearProperty("TESTFILEITEM.KEY4999");
+  EXPECT_FALSE(copy.HasProperty("TestFileItem.Key4999"));
+  copy.SetProperty("TestFileItem.Key4998", "changed");
+  EXPECT_EQ("changed", copy.GetProperty("TestFileItem.Key4998").asString());
+  EXPECT_EQ(4998, item.GetProperty("TestFileItem.Key4998").asInteger());
+}
@@ -0,0 +1,132 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ScanJournal.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <functional>
+
+#ifdef HAVE_INOTIFY
+namespace
+{
+class TestScanJournal : public testing::Test
+{
+protected:
+  TestScanJournal()
+  {
+    // a directory of its own per test, the watch of a removed one goes away asynchronously
+    m_directory = "special://temp/testscanjournal" +
+                  std::string(testing::UnitTest::GetInstance()->current_test_info()->name()) + "/";
+    XFILE::CDirectory::Create(m_directory);
+  }
+
+  ~TestScanJournal() override
+  {
+    XFILE::CFile::Delete(m_directory + "file.mp3");
+    XFILE::CDirectory::Remove(m_directory);
+  }
+
+  // the journal sees changes on its own thread
+  static bool WaitFor(const std::function<bool()> &condition)
+  {
+    XbmcThreads::EndTime timeout(5000);
+    while (!timeout.IsTimePast())
+    {
+      if (condition())
+        return true;
+      XbmcThreads::ThreadSleep(10);
+    }
+    return false;
+  }
+
+  bool WriteFile(const std::string &content)
+  {
+    XFILE::CFile file;
+    if (!file.OpenForWrite(m_directory + "file.mp3", true))
+      return false;
+    file.Write(content.c_str(), content.size());
+    return true;
+  }
+
+  std::string m_directory;
+};
+}
+
+TEST_F(TestScanJournal, UnchangedUntilModified)
+{
+  CScanJournal &journal = CScanJournal::GetInstance();
+  unsigned int token = journal.BeginScan(m_directory);
+  ASSERT_NE(0u, token);
+  EXPECT_FALSE(journal.IsUnchanged(m_directory, "hash"));
+
+  journal.SetScanned(m_directory, token, "hash", { m_directory + "sub/" });
+  std::vector<std::string> subfolders;
+  EXPECT_TRUE(journal.IsUnchanged(m_directory, "hash", &subfolders));
+  ASSERT_EQ(1u, subfolders.size());
+  EXPECT_EQ(m_directory + "sub/", subfolders[0]);
+  EXPECT_FALSE(journal.IsUnchanged(m_directory, "other"));
+
+  ASSERT_TRUE(WriteFile("a"));
+  EXPECT_TRUE(WaitFor([&]() { return !journal.IsUnchanged(m_directory, "hash"); }));
+}
+
+TEST_F(TestScanJournal, ChangeDuringScanIsKept)
+{
+  CScanJournal &journal = CScanJournal::GetInstance();
+  unsigned int token = journal.BeginScan(m_directory);
+  ASSERT_NE(0u, token);
+  journal.SetScanned(m_directory, token, "hash", {});
+  ASSERT_TRUE(journal.IsUnchanged(m_directory, "hash"));
+
+  // the directory changes after it was read, but before the scan stored its hash
+  token = journal.BeginScan(m_directory);
+  ASSERT_TRUE(WriteFile("b"));
+  ASSERT_TRUE(WaitFor([&]() { return !journal.IsUnchanged(m_directory, "hash"); }));
+  journal.SetScanned(m_directory, token, "newhash", {});
+  EXPECT_FALSE(journal.IsUnchanged(m_directory, "newhash"));
+
+  // the next scan catches up
+  token = journal.BeginScan(m_directory);
+  journal.SetScanned(m_directory, token, "newhash", {});
+  EXPECT_TRUE(journal.IsUnchanged(m_directory, "newhash"));
+}
+
+TEST_F(TestScanJournal, RemovedDirectoryIsForgotten)
+{
+  CScanJournal &journal = CScanJournal::GetInstance();
+  unsigned int token = journal.BeginScan(m_directory);
+  ASSERT_NE(0u, token);
+  journal.SetScanned(m_directory, token, "hash", {});
+
+  ASSERT_TRUE(XFILE::CDirectory::Remove(m_directory));
+  EXPECT_TRUE(WaitFor([&]() { return !journal.IsUnchanged(m_directory, "hash"); }));
+}
+#endif
+
+TEST(TestScanJournalRemote, RemoteDirectoryIsNotTracked)
+{
+  EXPECT_EQ(0u, CScanJournal::GetInstance().BeginScan("smb://host/share/music/"));
+}
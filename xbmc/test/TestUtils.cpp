@@ -23,6 +23,7 @@
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
 #include "platform/win32/CharsetConverter.h"
+#include "utils/Archive.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
@@ -202,6 +203,21 @@ XFILE::CFile *CXBMCTestUtils::CreateCorruptedFile(std::string const& strFileName
   return NULL;
 }
 
+XFILE::CFile *CXBMCTestUtils::CreateArchiveFile(std::string const& suffix,
+  std::function<void(CArchive&)> const& store)
+{
+  XFILE::CFile *tmpfile = CreateTempFile(suffix);
+  if (!tmpfile)
+    return NULL;
+
+  {
+    CArchive ar(tmpfile, CArchive::store);
+    store(ar);
+    ar.Close();
+  }
+  tmpfile->Close();
+  return tmpfile;
+}
 
 std::vector<std::string> &CXBMCTestUtils::getTestFileFactoryReadUrls()
 {
@@ -19,9 +19,12 @@
  */
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
+class CArchive;
+
 namespace XFILE
 {
   class CFile;
@@ -85,6 +88,15 @@ public:
   XFILE::CFile *CreateCorruptedFile(std::string const& strFileName,
                                     std::string const& suffix);
 
+  /* Function used in creating a file stored through a CArchive, e.g. to
+   * test loading hand-written cache files. The 'store' callback writes the
+   * contents. This will return a XFILE::CFile object which is itself a
+   * tempfile object which can be used with the tempfile functions of this
+   * utility class.
+   */
+  XFILE::CFile *CreateArchiveFile(std::string const& suffix,
+                                  std::function<void(CArchive&)> const& store);
+
   /* Function to parse command line options */
   void ParseArgs(int argc, char **argv);
 
@@ -111,3 +123,5 @@ private:
 #define XBMC_TEMPFILEPATH(a) CXBMCTestUtils::Instance().TempFilePath(a)
 #define XBMC_CREATECORRUPTEDFILE(a, b) \
   CXBMCTestUtils::Instance().CreateCorruptedFile(a, b)
+#define XBMC_CREATEARCHIVEFILE(a, b) \
+  CXBMCTestUtils::Instance().CreateArchiveFile(a, b)
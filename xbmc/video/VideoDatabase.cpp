@@ -143,6 +143,10 @@ void CVideoDatabase::CreateTables()
   columns += ", userrating integer, duration INTEGER)";
   m_pDS->exec(columns);
 
+  CLog::Log(LOGINFO, "create tvshowcounts table");
+  m_pDS->exec("CREATE TABLE tvshowcounts (idShow integer primary key, lastPlayed text, totalCount integer, "
+              "watchedcount integer, totalSeasons integer, dateAdded text)");
+
   CLog::Log(LOGINFO, "create episode table");
   columns = "CREATE TABLE episode ( idEpisode integer primary key, idFile integer";
   for (int i = 0; i < VIDEODB_MAX_COLUMNS; i++)
@@ -305,6 +309,7 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM tag_link WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM rating WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM uniqueid WHERE media_id=old.idShow AND media_type='tvshow'; "
+              "DELETE FROM tvshowcounts WHERE idShow=old.idShow; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
@@ -320,7 +325,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM writer_link WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM art WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM rating WHERE media_id=old.idEpisode AND media_type='episode'; "
-              "DELETE FROM uniqueid WHERE media_id=old.idEpisode AND media_type='episode'; "
+              "DELETE FROM uniqueid WHERE media_id=old.idEpisode AND media_type='episode'; " +
+              GetTvShowCountsUpdate("idShow=old.idShow") +
               "END");
   m_pDS->exec("CREATE TRIGGER delete_season AFTER DELETE ON seasons FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.idSeason AND media_type='season'; "
@@ -341,9 +347,35 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
               "END");
 
+  // keep the tvshow counts up to date with the episodes and their playcounts
+  m_pDS->exec("CREATE TRIGGER insert_tvshow AFTER INSERT ON tvshow FOR EACH ROW BEGIN "
+              "INSERT INTO tvshowcounts (idShow, watchedcount) VALUES (new.idShow, 0); "
+              "END");
+  m_pDS->exec("CREATE TRIGGER insert_episode AFTER INSERT ON episode FOR EACH ROW BEGIN " +
+              GetTvShowCountsUpdate("idShow=new.idShow") +
+              "END");
+  m_pDS->exec("CREATE TRIGGER update_episode AFTER UPDATE ON episode FOR EACH ROW BEGIN " +
+              GetTvShowCountsUpdate("idShow IN (old.idShow, new.idShow)") +
+              "END");
+  m_pDS->exec("CREATE TRIGGER update_file AFTER UPDATE ON files FOR EACH ROW BEGIN " +
+              GetTvShowCountsUpdate("idShow IN (SELECT idShow FROM episode WHERE idFile=new.idFile)") +
+              "END");
+
   CreateViews();
 }
 
+std::string CVideoDatabase::GetTvShowCountsUpdate(const std::string &where) const
+{
+  return StringUtils::Format("UPDATE tvshowcounts SET "
+                             "lastPlayed=(SELECT MAX(files.lastPlayed) FROM episode JOIN files ON files.idFile=episode.idFile WHERE episode.idShow=tvshowcounts.idShow), "
+                             "totalCount=(SELECT NULLIF(COUNT(episode.c%02d), 0) FROM episode WHERE episode.idShow=tvshowcounts.idShow), "
+                             "watchedcount=(SELECT COUNT(files.playCount) FROM episode JOIN files ON files.idFile=episode.idFile WHERE episode.idShow=tvshowcounts.idShow), "
+                             "totalSeasons=(SELECT NULLIF(COUNT(DISTINCT(episode.c%02d)), 0) FROM episode WHERE episode.idShow=tvshowcounts.idShow), "
+                             "dateAdded=(SELECT MAX(files.dateAdded) FROM episode JOIN files ON files.idFile=episode.idFile WHERE episode.idShow=tvshowcounts.idShow) "
+                             "WHERE %s; ",
+                             VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_EPISODE_SEASON, where.c_str());
+}
+
 void CVideoDatabase::CreateViews()
 {
   CLog::Log(LOGINFO, "create episode_view");
@@ -388,22 +420,6 @@ void CVideoDatabase::CreateViews()
                                       VIDEODB_ID_EPISODE_IDENT_ID);
   m_pDS->exec(episodeview);
 
-  CLog::Log(LOGINFO, "create tvshowcounts");
-  std::string tvshowcounts = PrepareSQL("CREATE VIEW tvshowcounts AS SELECT "
-                                       "      tvshow.idShow AS idShow,"
-                                       "      MAX(files.lastPlayed) AS lastPlayed,"
-                                       "      NULLIF(COUNT(episode.c12), 0) AS totalCount,"
-                                       "      COUNT(files.playCount) AS watchedcount,"
-                                       "      NULLIF(COUNT(DISTINCT(episode.c12)), 0) AS totalSeasons, "
-                                       "      MAX(files.dateAdded) as dateAdded "
-                                       "    FROM tvshow"
-                                       "      LEFT JOIN episode ON"
-                                       "        episode.idShow=tvshow.idShow"
-                                       "      LEFT JOIN files ON"
-                                       "        files.idFile=episode.idFile "
-                                       "    GROUP BY tvshow.idShow");
-  m_pDS->exec(tvshowcounts);
-
   CLog::Log(LOGINFO, "create tvshow_view");
   std::string tvshowview = PrepareSQL("CREATE VIEW tvshow_view AS SELECT "
                                      "  tvshow.*,"
@@ -421,7 +437,7 @@ void CVideoDatabase::CreateViews()
                                      "    tvshowlinkpath.idShow=tvshow.idShow"
                                      "  LEFT JOIN path ON"
                                      "    path.idPath=tvshowlinkpath.idPath"
-                                     "  INNER JOIN tvshowcounts ON"
+                                     "  LEFT JOIN tvshowcounts ON"
                                      "    tvshow.idShow = tvshowcounts.idShow "
                                      "  LEFT JOIN rating ON"
                                      "    rating.rating_id=tvshow.c%02d "
@@ -1406,6 +1422,10 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
+    int id = GetCachedLookupId(table, value);
+    if (id > -1)
+      return id;
+
     std::string strSQL = PrepareSQL("select %s from %s where %s like '%s'", firstField.c_str(), table.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
     m_pDS->query(strSQL);
     if (m_pDS->num_rows() == 0)
@@ -1414,15 +1434,15 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
       // doesnt exists, add it
       strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, '%s')", table.c_str(), firstField.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
       m_pDS->exec(strSQL);
-      int id = (int)m_pDS->lastinsertid();
-      return id;
+      id = (int)m_pDS->lastinsertid();
     }
     else
     {
-      int id = m_pDS->fv(firstField.c_str()).get_asInt();
+      id = m_pDS->fv(firstField.c_str()).get_asInt();
       m_pDS->close();
-      return id;
     }
+    SetCachedLookupId(table, value, id);
+    return id;
   }
   catch (...)
   {
@@ -1609,26 +1629,33 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
     std::string trimmedName = name.c_str();
     StringUtils::Trim(trimmedName);
 
-    std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
-    if (m_pDS->num_rows() == 0)
-    {
-      m_pDS->close();
-      // doesnt exists, add it
-      strSQL=PrepareSQL("insert into actor (actor_id, name, art_urls) values(NULL, '%s', '%s')", trimmedName.substr(0,255).c_str(), thumbURLs.c_str());
-      m_pDS->exec(strSQL);
-      idActor = (int)m_pDS->lastinsertid();
-    }
-    else
+    bool added = false;
+    idActor = GetCachedLookupId("actor", trimmedName);
+    if (idActor < 0)
     {
-      idActor = m_pDS->fv(0).get_asInt();
-      m_pDS->close();
-      // update the thumb url's
-      if (!thumbURLs.empty())
+      std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
+      m_pDS->query(strSQL);
+      if (m_pDS->num_rows() == 0)
       {
-        strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
+        m_pDS->close();
+        // doesnt exists, add it
+        strSQL=PrepareSQL("insert into actor (actor_id, name, art_urls) values(NULL, '%s', '%s')", trimmedName.substr(0,255).c_str(), thumbURLs.c_str());
         m_pDS->exec(strSQL);
+        idActor = (int)m_pDS->lastinsertid();
+        added = true;
       }
+      else
+      {
+        idActor = m_pDS->fv(0).get_asInt();
+        m_pDS->close();
+      }
+      SetCachedLookupId("actor", trimmedName, idActor);
+    }
+    // update the thumb url's
+    if (!added && !thumbURLs.empty())
+    {
+      std::string strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
+      m_pDS->exec(strSQL);
     }
     // add artwork
     if (!thumb.empty())
@@ -1667,6 +1694,36 @@ void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, c
   }
 }
 
+void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, const std::vector<int>& valueIds, const char *foreignKey)
+{
+  if (valueIds.empty())
+    return;
+
+  const char *key = foreignKey ? foreignKey : table.c_str();
+
+  // fetch the links we have in one go, and add the missing ones in a single statement
+  std::set<int> linked;
+  m_pDS2->query(PrepareSQL("SELECT %s_id FROM %s_link WHERE media_id=%i AND media_type='%s'", key, table.c_str(), mediaId, mediaType.c_str()));
+  while (!m_pDS2->eof())
+  {
+    linked.insert(m_pDS2->fv(0).get_asInt());
+    m_pDS2->next();
+  }
+  m_pDS2->close();
+
+  std::string values;
+  for (int valueId : valueIds)
+  {
+    if (linked.insert(valueId).second)
+      values += PrepareSQL("(%i,%i,'%s'),", valueId, mediaId, mediaType.c_str());
+  }
+  if (values.empty())
+    return;
+
+  values.pop_back();
+  ExecuteQuery(PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES ", table.c_str(), key) + values);
+}
+
 void CVideoDatabase::RemoveFromLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey)
 {
   const char *key = foreignKey ? foreignKey : table.c_str();
@@ -1677,15 +1734,17 @@ void CVideoDatabase::RemoveFromLinkTable(int mediaId, const std::string& mediaTy
 
 void CVideoDatabase::AddLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  std::vector<int> idValues;
   for (const auto &i : values)
   {
     if (!i.empty())
     {
       int idValue = AddToTable(field, field + "_id", "name", i);
       if (idValue > -1)
-        AddToLinkTable(mediaId, mediaType, field, idValue);
+        idValues.push_back(idValue);
     }
   }
+  AddToLinkTable(mediaId, mediaType, field, idValues);
 }
 
 void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
@@ -1698,15 +1757,17 @@ void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType
 
 void CVideoDatabase::AddActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  std::vector<int> idValues;
   for (const auto &i : values)
   {
     if (!i.empty())
     {
       int idValue = AddActor(i, "");
       if (idValue > -1)
-        AddToLinkTable(mediaId, mediaType, field, idValue, "actor");
+        idValues.push_back(idValue);
     }
   }
+  AddToLinkTable(mediaId, mediaType, field, idValues, "actor");
 }
 
 void CVideoDatabase::UpdateActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
@@ -1748,12 +1809,30 @@ void CVideoDatabase::AddCast(int mediaId, const char *mediaType, const std::vect
   if (cast.empty())
     return;
 
+  // fetch the cast we have in one go, and add the missing actors in a single statement
+  std::set<int> linked;
+  m_pDS2->query(PrepareSQL("SELECT actor_id FROM actor_link WHERE media_id=%i AND media_type='%s'", mediaId, mediaType));
+  while (!m_pDS2->eof())
+  {
+    linked.insert(m_pDS2->fv(0).get_asInt());
+    m_pDS2->next();
+  }
+  m_pDS2->close();
+
+  std::string values;
   int order = std::max_element(cast.begin(), cast.end())->order;
   for (const auto &i : cast)
   {
     int idActor = AddActor(i.strName, i.thumbUrl.m_xml, i.thumb);
-    AddLinkToActor(mediaId, mediaType, idActor, i.strRole, i.order >= 0 ? i.order : ++order);
+    int castOrder = i.order >= 0 ? i.order : ++order;
+    if (idActor > -1 && linked.insert(idActor).second)
+      values += PrepareSQL("(%i,%i,'%s','%s',%i),", idActor, mediaId, mediaType, i.strRole.c_str(), castOrder);
   }
+  if (values.empty())
+    return;
+
+  values.pop_back();
+  ExecuteQuery("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES " + values);
 }
 
 //********************************************************************************************************************************
@@ -4325,8 +4404,51 @@ void CVideoDatabase::SetVideoSettings(const std::string& strFilenameAndPath, con
 
 void CVideoDatabase::SetArtForItem(int mediaId, const MediaType &mediaType, const std::map<std::string, std::string> &art)
 {
-  for (const auto &i : art)
-    SetArtForItem(mediaId, mediaType, i.first, i.second);
+  if (art.size() < 2)
+  {
+    for (const auto &i : art)
+      SetArtForItem(mediaId, mediaType, i.first, i.second);
+    return;
+  }
+
+  try
+  {
+    if (NULL == m_pDB.get()) return;
+    if (NULL == m_pDS.get()) return;
+
+    // fetch the art we have in one go, and add the new types in a single statement
+    std::map<std::string, std::pair<int, std::string> > current;
+    m_pDS->query(PrepareSQL("SELECT art_id,type,url FROM art WHERE media_id=%i AND media_type='%s'", mediaId, mediaType.c_str()));
+    while (!m_pDS->eof())
+    {
+      current.insert(std::make_pair(m_pDS->fv(1).get_asString(), std::make_pair(m_pDS->fv(0).get_asInt(), m_pDS->fv(2).get_asString())));
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    std::string values;
+    for (const auto &i : art)
+    {
+      // don't set <foo>.<bar> art types - these are derivative types from parent items
+      if (i.first.find('.') != std::string::npos)
+        continue;
+
+      auto it = current.find(i.first);
+      if (it == current.end())
+        values += PrepareSQL("(%d, '%s', '%s', '%s'),", mediaId, mediaType.c_str(), i.first.c_str(), i.second.c_str());
+      else if (it->second.second != i.second)
+        m_pDS->exec(PrepareSQL("UPDATE art SET url='%s' where art_id=%d", i.second.c_str(), it->second.first));
+    }
+    if (!values.empty())
+    {
+      values.pop_back();
+      m_pDS->exec("INSERT INTO art(media_id, media_type, type, url) VALUES " + values);
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%d, '%s') failed", __FUNCTION__, mediaId, mediaType.c_str());
+  }
 }
 
 void CVideoDatabase::SetArtForItem(int mediaId, const MediaType &mediaType, const std::string &artType, const std::string &url)
@@ -5214,11 +5336,25 @@ void CVideoDatabase::UpdateTables(int iVersion)
       pDS->close();
     }
   }
+
+  if (iVersion < 109)
+  {
+    // tvshowcounts was a view aggregating all episodes and is now kept up to date by triggers
+    m_pDS->exec("CREATE TABLE tvshowcounts (idShow integer primary key, lastPlayed text, totalCount integer, "
+                "watchedcount integer, totalSeasons integer, dateAdded text)");
+    m_pDS->exec(PrepareSQL("INSERT INTO tvshowcounts (idShow, lastPlayed, totalCount, watchedcount, totalSeasons, dateAdded) "
+                           "SELECT tvshow.idShow, MAX(files.lastPlayed), NULLIF(COUNT(episode.c%02d), 0), COUNT(files.playCount), "
+                           "NULLIF(COUNT(DISTINCT(episode.c%02d)), 0), MAX(files.dateAdded) "
+                           "FROM tvshow "
+                           "LEFT JOIN episode ON episode.idShow=tvshow.idShow "
+                           "LEFT JOIN files ON files.idFile=episode.idFile "
+                           "GROUP BY tvshow.idShow", VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_EPISODE_SEASON));
+  }
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 108;
+  return 109;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -9559,16 +9695,72 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
   }
 }
 
-bool CVideoDatabase::CommitTransaction()
+bool CVideoDatabase::CommitBatchTransaction()
 {
-  if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so recalculate
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
-    return true;
+  bool result = CDatabase::CommitBatchTransaction();
+  m_lookupCache.clear();
+  return result;
+}
+
+void CVideoDatabase::OnTransactionCommitted()
+{
+  // number of items in the db has likely changed, so recalculate
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+}
+
+void CVideoDatabase::RollbackTransaction()
+{
+  CDatabase::RollbackTransaction();
+
+  // the cache may hold ids that were just rolled back
+  m_lookupCache.clear();
+}
+
+int CVideoDatabase::GetCachedLookupId(const std::string &table, const std::string &name)
+{
+  if (!InBatchTransaction())
+    return -1;
+
+  // tags are removed by a trigger once they're no longer linked, so can't be cached
+  if (table != "genre" && table != "studio" && table != "country" && table != "actor")
+    return -1;
+
+  auto cache = m_lookupCache.find(table);
+  if (cache == m_lookupCache.end())
+  {
+    cache = m_lookupCache.insert(std::make_pair(table, std::unordered_map<std::string, int>())).first;
+    // actors are too many to load up front
+    if (table != "actor")
+    {
+      m_pDS2->query(PrepareSQL("SELECT %s_id, name FROM %s", table.c_str(), table.c_str()));
+      while (!m_pDS2->eof())
+      {
+        std::string key = m_pDS2->fv(1).get_asString();
+        StringUtils::ToLower(key);
+        cache->second.insert(std::make_pair(key, m_pDS2->fv(0).get_asInt()));
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+  }
+
+  std::string key = name.substr(0, 255);
+  StringUtils::ToLower(key);
+  auto it = cache->second.find(key);
+  return it != cache->second.end() ? it->second : -1;
+}
+
+void CVideoDatabase::SetCachedLookupId(const std::string &table, const std::string &name, int id)
+{
+  auto cache = m_lookupCache.find(table);
+  if (id > -1 && cache != m_lookupCache.end())
+  {
+    std::string key = name.substr(0, 255);
+    StringUtils::ToLower(key);
+    cache->second[key] = id;
   }
-  return false;
 }
 
 bool CVideoDatabase::SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbField, const std::string &strValue)
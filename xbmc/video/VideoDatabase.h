@@ -19,8 +19,10 @@
  *
  */
 
+#include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -429,7 +431,8 @@ public:
   ~CVideoDatabase(void) override;
 
   bool Open() override;
-  bool CommitTransaction() override;
+  void RollbackTransaction() override;
+  bool CommitBatchTransaction() override;
 
   int AddMovie(const std::string& strFilenameAndPath);
   int AddEpisode(int idShow, const std::string& strFilenameAndPath);
@@ -898,6 +901,7 @@ protected:
   // link functions - these two do all the work
   void AddLinkToActor(int mediaId, const char *mediaType, int actorId, const std::string &role, int order);
   void AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey = NULL);
+  void AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, const std::vector<int>& valueIds, const char *foreignKey = NULL);
   void RemoveFromLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey = NULL);
 
   void AddLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values);
@@ -934,6 +938,13 @@ private:
   void CreateLinkIndex(const char *table);
   void CreateForeignLinkIndex(const char *table, const char *foreignkey);
 
+  /*! \brief Get the SQL that recalculates the episode counts, watched counts and
+   last played/added dates of the tvshows matching the given condition.
+   tvshowcounts holds these so that listing tvshows doesn't need to aggregate all episodes.
+   \param where condition on tvshowcounts.idShow selecting the tvshows to update.
+   */
+  std::string GetTvShowCountsUpdate(const std::string &where) const;
+
   /*! \brief (Re)Create the generic database views for movies, tvshows,
      episodes and music videos
    */
@@ -990,4 +1001,19 @@ private:
 
   static void AnnounceRemove(std::string content, int id, bool scanning = false);
   static void AnnounceUpdate(std::string content, int id);
+
+  /*! \brief Look up the id of a name in a lookup table from the in-memory cache.
+   The cache is only used within a batch transaction. Tables are loaded on first use,
+   except for actors which are only cached as they are looked up.
+   \param table the lookup table (genre, studio, country or actor).
+   \param name the name to look up.
+   \return the id of the name, or -1 if it isn't cached.
+   */
+  int GetCachedLookupId(const std::string &table, const std::string &name);
+  void SetCachedLookupId(const std::string &table, const std::string &name, int id);
+
+  /*! \brief Refresh the library state once updates are committed */
+  void OnTransactionCommitted() override;
+
+  std::map<std::string, std::unordered_map<std::string, int> > m_lookupCache;
 };
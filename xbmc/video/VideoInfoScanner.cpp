@@ -41,6 +41,7 @@
 #include "messaging/ApplicationMessenger.h"
 #include "messaging/helpers/DialogHelper.h"
 #include "NfoFile.h"
+#include "ScanJournal.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
@@ -114,6 +115,8 @@ namespace VIDEO
       unsigned int tick = XbmcThreads::SystemClockMillis();
 
       m_database.Open();
+      // group the per item transactions, it saves a round trip and a sync per item
+      m_database.BeginBatchTransaction();
 
       m_bCanInterrupt = true;
 
@@ -129,6 +132,10 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      // enumerate the directories ahead of us while we're busy looking them up
+      m_prefetcher.Start(m_scanAll);
+      m_prefetcher.Queue(std::vector<std::string>(m_pathsToScan.begin(), m_pathsToScan.end()), false);
+
       bool bCancelled = false;
       while (!bCancelled && !m_pathsToScan.empty())
       {
@@ -152,10 +159,15 @@ namespace VIDEO
            */
           CLog::Log(LOGWARNING, "%s directory '%s' does not exist - skipping scan%s.", __FUNCTION__, CURL::GetRedacted(directory).c_str(), m_bClean ? " and clean" : "");
           m_pathsToScan.erase(m_pathsToScan.begin());
+
+          SScanPrefetch unused;
+          m_prefetcher.Take(directory, unused);
         }
         else if (!DoScan(directory))
           bCancelled = true;
       }
+      m_prefetcher.Cancel();
+      m_database.CommitBatchTransaction();
 
       if (!bCancelled)
       {
@@ -178,6 +190,7 @@ namespace VIDEO
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
+      m_prefetcher.Cancel();
     }
     
     m_bRunning = false;
@@ -231,6 +244,7 @@ namespace VIDEO
       m_database.Interrupt();
 
     m_bStop = true;
+    m_prefetcher.Cancel();
   }
 
   static void OnDirectoryScanned(const std::string& strDirectory)
@@ -256,6 +270,12 @@ namespace VIDEO
     if (it != m_pathsToScan.end())
       m_pathsToScan.erase(it);
 
+    // pick up the listing and hash if they were prefetched
+    SScanPrefetch prefetched;
+    bool havePrefetched = m_prefetcher.Take(strDirectory, prefetched) && !prefetched.unchanged;
+    if (m_bStop)
+      return false;
+
     // load subfolder
     CFileItemList items;
     bool foundDirectly = false;
@@ -269,14 +289,26 @@ namespace VIDEO
     const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
                                                          : g_advancedSettings.m_moviesExcludeFromScanRegExps;
 
-    if (IsExcluded(strDirectory, regexps))
+    bool ignoreFolder = !m_scanAll && settings.noupdate;
+
+    // a folder the change journal vouches for needs no filesystem access at all
+    std::string hash, dbHash;
+    std::vector<std::string> subfolders;
+    unsigned int journalToken = 0;
+    bool unchanged = false;
+    bool hashStored = false;
+    if (g_advancedSettings.m_bVideoLibraryUseChangeJournal && !ignoreFolder && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
+    {
+      journalToken = havePrefetched && prefetched.journalToken ? prefetched.journalToken : CScanJournal::GetInstance().BeginScan(strDirectory);
+      unchanged = m_database.GetPathHash(strDirectory, dbHash) && CScanJournal::GetInstance().IsUnchanged(strDirectory, dbHash, &subfolders);
+    }
+
+    if (unchanged ? CUtil::ExcludeFileOrFolder(strDirectory, regexps) : havePrefetched ? prefetched.excluded : IsExcluded(strDirectory, regexps))
       return true;
 
-    bool ignoreFolder = !m_scanAll && settings.noupdate;
     if (content == CONTENT_NONE || ignoreFolder)
       return true;
 
-    std::string hash, dbHash;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
     {
       if (m_handle)
@@ -286,17 +318,31 @@ namespace VIDEO
       }
 
       std::string fastHash;
-      if (g_advancedSettings.m_bVideoLibraryUseFastHash)
-        fastHash = GetFastHash(strDirectory, regexps);
+      if (!unchanged)
+      {
+        if (havePrefetched && prefetched.hashed)
+          fastHash = prefetched.fastHash;
+        else if (g_advancedSettings.m_bVideoLibraryUseFastHash)
+          fastHash = GetFastHash(strDirectory, regexps);
+      }
 
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && fastHash == dbHash)
+      if (unchanged)
+      { // nothing happened in the folder since we last scanned it
+        hash = dbHash;
+      }
+      else if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && fastHash == dbHash)
       { // fast hashes match - no need to process anything
         hash = fastHash;
       }
       else
       { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
-        items.Stack();
+        if (havePrefetched && prefetched.items)
+          items.Assign(*prefetched.items);
+        else
+        {
+          CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
+          items.Stack();
+        }
 
         // check whether to re-use previously computed fast hash
         if (!CanFastHash(items, regexps) || fastHash.empty())
@@ -307,8 +353,9 @@ namespace VIDEO
 
       if (hash == dbHash)
       { // hash matches - skipping
-        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change%s", CURL::GetRedacted(strDirectory).c_str(), !fastHash.empty() ? " (fasthash)" : "");
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change%s", CURL::GetRedacted(strDirectory).c_str(), unchanged ? " (journal)" : !fastHash.empty() ? " (fasthash)" : "");
         bSkip = true;
+        hashStored = true;
       }
       else if (hash.empty())
       { // directory empty or non-existent - add to clean list and skip
@@ -333,7 +380,10 @@ namespace VIDEO
 
       if (foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
+        if (havePrefetched && prefetched.items)
+          items.Assign(*prefetched.items);
+        else
+          CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
         items.SetPath(strDirectory);
         GetPathHash(items, hash);
         bSkip = true;
@@ -352,6 +402,24 @@ namespace VIDEO
       }
     }
 
+    // if we have a directory item (non-playlist) we then recurse into that folder
+    // do not recurse for tv shows - we have already looked recursively for episodes
+    if (settings.recurse <= 0 || content == CONTENT_TVSHOWS)
+      subfolders.clear();
+    else if (!unchanged)
+    {
+      for (int i = 0; i < items.Size(); ++i)
+      {
+        const CFileItemPtr pItem = items[i];
+        if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
+          subfolders.push_back(pItem->GetPath());
+      }
+    }
+
+    // subfolders are scanned next, so start on them while we look up this one
+    if (!subfolders.empty())
+      m_prefetcher.Queue(subfolders, true);
+
     if (!bSkip)
     {
       if (RetrieveVideoInfo(items, settings.parent_name_root, content))
@@ -359,6 +427,7 @@ namespace VIDEO
         if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
         {
           m_database.SetPathHash(strDirectory, hash);
+          hashStored = true;
           if (m_bClean)
             m_pathsToClean.insert(m_database.GetPathId(strDirectory));
           CLog::Log(LOGDEBUG, "VideoInfoScanner: Finished adding information from dir %s", CURL::GetRedacted(strDirectory).c_str());
@@ -374,26 +443,23 @@ namespace VIDEO
     else if (hash != dbHash && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
     { // update the hash either way - we may have changed the hash to a fast version
       m_database.SetPathHash(strDirectory, hash);
+      hashStored = true;
     }
 
+    if (journalToken && hashStored)
+      CScanJournal::GetInstance().SetScanned(strDirectory, journalToken, hash, subfolders);
+
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
-    for (int i = 0; i < items.Size(); ++i)
+    for (const auto &subfolder : subfolders)
     {
-      CFileItemPtr pItem = items[i];
-
       if (m_bStop)
         break;
 
-      // if we have a directory item (non-playlist) we then recurse into that folder
-      // do not recurse for tv shows - we have already looked recursively for episodes
-      if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+      if (!DoScan(subfolder))
       {
-        if (!DoScan(pItem->GetPath()))
-        {
-          m_bStop = true;
-        }
+        m_bStop = true;
       }
     }
     return !m_bStop;
@@ -731,6 +797,8 @@ namespace VIDEO
 
       if (updateSeasonArt)
       {
+        // don't keep the batch transaction open while waiting on the scraper
+        m_database.FlushBatchTransaction();
         CVideoInfoDownloader loader(scraper);
         loader.GetArtwork(showInfo);
         GetSeasonThumbs(showInfo, seasonArt, CVideoThumbLoader::GetArtTypes(MediaTypeSeason), useLocal);
@@ -1521,6 +1589,7 @@ namespace VIDEO
             pDlgProgress->Progress();
           }
 
+          m_database.FlushBatchTransaction();
           CVideoInfoDownloader imdb(scraper);
           if (!imdb.GetEpisodeList(url, episodes))
             return INFO_NOT_FOUND;
@@ -1619,6 +1688,7 @@ namespace VIDEO
 
       if (bFound)
       {
+        m_database.FlushBatchTransaction();
         CVideoInfoDownloader imdb(scraper);
         CFileItem item;
         item.SetPath(file->strPath);
@@ -1761,6 +1831,7 @@ namespace VIDEO
     if (m_handle && !url.strTitle.empty())
       m_handle->SetText(url.strTitle);
 
+    m_database.FlushBatchTransaction();
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(url, movieDetails, pDialog);
 
@@ -1829,7 +1900,7 @@ namespace VIDEO
   }
 
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     XBMC::XBMC_MD5 md5state;
 
@@ -2100,6 +2171,7 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const std::string &videoName, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+    m_database.FlushBatchTransaction();
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(videoName, movielist, progress);
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
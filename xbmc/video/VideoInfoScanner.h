@@ -26,6 +26,7 @@
 #include "InfoScanner.h"
 #include "NfoFile.h"
 #include "VideoDatabase.h"
+#include "VideoScanPrefetcher.h"
 #include "addons/Scraper.h"
 
 class CRegExp;
@@ -126,6 +127,18 @@ namespace VIDEO
 
     bool EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList);
 
+    /*! \brief Retrieve a "fast" hash of the given directory (if available)
+     Performs a stat() on the directory, and uses modified time to create a "fast"
+     hash of the folder. If no modified time is available, the create time is used,
+     and if neither are available, an empty hash is returned.
+     In case exclude from scan expressions are present, the string array will be appended
+     to the md5 hash to ensure we're doing a re-scan whenever the user modifies those.
+     \param directory folder to hash
+     \param excludes string array of exclude expressions
+     \return the md5 hash of the folder"
+     */
+    static std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes);
+
   protected:
     virtual void Process();
     bool DoScan(const std::string& strDirectory) override;
@@ -187,18 +200,6 @@ namespace VIDEO
 
     static int GetPathHash(const CFileItemList &items, std::string &hash);
 
-    /*! \brief Retrieve a "fast" hash of the given directory (if available)
-     Performs a stat() on the directory, and uses modified time to create a "fast"
-     hash of the folder. If no modified time is available, the create time is used,
-     and if neither are available, an empty hash is returned.
-     In case exclude from scan expressions are present, the string array will be appended
-     to the md5 hash to ensure we're doing a re-scan whenever the user modifies those.
-     \param directory folder to hash
-     \param excludes string array of exclude expressions
-     \return the md5 hash of the folder"
-     */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
-
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
      hash of each folder. If no modified time is available, the create time is used,
@@ -254,6 +255,7 @@ namespace VIDEO
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+    CVideoScanPrefetcher m_prefetcher;
   };
 }
 
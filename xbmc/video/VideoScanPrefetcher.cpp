@@ -0,0 +1,284 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "VideoScanPrefetcher.h"
+
+#include <algorithm>
+
+#include "FileItem.h"
+#include "InfoScanner.h"
+#include "ScanJournal.h"
+#include "URL.h"
+#include "VideoDatabase.h"
+#include "VideoInfoScanner.h"
+#include "filesystem/Directory.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+
+using namespace XFILE;
+
+// directories being fetched or waiting for the scanner
+#define PREFETCH_WINDOW       16
+// concurrent requests made to a single source
+#define PREFETCH_PER_SOURCE    2
+// how far into the queue we look for a directory on a source that isn't busy
+#define PREFETCH_LOOKAHEAD    64
+
+namespace VIDEO
+{
+  // idle database connections of the prefetch jobs, which hold on to the pool
+  // since they may still be running after the prefetcher was cancelled
+  class CVideoScanDatabasePool
+  {
+  public:
+    std::unique_ptr<CVideoDatabase> Acquire()
+    {
+      {
+        CSingleLock lock(m_section);
+        if (!m_idle.empty())
+        {
+          std::unique_ptr<CVideoDatabase> db = std::move(m_idle.back());
+          m_idle.pop_back();
+          return db;
+        }
+      }
+
+      std::unique_ptr<CVideoDatabase> db(new CVideoDatabase);
+      if (!db->Open())
+        return nullptr;
+      return db;
+    }
+
+    void Release(std::unique_ptr<CVideoDatabase> db)
+    {
+      CSingleLock lock(m_section);
+      m_idle.push_back(std::move(db));
+    }
+
+  private:
+    std::vector<std::unique_ptr<CVideoDatabase>> m_idle;
+    CCriticalSection m_section;
+  };
+
+  CVideoScanPrefetchJob::CVideoScanPrefetchJob(const std::string &directory, bool scanAll, std::shared_ptr<CVideoScanDatabasePool> databases)
+    : m_directory(directory), m_scanAll(scanAll), m_databases(std::move(databases))
+  {
+  }
+
+  bool CVideoScanPrefetchJob::DoWork()
+  {
+    std::unique_ptr<CVideoDatabase> db = m_databases->Acquire();
+    if (!db)
+      return false;
+
+    bool success = Prefetch(*db);
+    m_databases->Release(std::move(db));
+    return success;
+  }
+
+  /*! \brief Mirrors the directory checks of CVideoInfoScanner::DoScan() up to the point
+   where the scraper would be invoked, doing only the filesystem access.
+   */
+  bool CVideoScanPrefetchJob::Prefetch(CVideoDatabase &db)
+  {
+    SScanSettings settings;
+    bool foundDirectly = false;
+    ADDON::ScraperPtr info = db.GetScraperForPath(m_directory, settings, foundDirectly);
+    CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+
+    if (content == CONTENT_NONE || (!m_scanAll && settings.noupdate))
+      return true;
+
+    std::string dbHash;
+    bool haveDbHash = db.GetPathHash(m_directory, dbHash);
+    if (g_advancedSettings.m_bVideoLibraryUseChangeJournal && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
+    {
+      m_result.journalToken = CScanJournal::GetInstance().BeginScan(m_directory);
+      m_result.unchanged = haveDbHash && CScanJournal::GetInstance().IsUnchanged(m_directory, dbHash);
+      if (m_result.unchanged)
+        return true;
+    }
+
+    const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
+                                                                         : g_advancedSettings.m_moviesExcludeFromScanRegExps;
+    m_result.excluded = CInfoScanner::IsExcluded(m_directory, regexps);
+    if (m_result.excluded)
+      return true;
+
+    if (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS)
+    {
+      if (g_advancedSettings.m_bVideoLibraryUseFastHash)
+      {
+        m_result.fastHash = CVideoInfoScanner::GetFastHash(m_directory, regexps);
+        m_result.hashed = true;
+      }
+
+      if (haveDbHash && !m_result.fastHash.empty() && m_result.fastHash == dbHash)
+        return true;
+
+      m_result.items.reset(new CFileItemList);
+      CDirectory::GetDirectory(m_directory, *m_result.items, g_advancedSettings.m_videoExtensions);
+      m_result.items->Stack();
+    }
+    else if (content == CONTENT_TVSHOWS && foundDirectly && !settings.parent_name_root)
+    {
+      m_result.items.reset(new CFileItemList);
+      CDirectory::GetDirectory(m_directory, *m_result.items, g_advancedSettings.m_videoExtensions);
+    }
+    return true;
+  }
+
+  CVideoScanPrefetcher::~CVideoScanPrefetcher()
+  {
+    Cancel();
+  }
+
+  void CVideoScanPrefetcher::Start(bool scanAll)
+  {
+    Cancel();
+
+    CSingleLock lock(m_section);
+    m_scanAll = scanAll;
+    m_seen.clear();
+  }
+
+  void CVideoScanPrefetcher::Queue(const std::vector<std::string> &directories, bool next)
+  {
+    CSingleLock lock(m_section);
+    std::vector<std::string> added;
+    for (const auto &directory : directories)
+    {
+      if (m_seen.insert(directory).second)
+        added.push_back(directory);
+    }
+    if (next)
+      m_queued.insert(m_queued.begin(), added.begin(), added.end());
+    else
+      m_queued.insert(m_queued.end(), added.begin(), added.end());
+
+    LaunchJobs();
+  }
+
+  bool CVideoScanPrefetcher::Take(const std::string &directory, SScanPrefetch &result)
+  {
+    CSingleLock lock(m_section);
+
+    // not started yet - the scanner is better off fetching it directly
+    auto queued = std::find(m_queued.begin(), m_queued.end(), directory);
+    if (queued != m_queued.end())
+    {
+      m_queued.erase(queued);
+      return false;
+    }
+
+    while (true)
+    {
+      auto ready = m_ready.find(directory);
+      if (ready != m_ready.end())
+      {
+        result = std::move(ready->second);
+        m_ready.erase(ready);
+        LaunchJobs();
+        return true;
+      }
+
+      auto running = std::find_if(m_inFlight.begin(), m_inFlight.end(), [&directory](const std::pair<const unsigned int, InFlight> &job) {
+        return job.second.directory == directory;
+      });
+      if (running == m_inFlight.end())
+        return false;
+
+      CSingleExit exit(m_section);
+      m_completed.Wait();
+    }
+  }
+
+  void CVideoScanPrefetcher::Cancel()
+  {
+    CSingleLock lock(m_section);
+    for (const auto &job : m_inFlight)
+      CJobManager::GetInstance().CancelJob(job.first);
+    m_inFlight.clear();
+    m_sourceJobs.clear();
+    m_queued.clear();
+    m_ready.clear();
+    m_databases.reset();
+    m_completed.Set();
+  }
+
+  void CVideoScanPrefetcher::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    CSingleLock lock(m_section);
+    auto it = m_inFlight.find(jobID);
+    if (it == m_inFlight.end())
+      return; // cancelled
+
+    if (--m_sourceJobs[it->second.source] == 0)
+      m_sourceJobs.erase(it->second.source);
+
+    // failures are left for the scanner to retry (and report) directly
+    if (success)
+      m_ready[it->second.directory] = std::move(static_cast<CVideoScanPrefetchJob*>(job)->GetResult());
+    m_inFlight.erase(it);
+
+    LaunchJobs();
+    m_completed.Set();
+  }
+
+  void CVideoScanPrefetcher::LaunchJobs()
+  {
+    auto it = m_queued.begin();
+    for (unsigned int looked = 0; it != m_queued.end() && looked < PREFETCH_LOOKAHEAD; ++looked)
+    {
+      if (m_inFlight.size() + m_ready.size() >= PREFETCH_WINDOW)
+        break;
+
+      std::string source = GetSource(*it);
+      unsigned int &sourceJobs = m_sourceJobs[source];
+      if (sourceJobs >= PREFETCH_PER_SOURCE)
+      {
+        ++it;
+        continue;
+      }
+
+      unsigned int jobID = CJobManager::GetInstance().AddJob(CreateJob(*it), this, CJob::PRIORITY_NORMAL);
+      if (!jobID)
+        break;
+
+      sourceJobs++;
+      m_inFlight[jobID] = { *it, source };
+      it = m_queued.erase(it);
+    }
+  }
+
+  CVideoScanPrefetchJob *CVideoScanPrefetcher::CreateJob(const std::string &directory)
+  {
+    if (!m_databases)
+      m_databases = std::make_shared<CVideoScanDatabasePool>();
+    return new CVideoScanPrefetchJob(directory, m_scanAll, m_databases);
+  }
+
+  std::string CVideoScanPrefetcher::GetSource(const std::string &directory)
+  {
+    CURL url(directory);
+    return url.GetProtocol() + "://" + url.GetHostName();
+  }
+}
@@ -0,0 +1,145 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
+
+class CFileItemList;
+class CVideoDatabase;
+
+namespace VIDEO
+{
+  /*! \brief Directory state gathered by the prefetcher ahead of the scanner.
+   */
+  struct SScanPrefetch
+  {
+    bool unchanged = false;                ///< the change journal vouches for the directory, nothing was fetched
+    unsigned int journalToken = 0;         ///< change journal token taken before the directory was read
+    bool excluded = false;                 ///< directory matches an exclude expression or holds a .nomedia file
+    bool hashed = false;                   ///< whether fastHash was computed
+    std::string fastHash;                  ///< fast hash of the directory (may be empty if unavailable)
+    std::shared_ptr<CFileItemList> items;  ///< the directory listing, or empty if it wasn't needed
+  };
+
+  class CVideoScanDatabasePool;
+
+  /*! \brief Fetches the state of a single directory for the prefetcher.
+   */
+  class CVideoScanPrefetchJob : public CJob
+  {
+  public:
+    CVideoScanPrefetchJob(const std::string &directory, bool scanAll, std::shared_ptr<CVideoScanDatabasePool> databases);
+
+    const char *GetType() const override { return "videoscanprefetch"; }
+    bool DoWork() override;
+
+    SScanPrefetch &GetResult() { return m_result; }
+
+  protected:
+    std::string m_directory;
+    SScanPrefetch m_result;
+
+  private:
+    bool Prefetch(CVideoDatabase &db);
+
+    bool m_scanAll;
+    std::shared_ptr<CVideoScanDatabasePool> m_databases;
+  };
+
+  /*! \brief Enumerates and hashes directories ahead of the video scanner.
+
+   Checking an unchanged directory costs the scanner a few round trips to the
+   source, which on network shares dominates the time of a library update.
+   The prefetcher keeps a bounded window of upcoming directories being stat'ed
+   and listed on job workers, so the scanner thread only has to wait for the
+   lookups and database work. Requests are limited per source (protocol and
+   host) so that a slow share doesn't starve the others of workers. The jobs
+   share a pool of database connections, so each worker opens one connection
+   for the scan rather than one per directory.
+   */
+  class CVideoScanPrefetcher : public IJobCallback
+  {
+  public:
+    CVideoScanPrefetcher() = default;
+    ~CVideoScanPrefetcher() override;
+
+    /*! \brief Prepare for a new scan, dropping anything left from a previous one.
+     \param scanAll whether paths marked as noupdate are scanned as well.
+     */
+    void Start(bool scanAll);
+
+    /*! \brief Queue directories to be prefetched. Directories that were queued before are ignored.
+     \param directories the directories in the order the scanner will visit them.
+     \param next true to prefetch these ahead of everything queued so far, false to append them.
+     */
+    void Queue(const std::vector<std::string> &directories, bool next);
+
+    /*! \brief Retrieve the prefetched state of a directory, waiting for it if it is being fetched.
+     \param directory the directory to retrieve.
+     \param result [out] the prefetched state.
+     \return true if the directory was prefetched, false if it was never queued, failed or was cancelled.
+     */
+    bool Take(const std::string &directory, SScanPrefetch &result);
+
+    /*! \brief Cancel all outstanding work. Any Take() in progress returns false.
+     */
+    void Cancel();
+
+    void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
+
+  protected:
+    /*! \brief Create the job prefetching a directory.
+     */
+    virtual CVideoScanPrefetchJob *CreateJob(const std::string &directory);
+
+  private:
+    CVideoScanPrefetcher(const CVideoScanPrefetcher&) = delete;
+    CVideoScanPrefetcher& operator=(const CVideoScanPrefetcher&) = delete;
+
+    void LaunchJobs();
+    static std::string GetSource(const std::string &directory);
+
+    struct InFlight
+    {
+      std::string directory;
+      std::string source;
+    };
+
+    bool m_scanAll = false;
+    std::shared_ptr<CVideoScanDatabasePool> m_databases; ///< released on Cancel(), jobs still running keep it
+    std::deque<std::string> m_queued;
+    std::set<std::string> m_seen;
+    std::map<unsigned int, InFlight> m_inFlight;
+    std::map<std::string, unsigned int> m_sourceJobs;
+    std::map<std::string, SScanPrefetch> m_ready;
+    CEvent m_completed;
+    CCriticalSection m_section;
+  };
+}
@@ -0,0 +1,195 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "URL.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "video/VideoScanPrefetcher.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <thread>
+
+using namespace VIDEO;
+
+namespace
+{
+// shared with the jobs, which may outlive a test after cancelling
+struct SJobState
+{
+  CCriticalSection section;
+  CEvent release{true};
+  std::map<std::string, unsigned int> running; ///< per source
+  std::map<std::string, unsigned int> maxRunning;
+  unsigned int started = 0;
+  unsigned int finished = 0;
+};
+
+class CBlockingPrefetchJob : public CVideoScanPrefetchJob
+{
+public:
+  CBlockingPrefetchJob(const std::string &directory, std::shared_ptr<SJobState> state)
+    : CVideoScanPrefetchJob(directory, false, nullptr), m_state(std::move(state)) {}
+
+  bool DoWork() override
+  {
+    std::string source = CURL(m_directory).GetHostName();
+    {
+      CSingleLock lock(m_state->section);
+      m_state->started++;
+      unsigned int running = ++m_state->running[source];
+      m_state->maxRunning[source] = std::max(m_state->maxRunning[source], running);
+    }
+
+    m_state->release.Wait();
+
+    CSingleLock lock(m_state->section);
+    m_state->running[source]--;
+    m_state->finished++;
+    m_result.hashed = true;
+    m_result.fastHash = m_directory;
+    return true;
+  }
+
+private:
+  std::shared_ptr<SJobState> m_state;
+};
+
+class CTestPrefetcher : public CVideoScanPrefetcher
+{
+public:
+  explicit CTestPrefetcher(std::shared_ptr<SJobState> state) : m_state(std::move(state)) {}
+
+protected:
+  CVideoScanPrefetchJob *CreateJob(const std::string &directory) override
+  {
+    return new CBlockingPrefetchJob(directory, m_state);
+  }
+
+private:
+  std::shared_ptr<SJobState> m_state;
+};
+
+class TestVideoScanPrefetcher : public testing::Test
+{
+protected:
+  TestVideoScanPrefetcher() : m_state(std::make_shared<SJobState>()), m_prefetcher(m_state)
+  {
+    m_prefetcher.Start(false);
+  }
+
+  ~TestVideoScanPrefetcher() override
+  {
+    m_prefetcher.Cancel();
+    m_state->release.Set();
+    WaitFor([this]() { return m_state->finished == m_state->started; });
+  }
+
+  bool WaitFor(const std::function<bool()> &condition)
+  {
+    XbmcThreads::EndTime timeout(5000);
+    while (!timeout.IsTimePast())
+    {
+      {
+        CSingleLock lock(m_state->section);
+        if (condition())
+          return true;
+      }
+      XbmcThreads::ThreadSleep(10);
+    }
+    return false;
+  }
+
+  unsigned int Started()
+  {
+    CSingleLock lock(m_state->section);
+    return m_state->started;
+  }
+
+  std::shared_ptr<SJobState> m_state;
+  CTestPrefetcher m_prefetcher;
+};
+}
+
+TEST_F(TestVideoScanPrefetcher, LimitsJobsPerSource)
+{
+  std::vector<std::string> slow;
+  for (int i = 0; i < 5; i++)
+    slow.push_back("smb://slow/movies/" + std::to_string(i) + "/");
+  m_prefetcher.Queue(slow, false);
+  ASSERT_TRUE(WaitFor([this]() { return m_state->started == 2; }));
+
+  // the busy source keeps its backlog, another source gets a worker right away
+  m_prefetcher.Queue({ "nfs://fast/movies/" }, false);
+  ASSERT_TRUE(WaitFor([this]() { return m_state->running["fast"] == 1; }));
+  EXPECT_EQ(3u, Started());
+
+  m_state->release.Set();
+  for (const auto &directory : slow)
+  {
+    SScanPrefetch result;
+    ASSERT_TRUE(m_prefetcher.Take(directory, result)) << directory;
+    EXPECT_EQ(directory, result.fastHash);
+  }
+  SScanPrefetch result;
+  EXPECT_TRUE(m_prefetcher.Take("nfs://fast/movies/", result));
+
+  CSingleLock lock(m_state->section);
+  EXPECT_EQ(2u, m_state->maxRunning["slow"]);
+  EXPECT_EQ(1u, m_state->maxRunning["fast"]);
+}
+
+TEST_F(TestVideoScanPrefetcher, QueuedDirectoryIsLeftToScanner)
+{
+  m_prefetcher.Queue({ "smb://slow/1/", "smb://slow/2/", "smb://slow/3/" }, false);
+  ASSERT_TRUE(WaitFor([this]() { return m_state->started == 2; }));
+
+  SScanPrefetch result;
+  EXPECT_FALSE(m_prefetcher.Take("smb://slow/3/", result));
+  EXPECT_FALSE(m_prefetcher.Take("smb://slow/unknown/", result));
+}
+
+TEST_F(TestVideoScanPrefetcher, CancelWakesWaitingTake)
+{
+  m_prefetcher.Queue({ "smb://slow/1/", "smb://slow/2/", "smb://slow/3/" }, false);
+  ASSERT_TRUE(WaitFor([this]() { return m_state->started == 2; }));
+
+  bool taken = true;
+  std::thread waiter([this, &taken]() {
+    SScanPrefetch result;
+    taken = m_prefetcher.Take("smb://slow/1/", result);
+  });
+  XbmcThreads::ThreadSleep(50);
+  m_prefetcher.Cancel();
+  waiter.join();
+  EXPECT_FALSE(taken);
+
+  // cancelled jobs completing later leave nothing behind
+  m_state->release.Set();
+  ASSERT_TRUE(WaitFor([this]() { return m_state->finished == 2; }));
+  SScanPrefetch result;
+  EXPECT_FALSE(m_prefetcher.Take("smb://slow/2/", result));
+  EXPECT_FALSE(m_prefetcher.Take("smb://slow/3/", result));
+  EXPECT_EQ(2u, Started());
+}
@@ -19,6 +19,7 @@
  */
 
 #include "GUIWindowDebugInfo.h"
+#include "cores/AudioEngine/Utils/AETelemetry.h"
 #include "settings/AdvancedSettings.h"
 #include "addons/Skin.h"
 #include "utils/CPUInfo.h"
@@ -31,6 +32,8 @@
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/GUIFrameProfiler.h"
+#include "guilib/GUIRenderBatch.h"
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
@@ -120,6 +123,9 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
                                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(),
                                 strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+    info += "\n" + CAETelemetry::GetInstance().GetDebugString();
+    info += "\n" + CGUIFrameProfiler::GetInstance().GetFrameTimeSummary();
+    info += "\n" + CGUIRenderBatch::GetInstance().GetSummary();
   }
 
   // render the skin debug info